@@ -0,0 +1,82 @@
+//------------------------------------------ Includes ----------------------------------------------
+
+#include "bench.h"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+
+using namespace IslSdk;
+
+static std::atomic<uint64_t> allocations(0);
+
+//--------------------------------------------------------------------------------------------------
+void* operator new(std::size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+
+    void* ptr = std::malloc(size ? size : 1);
+    if (ptr == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+//--------------------------------------------------------------------------------------------------
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+//--------------------------------------------------------------------------------------------------
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+//--------------------------------------------------------------------------------------------------
+Bench::Reporter::Reporter(FILE* out, const std::string& filter, double minSeconds) : m_out(out), m_filter(filter), m_minSeconds(minSeconds)
+{
+}
+//--------------------------------------------------------------------------------------------------
+bool_t Bench::Reporter::enabled(const std::string& name) const
+{
+    return m_filter.empty() || name.find(m_filter) != std::string::npos;
+}
+//--------------------------------------------------------------------------------------------------
+void Bench::Reporter::report(const std::string& name, const Values& params, const Measurement& m, const Values& metrics)
+{
+    std::fprintf(m_out, "{\"bench\":\"%s\",\"params\":{", name.c_str());
+    for (uint_t i = 0; i < params.size(); i++)
+    {
+        std::fprintf(m_out, "%s\"%s\":%.10g", i ? "," : "", params[i].first.c_str(), params[i].second);
+    }
+
+    std::fprintf(m_out, "},\"iterations\":%llu,\"seconds\":%.6f,\"allocsPerIter\":%.3f", static_cast<unsigned long long>(m.iterations), m.seconds, m.iterations ? static_cast<double>(m.allocations) / m.iterations : 0.0);
+    for (const auto& metric : metrics)
+    {
+        std::fprintf(m_out, ",\"%s\":%.6g", metric.first.c_str(), metric.second);
+    }
+    std::fprintf(m_out, "}\n");
+    std::fflush(m_out);
+}
+//--------------------------------------------------------------------------------------------------
+Bench::Case::Case(const char* name, CaseFn func)
+{
+    cases().emplace_back(name, func);
+}
+//--------------------------------------------------------------------------------------------------
+std::vector<std::pair<const char*, Bench::CaseFn>>& Bench::cases()
+{
+    static std::vector<std::pair<const char*, CaseFn>> list;
+    return list;
+}
+//--------------------------------------------------------------------------------------------------
+uint64_t Bench::allocationCount()
+{
+    return allocations.load(std::memory_order_relaxed);
+}
+//--------------------------------------------------------------------------------------------------
+double Bench::seconds()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+//--------------------------------------------------------------------------------------------------
@@ -0,0 +1,93 @@
+#ifndef BENCH_H_
+#define BENCH_H_
+
+//------------------------------------------ Includes ----------------------------------------------
+
+#include "types/sdkTypes.h"
+#include <string>
+#include <vector>
+#include <utility>
+#include <cstdio>
+
+//--------------------------------------- Class Definition -----------------------------------------
+
+namespace IslSdk
+{
+    namespace Bench
+    {
+        typedef std::vector<std::pair<std::string, double>> Values;
+
+        struct Measurement
+        {
+            uint64_t iterations;
+            double seconds;
+            uint64_t allocations;               ///< Number of heap allocations during the timed iterations
+            Measurement() : iterations(0), seconds(0), allocations(0) {}
+        };
+
+        /// Writes one JSON object per line for each result so runs can be compared by a script.
+        class Reporter
+        {
+        public:
+            Reporter(FILE* out, const std::string& filter, double minSeconds);
+
+            bool_t enabled(const std::string& name) const;
+            double minSeconds() const { return m_minSeconds; }
+
+            /**
+            * @brief Writes a result.
+            * @param name The name of the benchmark, eg "image.render".
+            * @param params The settings the benchmark ran with.
+            * @param m The timing, iterations and allocations.
+            * @param metrics Derived values, eg frames per second.
+            */
+            void report(const std::string& name, const Values& params, const Measurement& m, const Values& metrics);
+
+        private:
+            FILE* m_out;
+            std::string m_filter;
+            double m_minSeconds;
+        };
+
+        typedef void (*CaseFn)(Reporter& reporter);
+
+        /// Registers a benchmark case from a static object in the file that implements it.
+        struct Case
+        {
+            Case(const char* name, CaseFn func);
+        };
+
+        std::vector<std::pair<const char*, CaseFn>>& cases();
+        uint64_t allocationCount();
+        double seconds();
+
+        /**
+        * @brief Calls \p func repeatedly until at least \p minSeconds have passed.
+        * The first call is not measured so lazily built tables and buffer growth are excluded.
+        * @param minSeconds Minimum time to run for.
+        * @param func The work, called with no arguments.
+        * @return The measurement.
+        */
+        template<typename F> Measurement measure(double minSeconds, const F& func)
+        {
+            Measurement m;
+            func();
+
+            uint64_t allocations = allocationCount();
+            double start = seconds();
+
+            do
+            {
+                func();
+                m.iterations++;
+                m.seconds = seconds() - start;
+            } while (m.seconds < minSeconds);
+
+            m.allocations = allocationCount() - allocations;
+            return m;
+        }
+    }
+}
+//--------------------------------------------------------------------------------------------------
+
+#endif
@@ -0,0 +1,81 @@
+//------------------------------------------ Includes ----------------------------------------------
+
+#include "bench.h"
+#include "comms/protocols/cobs.h"
+#include "platform/mem.h"
+#include <vector>
+
+using namespace IslSdk;
+
+static const uint_t frameSizes[] = { 64, 1024, 8192 };
+
+//--------------------------------------------------------------------------------------------------
+/// Ping data at 16 bits per point, where the high byte is often zero.
+static std::vector<uint8_t> makeFrame(uint_t size)
+{
+    std::vector<uint8_t> frame(size);
+
+    for (uint_t i = 0; i < size; i++)
+    {
+        frame[i] = (i & 1) ? static_cast<uint8_t>((i * 7) % 3 ? 0 : i) : static_cast<uint8_t>(i * 13 + 1);
+    }
+    return frame;
+}
+//--------------------------------------------------------------------------------------------------
+static void cobsEncode(Bench::Reporter& reporter)
+{
+    for (uint_t size : frameSizes)
+    {
+        Cobs cobs(size + 16);
+        std::vector<uint8_t> frame = makeFrame(size);
+        std::vector<uint8_t> buf(size * 2 + 16);
+
+        Bench::Measurement m = Bench::measure(reporter.minSeconds(), [&]()
+        {
+            cobs.encode(&frame[0], size, &buf[0], buf.size());
+        });
+
+        reporter.report("cobs.encode", { { "bytes", size } }, m, { { "mbPerSec", static_cast<double>(m.iterations) * size / m.seconds / 1e6 } });
+    }
+}
+//--------------------------------------------------------------------------------------------------
+static void cobsDecode(Bench::Reporter& reporter)
+{
+    for (bool_t inPlace : { false, true })
+    {
+        for (uint_t size : frameSizes)
+        {
+            Cobs cobs(size + 16);
+            std::vector<uint8_t> frame = makeFrame(size);
+            std::vector<uint8_t> encoded(size * 2 + 16);
+            uint_t encodedSize = cobs.encode(&frame[0], size, &encoded[0], encoded.size());
+            std::vector<uint8_t> rx(encodedSize);
+
+            Bench::Measurement m = Bench::measure(reporter.minSeconds(), [&]()
+            {
+                // As a port receives it, the bytes arrive in a buffer the decoder may overwrite
+                Mem::memcpy(&rx[0], &encoded[0], encodedSize);
+                uint_t bytesToProcess = encodedSize;
+
+                while (bytesToProcess)
+                {
+                    const uint8_t* data;
+                    if (inPlace)
+                    {
+                        cobs.decodeInPlace(&rx[encodedSize - bytesToProcess], &bytesToProcess, &data);
+                    }
+                    else
+                    {
+                        cobs.decode(&rx[encodedSize - bytesToProcess], &bytesToProcess);
+                    }
+                }
+            });
+
+            reporter.report("cobs.decode", { { "bytes", size }, { "inPlace", inPlace } }, m, { { "mbPerSec", static_cast<double>(m.iterations) * size / m.seconds / 1e6 } });
+        }
+    }
+}
+//--------------------------------------------------------------------------------------------------
+static Bench::Case encodeCase("cobs.encode", cobsEncode);
+static Bench::Case decodeCase("cobs.decode", cobsDecode);
+//--------------------------------------------------------------------------------------------------
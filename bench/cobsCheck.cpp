@@ -0,0 +1,292 @@
+//------------------------------------------ Includes ----------------------------------------------
+
+#include "comms/protocols/cobs.h"
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace IslSdk;
+
+/// The byte at a time COBS codec the vectorised one replaced, the reference the checks compare against.
+class ScalarCobs : public Codec
+{
+public:
+    ScalarCobs(uint_t mtu) : Codec(mtu, Type::Cobs), m_blockSize(0), m_blockCount(0), m_size(0), m_waitForSof(true) {}
+
+    uint_t encode(const uint8_t* data, uint_t size, uint8_t* buf, uint_t bufSize) override
+    {
+        uint_t maxSize = size + 3 + (size / 254);
+
+        if (maxSize > bufSize)
+        {
+            return 0;
+        }
+
+        uint8_t* frame = buf;
+        uint8_t blockLength = 1;
+        *frame++ = 0;
+        uint8_t* idx = frame;
+        frame++;
+
+        while (size)
+        {
+            if (*data == 0)
+            {
+                *idx = blockLength;
+                blockLength = 1;
+                idx = frame;
+                frame++;
+            }
+            else
+            {
+                *frame++ = *data;
+                blockLength++;
+                if (blockLength == 0xff)
+                {
+                    *idx = blockLength;
+                    blockLength = 1;
+                    idx = frame;
+                    frame++;
+                }
+            }
+            data++;
+            size--;
+        }
+
+        *idx = blockLength;
+        *frame++ = 0;
+
+        return static_cast<uint_t>(frame - buf);
+    }
+
+    uint_t decode(const uint8_t* data, uint_t* size) override
+    {
+        while (*size)
+        {
+            (*size)--;
+            if (*data == 0)
+            {
+                m_waitForSof = false;
+                if (m_size && m_blockCount == 0)
+                {
+                    uint_t frameLength = m_size;
+                    m_size = 0;
+                    m_blockCount = 0;
+                    m_blockSize = 0xff;
+                    return frameLength;
+                }
+
+                m_size = 0;
+                m_blockCount = 0;
+                m_blockSize = 0xff;
+            }
+            else if (!m_waitForSof)
+            {
+                if (m_blockCount)
+                {
+                    m_frameBuf[m_size++] = *data;
+                }
+                else
+                {
+                    if (m_blockSize != 0xff)
+                    {
+                        m_frameBuf[m_size++] = 0;
+                    }
+                    m_blockSize = m_blockCount = *data;
+
+                    if ((m_size + m_blockSize) > m_frameBuf.size())
+                    {
+                        m_size = 0;
+                        m_waitForSof = true;
+                    }
+                }
+                m_blockCount--;
+            }
+            data++;
+        }
+        return 0;
+    }
+
+private:
+    uint_t m_blockSize;
+    uint_t m_blockCount;
+    uint_t m_size;
+    bool_t m_waitForSof;
+};
+
+typedef std::vector<std::vector<uint8_t>> Frames;
+
+static std::mt19937 rng(1);
+static uint_t failures = 0;
+
+//--------------------------------------------------------------------------------------------------
+static void check(bool_t ok, const char* what, uint_t test)
+{
+    if (!ok)
+    {
+        if (failures < 20)
+        {
+            std::printf("FAIL %s, test %u\n", what, static_cast<unsigned>(test));
+        }
+        failures++;
+    }
+}
+//--------------------------------------------------------------------------------------------------
+/// A payload of \p size bytes where each byte is zero with probability \p zeroPercent, with zeros forced at \p zeroAt.
+static std::vector<uint8_t> makePayload(uint_t size, uint_t zeroPercent, const std::vector<uint_t>& zeroAt)
+{
+    std::vector<uint8_t> payload(size);
+
+    for (uint_t i = 0; i < size; i++)
+    {
+        payload[i] = rng() % 100 < zeroPercent ? 0 : static_cast<uint8_t>(1 + rng() % 255);
+    }
+
+    for (uint_t i : zeroAt)
+    {
+        if (i < size)
+        {
+            payload[i] = 0;
+        }
+    }
+    return payload;
+}
+//--------------------------------------------------------------------------------------------------
+/// Decodes \p stream delivered in chunks of random size, as a port would receive it.
+static Frames decodeStream(Codec& codec, const std::vector<uint8_t>& stream, bool_t inPlace, uint_t maxChunk)
+{
+    Frames frames;
+    std::vector<uint8_t> rx;
+    uint_t pos = 0;
+
+    while (pos < stream.size())
+    {
+        uint_t chunk = 1 + rng() % maxChunk;
+        chunk = chunk < stream.size() - pos ? chunk : static_cast<uint_t>(stream.size() - pos);
+        rx.assign(stream.begin() + pos, stream.begin() + pos + chunk);
+        pos += chunk;
+
+        uint_t size = chunk;
+        while (size)
+        {
+            const uint8_t* frame = codec.m_frameBuf.data();
+            uint_t length = inPlace ? codec.decodeInPlace(&rx[chunk - size], &size, &frame) : codec.decode(&rx[chunk - size], &size);
+
+            if (length)
+            {
+                frames.emplace_back(frame, frame + length);
+            }
+        }
+    }
+    return frames;
+}
+//--------------------------------------------------------------------------------------------------
+/// Checks encoding and decoding against ScalarCobs, and that the payloads come back if \p roundTrip is set.
+static void checkStream(const Frames& payloads, uint_t mtu, uint_t test, bool_t damage, bool_t roundTrip)
+{
+    Cobs cobs(mtu);
+    ScalarCobs scalar(mtu);
+    std::vector<uint8_t> stream;
+    Frames expected;
+
+    for (const std::vector<uint8_t>& payload : payloads)
+    {
+        std::vector<uint8_t> buf(payload.size() * 2 + 16);
+        std::vector<uint8_t> ref(buf.size());
+        uint_t size = cobs.encode(payload.data(), static_cast<uint_t>(payload.size()), buf.data(), static_cast<uint_t>(buf.size()));
+        uint_t refSize = scalar.encode(payload.data(), static_cast<uint_t>(payload.size()), ref.data(), static_cast<uint_t>(ref.size()));
+
+        check(size == refSize && std::equal(buf.begin(), buf.begin() + size, ref.begin()), "encode matches scalar", test);
+        buf.resize(size);
+
+        if (damage && size > 2 && rng() % 3 == 0)
+        {
+            switch (rng() % 3)
+            {
+            case 0:
+                buf.resize(1 + rng() % (size - 1));                 // Truncated
+                break;
+            case 1:
+                buf[1 + rng() % (size - 2)] = static_cast<uint8_t>(rng());  // Corrupt byte, maybe a zero
+                break;
+            default:
+                buf.erase(buf.begin() + 1 + rng() % (size - 2));    // Lost byte
+                break;
+            }
+        }
+        else if (!payload.empty())
+        {
+            expected.push_back(payload);
+        }
+        stream.insert(stream.end(), buf.begin(), buf.end());
+    }
+
+    uint_t maxChunk = 1 + rng() % 3000;
+    ScalarCobs scalarRx(mtu);
+    Frames ref = decodeStream(scalarRx, stream, false, maxChunk);
+
+    for (bool_t inPlace : { false, true })
+    {
+        Cobs rx(mtu);
+        Frames frames = decodeStream(rx, stream, inPlace, maxChunk);
+        check(frames == ref, inPlace ? "decodeInPlace matches scalar" : "decode matches scalar", test);
+
+        if (roundTrip)
+        {
+            check(frames == expected, inPlace ? "decodeInPlace round trip" : "decode round trip", test);
+        }
+    }
+}
+//--------------------------------------------------------------------------------------------------
+int main()
+{
+    uint_t test = 0;
+
+    // Sizes either side of the 254 byte block limit and the 16 byte chunks
+    std::vector<uint_t> sizes = { 0, 1, 2, 15, 16, 17, 31, 32, 33, 253, 254, 255, 256, 257, 507, 508, 509, 510, 511, 762, 1024, 1050, 4096 };
+    for (uint_t i = 0; i < 40; i++)
+    {
+        sizes.push_back(rng() % 9000);
+    }
+
+    for (uint_t size : sizes)
+    {
+        for (uint_t zeroPercent : { 0, 1, 10, 50, 100 })
+        {
+            for (uint_t zeroAt : { 0, 1, 252, 253, 254, 255, 256, 508, 509 })
+            {
+                Frames payloads;
+                uint_t count = 1 + rng() % 4;
+
+                for (uint_t i = 0; i < count; i++)
+                {
+                    payloads.push_back(makePayload(size, zeroPercent, { zeroAt, static_cast<uint_t>(rng() % (size + 1)) }));
+                }
+
+                // An mtu that fits, and ones at and below the payload size where frames may be dropped
+                checkStream(payloads, size + 16, test++, false, true);
+                checkStream(payloads, size ? size : 1, test++, false, false);
+                checkStream(payloads, size / 2 + 1, test++, false, false);
+            }
+        }
+    }
+
+    // Truncated, corrupted and short frames between good ones
+    for (uint_t i = 0; i < 3000; i++)
+    {
+        Frames payloads;
+        uint_t count = 2 + rng() % 6;
+        uint_t mtu = 1 + rng() % 2000;
+
+        for (uint_t k = 0; k < count; k++)
+        {
+            payloads.push_back(makePayload(rng() % 2200, rng() % 30, {}));
+        }
+        checkStream(payloads, mtu, test++, true, false);
+    }
+
+    std::printf("%u tests, %u failures\n", static_cast<unsigned>(test), static_cast<unsigned>(failures));
+    return failures ? 1 : 0;
+}
+//--------------------------------------------------------------------------------------------------
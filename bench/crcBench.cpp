@@ -0,0 +1,68 @@
+//------------------------------------------ Includes ----------------------------------------------
+
+#include "bench.h"
+#include "utils/crc.h"
+#include "maths/maths.h"
+#include <vector>
+
+using namespace IslSdk;
+
+static const uint_t frameSizes[] = { 16, 64, 256, 1024, 4096, 16384, 65536 };
+
+//--------------------------------------------------------------------------------------------------
+/// The nibble table crc32 the SDK used before, kept as the baseline.
+static uint32_t crc32Nibble(uint32_t seed, const void* data, uint_t length)
+{
+    static const uint32_t lut[] = {
+        0x00000000,0x1DB71064,0x3B6E20C8,0x26D930AC,0x76DC4190,0x6B6B51F4,0x4DB26158,0x5005713C,
+        0xEDB88320,0xF00F9344,0xD6D6A3E8,0xCB61B38C,0x9B64C2B0,0x86D3D2D4,0xA00AE278,0xBDBDF21C };
+    uint32_t crc = seed;
+    const uint8_t* dataPtr = static_cast<const uint8_t*>(data);
+
+    for (uint_t i = 0; i < length; i++)
+    {
+        crc = lut[(crc ^ dataPtr[i]) & 0x0f] ^ (crc >> 4);
+        crc = lut[(crc ^ (dataPtr[i] >> 4)) & 0x0f] ^ (crc >> 4);
+    }
+
+    return crc;
+}
+//--------------------------------------------------------------------------------------------------
+template<typename F> static void throughput(Bench::Reporter& reporter, const char* name, const F& crc)
+{
+    std::vector<uint8_t> buf(frameSizes[sizeof(frameSizes) / sizeof(frameSizes[0]) - 1]);
+
+    for (uint_t i = 0; i < buf.size(); i++)
+    {
+        buf[i] = static_cast<uint8_t>(i * 2654435761u >> 24);
+    }
+
+    for (uint_t size : frameSizes)
+    {
+        uint_t framesPerIter = Math::max<uint_t>(1, 65536 / size);
+        volatile uint32_t sink = 0;
+
+        Bench::Measurement m = Bench::measure(reporter.minSeconds(), [&]()
+        {
+            uint32_t result = 0;
+            for (uint_t i = 0; i < framesPerIter; i++)
+            {
+                result ^= crc(static_cast<uint32_t>(result), &buf[0], size);
+            }
+            sink = result;
+        });
+
+        double bytes = static_cast<double>(m.iterations) * framesPerIter * size;
+        reporter.report(name, { { "bytes", size } }, m, { { "gbPerSec", bytes / m.seconds / 1e9 } });
+    }
+}
+//--------------------------------------------------------------------------------------------------
+static void crcThroughput(Bench::Reporter& reporter)
+{
+    throughput(reporter, "crc.crc32", [](uint32_t seed, const uint8_t* data, uint_t size) { return crc32(seed, data, size); });
+    throughput(reporter, "crc.crc16", [](uint32_t seed, const uint8_t* data, uint_t size) { return static_cast<uint32_t>(crc16(static_cast<uint16_t>(seed), data, size)); });
+    throughput(reporter, "crc.crc32Nibble", [](uint32_t seed, const uint8_t* data, uint_t size) { return crc32Nibble(seed, data, size); });
+}
+//--------------------------------------------------------------------------------------------------
+static Bench::Case crcCase("crc", crcThroughput);
+//--------------------------------------------------------------------------------------------------
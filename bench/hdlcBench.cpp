@@ -0,0 +1,212 @@
+//------------------------------------------ Includes ----------------------------------------------
+
+#include "bench.h"
+#include "comms/islHdlc.h"
+#include <random>
+
+using namespace IslSdk;
+
+static const uint_t messageCount = 2000;
+static const uint8_t deviceWindowSize = 15;
+
+/// Captures the frames IslHdlc writes instead of sending them.
+class LoopbackPort : public SysPort
+{
+public:
+    std::vector<std::vector<uint8_t>> frames;
+
+    LoopbackPort() : SysPort("loopback", ClassType::Net, Type::Net, 0) {}
+    void open() override {}
+    bool_t write(const uint8_t* data, uint_t size, const ConnectionMeta&) override
+    {
+        frames.emplace_back(data, data + size);
+        return true;
+    }
+};
+
+/// The SDK end of the link.
+class Receiver : public IslHdlc
+{
+public:
+    uint_t delivered;
+
+    Receiver(const std::shared_ptr<SysPort>& port, bool_t selectiveReject) : delivered(0)
+    {
+        m_connection = std::make_unique<Connection>(port, ConnectionMeta(0, 0));
+        setSelectiveReject(selectiveReject);
+
+        uint8_t fullDuplex = 0;
+        IslHdlcPacket packet;
+        packet.header.type = IslHdlcPacket::FrameType::U;
+        packet.header.uCode = IslHdlcPacket::UframeCode::Connect;
+        packet.header.pf = true;
+        packet.header.cr = false;
+        packet.header.ack = 0;
+        packet.payload = &fullDuplex;
+        packet.size = 1;
+        processPacket(packet);
+    }
+
+    using IslHdlc::process;
+
+protected:
+    void hdlcConnectionEvent(bool_t) override {}
+    bool_t timeoutEvent() override { return true; }
+    void newPacketEvent(const uint8_t*, uint_t) override { delivered++; }
+};
+
+/// A device streaming messages to the SDK over a link that loses frames in both directions.
+class LossyLink
+{
+public:
+    uint_t framesSent;
+
+    LossyLink(double lossRate, bool_t selectiveReject) :
+        framesSent(0),
+        m_port(std::make_shared<LoopbackPort>()),
+        m_receiver(m_port, selectiveReject),
+        m_random(1234),
+        m_loss(lossRate),
+        m_base(0),
+        m_next(0),
+        m_highest(0),
+        m_produced(0)
+    {
+    }
+
+    bool_t transfer()
+    {
+        for (uint_t step = 0; step < messageCount * 100; step++)
+        {
+            uint_t sent = framesSent;
+
+            for (uint8_t seq : m_resend)
+            {
+                transmit(seq, false);
+            }
+            m_resend.clear();
+
+            while (static_cast<uint8_t>(m_next - m_base) < deviceWindowSize && (m_next != m_highest || m_produced < messageCount))
+            {
+                if (m_next == m_highest)
+                {
+                    m_highest++;
+                    m_produced++;
+                }
+                transmit(m_next++, false);
+            }
+
+            m_receiver.process();
+            bool_t acked = receiveAcks();
+
+            if (m_receiver.delivered == messageCount)
+            {
+                return true;
+            }
+
+            // Nothing moved so the device's timeout resends the oldest unacknowledged frame with the poll flag
+            if (sent == framesSent && !acked)
+            {
+                transmit(m_base, true);
+            }
+        }
+        return false;
+    }
+
+private:
+    std::shared_ptr<LoopbackPort> m_port;
+    Receiver m_receiver;
+    std::mt19937 m_random;
+    std::bernoulli_distribution m_loss;
+    uint8_t m_base;
+    uint8_t m_next;
+    uint8_t m_highest;
+    uint_t m_produced;
+    std::vector<uint8_t> m_resend;
+    uint8_t m_payload[256] = {};
+
+    void transmit(uint8_t seq, bool_t pf)
+    {
+        framesSent++;
+
+        if (!m_loss(m_random))
+        {
+            IslHdlcPacket packet;
+            packet.header.type = IslHdlcPacket::FrameType::I;
+            packet.header.pf = pf;
+            packet.header.cr = false;
+            packet.header.ack = 0;
+            packet.header.seq = seq;
+            packet.payload = m_payload;
+            packet.size = sizeof(m_payload);
+            m_receiver.processPacket(packet);
+        }
+    }
+
+    bool_t receiveAcks()
+    {
+        bool_t acked = false;
+
+        for (const std::vector<uint8_t>& frame : m_port->frames)
+        {
+            if (m_loss(m_random) || static_cast<IslHdlcPacket::FrameType>(frame[0] & (0x03 << 3)) != IslHdlcPacket::FrameType::S)
+            {
+                continue;
+            }
+
+            uint8_t ack = frame[1];
+            IslHdlcPacket::SframeCode code = static_cast<IslHdlcPacket::SframeCode>(frame[2]);
+
+            if (static_cast<uint8_t>(ack - m_base) <= static_cast<uint8_t>(m_highest - m_base))
+            {
+                acked = acked || ack != m_base;
+                m_base = ack;
+
+                if (static_cast<uint8_t>(m_next - m_base) > static_cast<uint8_t>(m_highest - m_base))
+                {
+                    m_next = m_base;
+                }
+
+                if (code == IslHdlcPacket::SframeCode::Rej)
+                {
+                    m_next = ack;               // Go back N
+                    acked = true;
+                }
+                else if (code == IslHdlcPacket::SframeCode::Srej)
+                {
+                    m_resend.push_back(ack);
+                    acked = true;
+                }
+            }
+        }
+        m_port->frames.clear();
+
+        return acked;
+    }
+};
+
+//--------------------------------------------------------------------------------------------------
+static void lossyReceive(Bench::Reporter& reporter)
+{
+    for (bool_t selectiveReject : { false, true })
+    {
+        for (double lossRate : { 0.0, 0.01, 0.05, 0.1, 0.2 })
+        {
+            uint_t framesSent = 0;
+            bool_t complete = true;
+
+            Bench::Measurement m = Bench::measure(reporter.minSeconds(), [&]()
+            {
+                LossyLink link(lossRate, selectiveReject);
+                complete = link.transfer() && complete;
+                framesSent = link.framesSent;
+            });
+
+            reporter.report("hdlc.lossyReceive", { { "srej", selectiveReject }, { "lossRate", lossRate }, { "messages", messageCount } }, m,
+                { { "goodput", complete ? static_cast<double>(messageCount) / framesSent : 0.0 }, { "framesPerMessage", static_cast<double>(framesSent) / messageCount }, { "complete", complete } });
+        }
+    }
+}
+//--------------------------------------------------------------------------------------------------
+static Bench::Case lossyReceiveCase("hdlc.lossyReceive", lossyReceive);
+//--------------------------------------------------------------------------------------------------
@@ -0,0 +1,227 @@
+//------------------------------------------ Includes ----------------------------------------------
+
+#include "legacySonarImage.h"
+#include "maths/maths.h"
+#include <algorithm>
+
+using namespace IslSdk;
+
+//--------------------------------------------------------------------------------------------------
+LegacySonarImage::LegacySonarImage(int32_t width, int32_t height) : m_buf(width * height), m_width(width), m_height(height), m_minRangeMm(0), m_maxRangeMm(0), m_radius(0)
+{
+}
+//--------------------------------------------------------------------------------------------------
+void LegacySonarImage::setSectorArea(uint_t minRangeMm, uint_t maxRangeMm, uint_t sectorStart, uint_t sectorSize)
+{
+    m_minRangeMm = minRangeMm;
+    m_maxRangeMm = maxRangeMm;
+    m_sector.start = sectorStart;
+    m_sector.size = sectorSize ? sectorSize : Sonar::maxAngle;
+
+    float_t precision = 100000.0f;
+    Box box = minBoundingBox(m_sector, precision);
+    m_radius = Math::min(m_width / (static_cast<float_t>(box.width) / precision), m_height / (static_cast<float_t>(box.height) / precision));
+}
+//--------------------------------------------------------------------------------------------------
+void LegacySonarImage::render(const SonarDataStore& data, const Palette& palette)
+{
+    const Sonar::Sector& sector = m_sector;
+    std::fill(m_buf.begin(), m_buf.end(), palette.data[0x10000].val);
+
+    Box box = minBoundingBox(sector, m_radius);
+    float_t radius2 = m_radius * m_radius;
+
+    for (int32_t y = box.y; y < box.height + box.y; y++)
+    {
+        uint32_t* img = &m_buf[((box.height - 1) - (y - box.y)) * m_width];
+
+        for (int32_t x = box.x; x < box.width + box.x; x++)
+        {
+            float_t rad2 = static_cast<float_t>(x * x + y * y);
+
+            if (rad2 < radius2)
+            {
+                float_t angle = Math::atan2(static_cast<float_t>(x), static_cast<float_t>(y)) * static_cast<float_t>(Sonar::maxAngle / Math::pi2);
+                if (angle < 0.0f)
+                {
+                    angle += Sonar::maxAngle;
+                }
+
+                int32_t dif = static_cast<int32_t>(angle - sector.start);
+                if (dif < 0)
+                {
+                    dif += Sonar::maxAngle;
+                }
+
+                if (static_cast<uint_t>(dif) <= sector.size)
+                {
+                    RenderData renderData = getData(data, angle, m_radius);
+                    uint32_t pix = 0x10000;
+                    if (renderData.row1)
+                    {
+                        pix = calculatePixel(renderData, Math::sqrt(rad2));
+                    }
+                    *img = palette.data[pix].val;
+                }
+            }
+            img++;
+        }
+    }
+}
+//--------------------------------------------------------------------------------------------------
+uint16_t LegacySonarImage::calculatePixel(const RenderData& renderData, float_t range) const
+{
+    float_t idx = (range * renderData.scale1) + renderData.offset1;
+    int_t intIdx = static_cast<int_t>(idx);
+    float_t pix = 0.0f;
+
+    if (intIdx >= 0 && intIdx < static_cast<int_t>(renderData.row1->data.size()))
+    {
+        float_t w = idx - intIdx;
+
+        pix = renderData.row1->data[intIdx] * (1.0f - w);
+        if (intIdx < static_cast<int_t>(renderData.row1->data.size() - 1))
+        {
+            pix += renderData.row1->data[intIdx + 1] * w;
+        }
+    }
+
+    if (renderData.row2)
+    {
+        idx = (range * renderData.scale2) + renderData.offset2;
+        intIdx = static_cast<int_t>(idx);
+
+        if (intIdx >= 0 && intIdx < static_cast<int_t>(renderData.row2->data.size()))
+        {
+            float_t w = idx - intIdx;
+
+            float_t pix2 = renderData.row2->data[intIdx] * (1.0f - w);
+            if (intIdx < static_cast<int_t>(renderData.row2->data.size() - 1))
+            {
+                pix2 += renderData.row2->data[intIdx + 1] * w;
+            }
+
+            pix = pix * (1.0f - renderData.w) + pix2 * renderData.w;
+        }
+    }
+    return static_cast<uint16_t>(pix);
+}
+//--------------------------------------------------------------------------------------------------
+LegacySonarImage::RenderData LegacySonarImage::getData(const SonarDataStore& data, float_t angle, float_t width) const
+{
+    RenderData ret;
+
+    ret.row1 = data.pingData[static_cast<uint_t>(angle)];
+
+    if (ret.row1)
+    {
+        float_t imgRange = static_cast<float_t>(static_cast<int_t>(m_maxRangeMm - m_minRangeMm));
+
+        float_t dif = angle - static_cast<float_t>(ret.row1->angle);
+        if (dif > static_cast<float_t>(Sonar::maxAngle / 2))
+        {
+            dif -= Sonar::maxAngle;
+        }
+        else if (dif < -static_cast<float_t>(Sonar::maxAngle / 2))
+        {
+            dif += Sonar::maxAngle;
+        }
+
+        if (dif >= 0.0f)
+        {
+            ret.row2 = data.pingData[ret.row1->endIdx];
+        }
+        else if (data.pingData[ret.row1->startIdx])
+        {
+            ret.row2 = ret.row1;
+            ret.row1 = data.pingData[ret.row1->startIdx];
+        }
+
+        if (ret.row2)
+        {
+            float_t range = static_cast<float_t>(static_cast<int_t>(ret.row2->maxRangeMm - ret.row2->minRangeMm));
+            float_t minDif = static_cast<float_t>(static_cast<int_t>(m_minRangeMm - ret.row2->minRangeMm));
+            ret.scale2 = (ret.row2->data.size() / width) * (imgRange / range);
+            ret.offset2 = (ret.row2->data.size() / range) * minDif;
+
+            float_t dif1 = Math::abs(angle - static_cast<float_t>(ret.row1->angle));
+            if (dif1 > (Sonar::maxAngle / 2))
+            {
+                dif1 = Sonar::maxAngle - dif1;
+            }
+
+            float_t dif2 = Math::abs(ret.row1->angle - static_cast<float_t>(ret.row2->angle));
+            if (dif2 > (Sonar::maxAngle / 2))
+            {
+                dif2 = Sonar::maxAngle - dif2;
+            }
+            ret.w = dif1 / dif2;
+        }
+
+        float_t range = static_cast<float_t>(static_cast<int_t>(ret.row1->maxRangeMm - ret.row1->minRangeMm));
+        float_t minDif = static_cast<float_t>(static_cast<int_t>(m_minRangeMm - ret.row1->minRangeMm));
+        ret.scale1 = (ret.row1->data.size() / width) * (imgRange / range);
+        ret.offset1 = (ret.row1->data.size() / range) * minDif;
+    }
+    return ret;
+}
+//--------------------------------------------------------------------------------------------------
+LegacySonarImage::Box LegacySonarImage::minBoundingBox(const Sonar::Sector& sector, float_t radius) const
+{
+    const float_t a90 = Sonar::maxAngle / 4;
+    const float_t a180 = Sonar::maxAngle / 2;
+    const float_t a270 = a180 + a90;
+    const float_t a360 = Sonar::maxAngle;
+
+    float_t angleStart = static_cast<float_t>(sector.start);
+    float_t angleEnd = static_cast<float_t>(sector.start + sector.size);
+    float_t startX = Math::sin(angleStart * static_cast<float_t>(Math::pi2 / Sonar::maxAngle)) * radius;
+    float_t startY = Math::cos(angleStart * static_cast<float_t>(Math::pi2 / Sonar::maxAngle)) * radius;
+    float_t endX = Math::sin(angleEnd * static_cast<float_t>(Math::pi2 / Sonar::maxAngle)) * radius;
+    float_t endY = Math::cos(angleEnd * static_cast<float_t>(Math::pi2 / Sonar::maxAngle)) * radius;
+    float_t xMax = Math::max(startX, endX);
+    float_t xMin = Math::min(startX, endX);
+    float_t yMax = Math::max(startY, endY);
+    float_t yMin = Math::min(startY, endY);
+
+    if ((angleStart <= a90 && angleEnd >= a90) || (angleStart > a90 && angleEnd >= (a360 + a90)))
+    {
+        xMax = radius;
+    }
+    else if (startX <= 0 && endX <= 0)
+    {
+        xMax = 0;
+    }
+
+    if ((angleStart <= a180 && angleEnd >= a180) || (angleStart > a180 && angleEnd >= (a360 + a180)))
+    {
+        yMin = -radius;
+    }
+    else if (startY >= 0 && endY >= 0)
+    {
+        yMin = 0;
+    }
+
+    if ((angleStart <= a270 && angleEnd >= a270) || (angleStart > a270 && angleEnd >= (a360 + a270)))
+    {
+        xMin = -radius;
+    }
+    else if (startX >= 0 && endX >= 0)
+    {
+        xMin = 0;
+    }
+
+    if (angleEnd >= a360)
+    {
+        yMax = radius;
+    }
+    else if (startY <= 0 && endY <= 0)
+    {
+        yMax = 0;
+    }
+
+    Box box(static_cast<int32_t>(xMin), static_cast<int32_t>(yMin), static_cast<int32_t>(xMax - xMin), static_cast<int32_t>(yMax - yMin));
+
+    return box;
+}
+//--------------------------------------------------------------------------------------------------
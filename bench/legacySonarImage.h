@@ -0,0 +1,62 @@
+#ifndef LEGACYSONARIMAGE_H_
+#define LEGACYSONARIMAGE_H_
+
+//------------------------------------------ Includes ----------------------------------------------
+
+#include "types/sdkTypes.h"
+#include "helpers/sonarDataStore.h"
+#include "helpers/palette.h"
+#include <vector>
+
+//--------------------------------------- Class Definition -----------------------------------------
+
+namespace IslSdk
+{
+    /// The SonarImage::render() full redraw as it was before the per pixel polar lookup table, working out the angle
+    /// and range of every pixel with atan2 and sqrt. Only kept so the bench can measure the lookup table against it.
+    class LegacySonarImage
+    {
+    public:
+        LegacySonarImage(int32_t width, int32_t height);
+        void setSectorArea(uint_t minRangeMm, uint_t maxRangeMm, uint_t sectorStart, uint_t sectorSize);
+        void render(const SonarDataStore& data, const Palette& palette);
+        const std::vector<uint32_t>& buf = m_buf;
+
+    private:
+        struct RenderData
+        {
+            const SonarDataStore::PingData* row1;
+            const SonarDataStore::PingData* row2;
+            float_t scale1;
+            float_t offset1;
+            float_t scale2;
+            float_t offset2;
+            float_t w;
+            RenderData() : row1(nullptr), row2(nullptr), scale1(0), offset1(0), scale2(0), offset2(0), w(0) { }
+        };
+
+        struct Box
+        {
+            int32_t x;
+            int32_t y;
+            int32_t width;
+            int32_t height;
+            Box(int32_t x, int32_t y, int32_t width, int32_t height) : x(x), y(y), width(width), height(height) { }
+        };
+
+        uint16_t calculatePixel(const RenderData& renderData, float_t range) const;
+        RenderData getData(const SonarDataStore& data, float_t angle, float_t width) const;
+        Box minBoundingBox(const Sonar::Sector& sector, float_t radius) const;
+
+        std::vector<uint32_t> m_buf;
+        int32_t m_width;
+        int32_t m_height;
+        uint_t m_minRangeMm;
+        uint_t m_maxRangeMm;
+        Sonar::Sector m_sector;
+        float_t m_radius;
+    };
+}
+
+//--------------------------------------------------------------------------------------------------
+#endif
@@ -0,0 +1,116 @@
+//------------------------------------------ Includes ----------------------------------------------
+
+#include "bench.h"
+#include "pingGenerator.h"
+#include "files/logFile.h"
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace IslSdk;
+
+static const uint_t dataPoints[] = { 1000, 4000 };
+
+/// The kinds of ping data compared. Full gain 16 bit speckle barely compresses, so a low gain setting is included too.
+struct DataSet
+{
+    bool_t data8Bit;
+    real_t noiseLevel;
+    uint_t effectiveBits;
+};
+
+static const DataSet dataSets[] =
+{
+    { false, 1.0, 16 },                         // Full gain speckle noise
+    { false, 0.25, 12 },                        // A low amplitude water column with a quantised noise floor
+    { true, 1.0, 16 },
+};
+
+//--------------------------------------------------------------------------------------------------
+/// A sweep of pings as LogWriter records them, 16 bits per point whether the sonar sent 8 or 16 bit data.
+static std::vector<std::vector<uint8_t>> makeRecords(uint_t points, const DataSet& dataSet)
+{
+    PingGenerator::Config config;
+    config.dataPoints = points;
+    config.data8Bit = dataSet.data8Bit;
+    config.noiseLevel = dataSet.noiseLevel;
+    config.effectiveBits = dataSet.effectiveBits;
+    config.stepSize = 64;
+
+    PingGenerator generator(config);
+    std::vector<Sonar::Ping> pings = generator.sweep();
+    std::vector<std::vector<uint8_t>> records;
+
+    for (const Sonar::Ping& ping : pings)
+    {
+        const uint8_t* data = reinterpret_cast<const uint8_t*>(ping.data.data());
+        records.emplace_back(data, data + ping.data.size() * sizeof(uint16_t));
+    }
+    return records;
+}
+//--------------------------------------------------------------------------------------------------
+static void logCompression(Bench::Reporter& reporter)
+{
+    const std::pair<const char*, LogFile::RecordHeader::Codec> codecs[] =
+    {
+        { "lz4", LogFile::RecordHeader::Codec::Lz4 },
+        { "lz4Shuffle16", LogFile::RecordHeader::Codec::Lz4Shuffle16 },
+    };
+
+    for (const auto& codec : codecs)
+    {
+        for (const DataSet& dataSet : dataSets)
+        {
+            for (uint_t points : dataPoints)
+            {
+                std::vector<std::vector<uint8_t>> records = makeRecords(points, dataSet);
+                std::vector<std::vector<uint8_t>> compressed(records.size());
+                std::vector<LogFile::RecordHeader::Codec> used(records.size());
+                std::vector<uint8_t> out;
+                double rawBytes = 0;
+                double compressedBytes = 0;
+                double decodedBytes = 0;                // Records that didn't get smaller are stored as they are, so aren't decoded
+
+                for (uint_t i = 0; i < records.size(); i++)
+                {
+                    used[i] = LogFile::compressData(codec.second, records[i].data(), records[i].size(), compressed[i]);
+                    rawBytes += records[i].size();
+                    compressedBytes += used[i] == LogFile::RecordHeader::Codec::None ? records[i].size() : compressed[i].size();
+                    decodedBytes += used[i] == LogFile::RecordHeader::Codec::None ? 0 : records[i].size();
+                }
+
+                Bench::Values params = { { "points", points }, { "bits", dataSet.data8Bit ? 8 : 16 }, { "gain", dataSet.noiseLevel } };
+                std::string name = std::string("log.") + codec.first;
+
+                Bench::Measurement m = Bench::measure(reporter.minSeconds(), [&]()
+                {
+                    for (uint_t i = 0; i < records.size(); i++)
+                    {
+                        out.clear();
+                        LogFile::compressData(codec.second, records[i].data(), records[i].size(), out);
+                    }
+                });
+                reporter.report(name + "Compress", params, m, { { "ratio", rawBytes / compressedBytes }, { "mbPerSec", m.iterations * rawBytes / m.seconds / 1e6 } });
+
+                // Nothing to time if every record was stored as it is
+                if (decodedBytes > 0)
+                {
+                    m = Bench::measure(reporter.minSeconds(), [&]()
+                    {
+                        for (uint_t i = 0; i < records.size(); i++)
+                        {
+                            if (used[i] != LogFile::RecordHeader::Codec::None)
+                            {
+                                LogFile::decompressData(used[i], compressed[i].data(), compressed[i].size(), out);
+                            }
+                        }
+                    });
+                    reporter.report(name + "Decompress", params, m, { { "decodedFraction", decodedBytes / rawBytes }, { "mbPerSec", m.iterations * decodedBytes / m.seconds / 1e6 } });
+                }
+            }
+        }
+    }
+}
+//--------------------------------------------------------------------------------------------------
+static Bench::Case logCase("log", logCompression);
+//--------------------------------------------------------------------------------------------------
@@ -0,0 +1,82 @@
+//------------------------------------------ Includes ----------------------------------------------
+
+#include "bench.h"
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+using namespace IslSdk;
+
+//--------------------------------------------------------------------------------------------------
+static void usage()
+{
+    std::printf("usage: islSdkBench [--list] [--filter name] [--time seconds] [--out file]\n");
+    std::printf("  --list           list the benchmarks\n");
+    std::printf("  --filter name    only run benchmarks whose name contains name\n");
+    std::printf("  --time seconds   minimum time per measurement, default 0.5\n");
+    std::printf("  --out file       write results to file instead of stdout, one JSON object per line\n");
+}
+//--------------------------------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+    std::string filter;
+    double minSeconds = 0.5;
+    const char* outFile = nullptr;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strcmp(argv[i], "--list") == 0)
+        {
+            for (const auto& item : Bench::cases())
+            {
+                std::printf("%s\n", item.first);
+            }
+            return 0;
+        }
+        else if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+        {
+            filter = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--time") == 0 && i + 1 < argc)
+        {
+            minSeconds = std::atof(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--out") == 0 && i + 1 < argc)
+        {
+            outFile = argv[++i];
+        }
+        else
+        {
+            usage();
+            return 1;
+        }
+    }
+
+    FILE* out = stdout;
+    if (outFile)
+    {
+        out = std::fopen(outFile, "w");
+        if (out == nullptr)
+        {
+            std::fprintf(stderr, "Unable to open %s\n", outFile);
+            return 1;
+        }
+    }
+
+    Bench::Reporter reporter(out, filter, minSeconds);
+
+    for (const auto& item : Bench::cases())
+    {
+        if (reporter.enabled(item.first))
+        {
+            item.second(reporter);
+        }
+    }
+
+    if (out != stdout)
+    {
+        std::fclose(out);
+    }
+    return 0;
+}
+//--------------------------------------------------------------------------------------------------
@@ -0,0 +1,145 @@
+//------------------------------------------ Includes ----------------------------------------------
+
+#include "pingGenerator.h"
+#include "maths/maths.h"
+#include "platform/mem.h"
+#include <cmath>
+
+using namespace IslSdk;
+
+//--------------------------------------------------------------------------------------------------
+PingGenerator::PingGenerator(const Config& config) : m_config(config), m_random(config.seed ? config.seed : 1), m_angle(config.sectorStart), m_direction(1)
+{
+    if (m_config.stepSize == 0)
+    {
+        m_config.stepSize = 1;
+    }
+
+    if (m_config.sectorSize == 0 || m_config.sectorSize > Sonar::maxAngle)
+    {
+        m_config.sectorSize = Sonar::maxAngle;
+    }
+
+    for (uint_t i = 0; i < m_config.targetCount; i++)
+    {
+        Target target;
+        target.angle = (m_config.sectorStart + random() % m_config.sectorSize) % Sonar::maxAngle;
+        target.rangeMm = m_config.minRangeMm + random() % (m_config.maxRangeMm - m_config.minRangeMm + 1);
+        target.widthAngle = 20 + random() % 100;
+        target.strength = static_cast<uint16_t>(30000 + random() % 35000);
+        m_targets.push_back(target);
+    }
+
+    m_buf.resize(m_config.dataPoints * 2);
+    m_view.stepSize = m_config.stepSize;
+    m_view.minRangeMm = m_config.minRangeMm;
+    m_view.maxRangeMm = m_config.maxRangeMm;
+    m_view.data = m_buf.data();
+    m_view.count = m_config.dataPoints;
+    m_view.bitDepth = m_config.data8Bit ? 8 : 16;
+    m_view.sampleBytes = m_view.bitDepth / 8;
+}
+//--------------------------------------------------------------------------------------------------
+const Sonar::PingView& PingGenerator::next()
+{
+    m_view.angle = m_angle;
+    m_view.stepSize = m_config.stepSize * m_direction;
+
+    real_t mmPerPoint = static_cast<real_t>(m_config.maxRangeMm - m_config.minRangeMm) / Math::max<uint_t>(m_config.dataPoints, 1);
+
+    for (uint_t i = 0; i < m_config.dataPoints; i++)
+    {
+        uint16_t value = echo(m_angle, m_config.minRangeMm + static_cast<uint_t>(i * mmPerPoint));
+
+        if (m_config.data8Bit)
+        {
+            m_buf[i] = static_cast<uint8_t>(value >> 8);
+        }
+        else
+        {
+            Mem::pack16Bit(&m_buf[i * 2], value);
+        }
+    }
+
+    // Sweep back and forth across a sector, round and round for a full circle
+    uint_t step = static_cast<uint_t>(Math::abs(m_config.stepSize));
+    uint_t offset = (m_angle + Sonar::maxAngle - m_config.sectorStart) % Sonar::maxAngle;
+
+    if (m_config.sectorSize == Sonar::maxAngle)
+    {
+        m_angle = (m_angle + step) % Sonar::maxAngle;
+    }
+    else if (m_direction > 0 && offset + step > m_config.sectorSize)
+    {
+        m_direction = -1;
+    }
+    else if (m_direction < 0 && offset < step)
+    {
+        m_direction = 1;
+    }
+    else
+    {
+        m_angle = (m_angle + Sonar::maxAngle + step * m_direction) % Sonar::maxAngle;
+    }
+
+    return m_view;
+}
+//--------------------------------------------------------------------------------------------------
+std::vector<Sonar::Ping> PingGenerator::sweep()
+{
+    std::vector<Sonar::Ping> pings(pingsPerSweep());
+
+    for (Sonar::Ping& ping : pings)
+    {
+        next().copyTo(ping);
+    }
+    return pings;
+}
+//--------------------------------------------------------------------------------------------------
+uint_t PingGenerator::pingsPerSweep() const
+{
+    return Math::max<uint_t>(m_config.sectorSize / static_cast<uint_t>(Math::abs(m_config.stepSize)), 1);
+}
+//--------------------------------------------------------------------------------------------------
+uint32_t PingGenerator::random()
+{
+    // xorshift32, the same sequence on every platform
+    m_random ^= m_random << 13;
+    m_random ^= m_random >> 17;
+    m_random ^= m_random << 5;
+    return m_random;
+}
+//--------------------------------------------------------------------------------------------------
+uint16_t PingGenerator::echo(uint_t angle, uint_t rangeMm)
+{
+    real_t range = rangeMm * 0.001;
+    real_t theta = angle * (2.0 * Math::pi / Sonar::maxAngle);
+
+    // Speckle noise with a noise floor falling with range
+    real_t value = (1500.0 + (random() & 0x7ff) + 6000.0 / (1.0 + range)) * m_config.noiseLevel;
+
+    // A sloping seabed, strong at the first return then a decaying tail
+    real_t seabed = (m_config.maxRangeMm * 0.0004) * (1.6 + 0.5 * std::sin(theta) + 0.2 * std::sin(theta * 5.0));
+    if (range >= seabed)
+    {
+        value += 40000.0 * std::exp(-(range - seabed) * 0.6) * (0.7 + 0.3 * ((random() & 0xff) / 255.0));
+    }
+
+    for (const Target& target : m_targets)
+    {
+        int_t dif = static_cast<int_t>(angle) - static_cast<int_t>(target.angle);
+        dif = Math::abs(dif > static_cast<int_t>(Sonar::maxAngle / 2) ? dif - static_cast<int_t>(Sonar::maxAngle) : dif);
+
+        if (static_cast<uint_t>(dif) < target.widthAngle)
+        {
+            real_t dr = (static_cast<real_t>(rangeMm) - target.rangeMm) * 0.005;
+            real_t da = static_cast<real_t>(dif) / target.widthAngle;
+            value += target.strength * std::exp(-(dr * dr) - 4.0 * da * da);
+        }
+    }
+
+    uint16_t sample = static_cast<uint16_t>(value < 65535.0 ? value : 65535.0);
+    uint_t shift = 16 - Math::clamp<uint_t>(m_config.effectiveBits, 1, 16);
+    return static_cast<uint16_t>((sample >> shift) << shift);
+}
+//--------------------------------------------------------------------------------------------------
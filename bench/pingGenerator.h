@@ -0,0 +1,74 @@
+#ifndef PINGGENERATOR_H_
+#define PINGGENERATOR_H_
+
+//------------------------------------------ Includes ----------------------------------------------
+
+#include "types/sdkTypes.h"
+#include "devices/sonar.h"
+#include <vector>
+
+//--------------------------------------- Class Definition -----------------------------------------
+
+namespace IslSdk
+{
+    /// Produces a repeatable stream of pings that look like a scanning sonar over a sloping seabed with
+    /// a few point targets. The head sweeps the sector back and forth, or round and round for 360 degrees.
+    class PingGenerator
+    {
+    public:
+        struct Config
+        {
+            uint_t sectorStart;                 ///< Start of the sector in units of 12800th
+            uint_t sectorSize;                  ///< Size of the sector in units of 12800th, Sonar::maxAngle for continuous rotation
+            int_t stepSize;                     ///< Angle moved per ping in units of 12800th
+            uint_t dataPoints;                  ///< Number of data points per ping, the imageDataPoint setting
+            uint_t minRangeMm;
+            uint_t maxRangeMm;
+            bool_t data8Bit;                    ///< Generate 8 bit data as sent when System::data8Bit is set
+            uint_t targetCount;
+            uint32_t seed;
+            real_t noiseLevel;                  ///< Scales the water column noise and noise floor, 1 for a high gain setting
+            uint_t effectiveBits;               ///< Values are rounded down to this many bits, as a quantised noise floor at low gain gives. 16 for none
+            Config() : sectorStart(0), sectorSize(Sonar::maxAngle), stepSize(32), dataPoints(1000), minRangeMm(0), maxRangeMm(30000), data8Bit(false), targetCount(8), seed(1), noiseLevel(1.0), effectiveBits(16) {}
+        };
+
+        PingGenerator(const Config& config);
+
+        /**
+        * @brief Generates the next ping.
+        * @return A view over the generator's buffer, valid until the next call.
+        */
+        const Sonar::PingView& next();
+
+        /**
+        * @brief Generates pings covering the sector once.
+        * @return The pings, 8 bit data is widened to 16 bits.
+        */
+        std::vector<Sonar::Ping> sweep();
+
+        uint_t pingsPerSweep() const;
+
+    private:
+        struct Target
+        {
+            uint_t angle;
+            uint_t rangeMm;
+            uint_t widthAngle;
+            uint16_t strength;
+        };
+
+        uint32_t random();
+        uint16_t echo(uint_t angle, uint_t rangeMm);
+
+        Config m_config;
+        std::vector<Target> m_targets;
+        std::vector<uint8_t> m_buf;
+        Sonar::PingView m_view;
+        uint32_t m_random;
+        uint_t m_angle;
+        int_t m_direction;
+    };
+}
+
+//--------------------------------------------------------------------------------------------------
+#endif
@@ -0,0 +1,208 @@
+//------------------------------------------ Includes ----------------------------------------------
+
+#include "bench.h"
+#include "types/queue.h"
+#include "types/mpmcQueue.h"
+#include "platform/mem.h"
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace IslSdk;
+
+static const uint_t queueSize = 1024 * 8;
+static const uint_t itemSize = 64;
+static const uint_t itemsPerProducer = 20000;
+
+/// Queue is single producer single consumer, so each side takes a lock to share it, as callers have to today.
+class LockedQueue
+{
+public:
+    LockedQueue() : m_queue(queueSize) {}
+
+    bool_t put(const uint8_t* data)
+    {
+        std::lock_guard<std::mutex> lock(m_txMutex);
+        void* item = m_queue.newItem(itemSize);
+        if (item)
+        {
+            Mem::memcpy(item, data, itemSize);
+            m_queue.push();
+        }
+        return item != nullptr;
+    }
+
+    bool_t get(uint8_t* data)
+    {
+        std::lock_guard<std::mutex> lock(m_rxMutex);
+        void* item = m_queue.peekNextItem();
+        if (item)
+        {
+            Mem::memcpy(data, item, itemSize);
+            m_queue.pop();
+        }
+        return item != nullptr;
+    }
+
+private:
+    Queue m_queue;
+    std::mutex m_txMutex;
+    std::mutex m_rxMutex;
+};
+
+class LockFreeQueue
+{
+public:
+    LockFreeQueue() : m_queue(queueSize) {}
+
+    bool_t put(const uint8_t* data)
+    {
+        void* item = m_queue.newItem(itemSize);
+        if (item)
+        {
+            Mem::memcpy(item, data, itemSize);
+            m_queue.push(item);
+        }
+        return item != nullptr;
+    }
+
+    bool_t get(uint8_t* data)
+    {
+        void* item = m_queue.peekNextItem();
+        if (item)
+        {
+            Mem::memcpy(data, item, itemSize);
+            m_queue.pop(item);
+        }
+        return item != nullptr;
+    }
+
+private:
+    MpmcQueue m_queue;
+};
+
+class WaitingQueue
+{
+public:
+    WaitingQueue() : m_queue(queueSize) {}
+
+    bool_t put(const uint8_t* data)
+    {
+        void* item = m_queue.newItem(itemSize, 10);
+        if (item)
+        {
+            Mem::memcpy(item, data, itemSize);
+            m_queue.push(item);
+        }
+        return item != nullptr;
+    }
+
+    bool_t get(uint8_t* data)
+    {
+        void* item = m_queue.peekNextItem(10);
+        if (item)
+        {
+            Mem::memcpy(data, item, itemSize);
+            m_queue.pop(item);
+        }
+        return item != nullptr;
+    }
+
+private:
+    BlockingMpmcQueue m_queue;
+};
+
+//--------------------------------------------------------------------------------------------------
+/// Moves itemsPerProducer items from each producer to the consumers, the non blocking queues yield while full or empty.
+template<typename Q> static bool_t transfer(uint_t producers, uint_t consumers)
+{
+    Q queue;
+    std::atomic<uint_t> received(0);
+    std::atomic<uint_t> checksum(0);
+    std::vector<std::thread> threads;
+    const uint_t total = producers * itemsPerProducer;
+
+    for (uint_t p = 0; p < producers; p++)
+    {
+        threads.emplace_back([&, p]()
+        {
+            uint8_t data[itemSize] = {};
+            for (uint_t i = 0; i < itemsPerProducer; i++)
+            {
+                data[0] = static_cast<uint8_t>(p + i);
+                while (!queue.put(data))
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    for (uint_t c = 0; c < consumers; c++)
+    {
+        threads.emplace_back([&]()
+        {
+            uint8_t data[itemSize];
+            uint_t sum = 0;
+            while (received.load(std::memory_order_relaxed) < total)
+            {
+                if (queue.get(data))
+                {
+                    sum += data[0];
+                    received++;
+                }
+                else
+                {
+                    std::this_thread::yield();
+                }
+            }
+            checksum += sum;
+        });
+    }
+
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    uint_t expected = 0;
+    for (uint_t p = 0; p < producers; p++)
+    {
+        for (uint_t i = 0; i < itemsPerProducer; i++)
+        {
+            expected += static_cast<uint8_t>(p + i);
+        }
+    }
+    return checksum == expected;
+}
+//--------------------------------------------------------------------------------------------------
+template<typename Q> static void contention(Bench::Reporter& reporter, const char* name)
+{
+    for (uint_t producers : { 1, 2, 4 })
+    {
+        for (uint_t consumers : { 1, 2 })
+        {
+            bool_t correct = true;
+
+            Bench::Measurement m = Bench::measure(reporter.minSeconds(), [&]()
+            {
+                correct = transfer<Q>(producers, consumers) && correct;
+            });
+
+            double items = static_cast<double>(producers * itemsPerProducer) * m.iterations;
+            reporter.report(name, { { "producers", producers }, { "consumers", consumers } }, m,
+                { { "itemsPerSecond", items / m.seconds }, { "correct", correct } });
+        }
+    }
+}
+//--------------------------------------------------------------------------------------------------
+static void queueContention(Bench::Reporter& reporter)
+{
+    contention<LockedQueue>(reporter, "queue.locked");
+    contention<LockFreeQueue>(reporter, "queue.mpmc");
+    contention<WaitingQueue>(reporter, "queue.blockingMpmc");
+}
+//--------------------------------------------------------------------------------------------------
+static Bench::Case queueCase("queue", queueContention);
+//--------------------------------------------------------------------------------------------------
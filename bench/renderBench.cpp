@@ -0,0 +1,240 @@
+//------------------------------------------ Includes ----------------------------------------------
+
+#include "bench.h"
+#include "pingGenerator.h"
+#include "helpers/sonarDataStore.h"
+#include "helpers/sonarImage.h"
+#include "helpers/palette.h"
+#include "helpers/renderPool.h"
+#include "legacySonarImage.h"
+#include "platform/mem.h"
+
+using namespace IslSdk;
+
+struct Resolution
+{
+    int32_t width;
+    int32_t height;
+};
+
+static const Resolution resolutions[] = { { 640, 480 }, { 1280, 720 }, { 1920, 1080 } };
+static const uint_t sectorSizes[] = { Sonar::maxAngle, Sonar::maxAngle / 4 };
+
+//--------------------------------------------------------------------------------------------------
+static PingGenerator::Config makeConfig(uint_t sectorSize, int_t stepSize, uint_t dataPoints, bool_t data8Bit)
+{
+    PingGenerator::Config config;
+    config.sectorStart = (Sonar::maxAngle - sectorSize / 2) % Sonar::maxAngle;
+    config.sectorSize = sectorSize;
+    config.stepSize = stepSize;
+    config.dataPoints = dataPoints;
+    config.data8Bit = data8Bit;
+    return config;
+}
+//--------------------------------------------------------------------------------------------------
+static void generateSweep(PingGenerator& generator, std::vector<std::vector<uint8_t>>& buffers, std::vector<Sonar::PingView>& pings)
+{
+    // Pings are generated up front so only the SDK is timed
+    for (uint_t i = 0; i < generator.pingsPerSweep(); i++)
+    {
+        const Sonar::PingView& view = generator.next();
+        buffers.emplace_back(view.data, view.data + view.count * view.sampleBytes);
+        pings.push_back(view);
+    }
+
+    for (uint_t i = 0; i < pings.size(); i++)
+    {
+        pings[i].data = buffers[i].data();
+    }
+}
+//--------------------------------------------------------------------------------------------------
+static void fillStore(SonarDataStore& store, PingGenerator& generator)
+{
+    for (uint_t i = 0; i < generator.pingsPerSweep(); i++)
+    {
+        store.add(generator.next());
+    }
+}
+//--------------------------------------------------------------------------------------------------
+static void dataStoreAdd(Bench::Reporter& reporter)
+{
+    for (int_t stepSize : { 8, 32 })
+    {
+        for (uint_t dataPoints : { 500, 2000, 8000 })
+        {
+            for (bool_t data8Bit : { false, true })
+            {
+                PingGenerator generator(makeConfig(Sonar::maxAngle, stepSize, dataPoints, data8Bit));
+                std::vector<std::vector<uint8_t>> buffers;
+                std::vector<Sonar::PingView> pings;
+                generateSweep(generator, buffers, pings);
+
+                SonarDataStore store(dataPoints);
+                for (const Sonar::PingView& ping : pings)
+                {
+                    store.add(ping);
+                }
+
+                Bench::Measurement m = Bench::measure(reporter.minSeconds(), [&]()
+                {
+                    for (const Sonar::PingView& ping : pings)
+                    {
+                        store.add(ping);
+                    }
+                    store.renderComplete();
+                });
+
+                double pingCount = static_cast<double>(m.iterations) * pings.size();
+                m.allocations /= pings.size();
+                reporter.report("dataStore.add", { { "stepSize", stepSize }, { "dataPoints", dataPoints }, { "bitDepth", data8Bit ? 8 : 16 } }, m,
+                    { { "pingsPerSec", pingCount / m.seconds }, { "nsPerPing", m.seconds * 1e9 / pingCount } });
+            }
+        }
+    }
+}
+//--------------------------------------------------------------------------------------------------
+static void imageRender(Bench::Reporter& reporter, const char* name, uint_t mode)
+{
+    Palette palette;
+    RenderPool pool;
+    std::vector<uint_t> threadCounts = { 1 };
+
+    // renderTexture() is single threaded
+    if (pool.threadCount() > 1 && mode != 2)
+    {
+        threadCounts.push_back(pool.threadCount());
+    }
+
+    for (const Resolution& res : resolutions)
+    {
+        for (uint_t sectorSize : sectorSizes)
+        {
+            for (uint_t threads : threadCounts)
+            {
+                PingGenerator::Config config = makeConfig(sectorSize, 32, 1000, false);
+                PingGenerator generator(config);
+                SonarDataStore store;
+                SonarImage image(res.width, res.height, mode != 1);
+                image.setSectorArea(config.minRangeMm, config.maxRangeMm, config.sectorStart, sectorSize);
+                image.setRenderPool(threads > 1 ? &pool : nullptr);
+                fillStore(store, generator);
+
+                Bench::Measurement m = Bench::measure(reporter.minSeconds(), [&]()
+                {
+                    if (mode == 0) image.render(store, palette, true);
+                    else if (mode == 1) image.render16Bit(store, true);
+                    else image.renderTexture(store, palette, true);
+                });
+
+                double pixels = static_cast<double>(res.width) * res.height * m.iterations;
+                reporter.report(name, { { "width", res.width }, { "height", res.height }, { "sectorSize", sectorSize }, { "threads", threads } }, m,
+                    { { "framesPerSec", m.iterations / m.seconds }, { "nsPerPixel", m.seconds * 1e9 / pixels } });
+            }
+        }
+    }
+}
+//--------------------------------------------------------------------------------------------------
+/// The atan2/sqrt per pixel render that SonarImage::render() replaced with its lookup table, for comparison with image.render.
+static void imageRenderLegacy(Bench::Reporter& reporter)
+{
+    Palette palette;
+
+    for (const Resolution& res : resolutions)
+    {
+        for (uint_t sectorSize : sectorSizes)
+        {
+            PingGenerator::Config config = makeConfig(sectorSize, 32, 1000, false);
+            PingGenerator generator(config);
+            SonarDataStore store;
+            LegacySonarImage legacy(res.width, res.height);
+            legacy.setSectorArea(config.minRangeMm, config.maxRangeMm, config.sectorStart, sectorSize);
+            fillStore(store, generator);
+
+            Bench::Measurement m = Bench::measure(reporter.minSeconds(), [&]() { legacy.render(store, palette); });
+
+            // Both paths should produce the same image
+            SonarImage image(res.width, res.height, true);
+            image.setSectorArea(config.minRangeMm, config.maxRangeMm, config.sectorStart, sectorSize);
+            image.render(store, palette, true);
+
+            double matching = 0;
+            for (uint_t i = 0; i < legacy.buf.size(); i++)
+            {
+                uint32_t pixel;
+                Mem::memcpy(&pixel, &image.buf[i * 4], sizeof(pixel));
+                matching += pixel == legacy.buf[i];
+            }
+
+            double pixels = static_cast<double>(res.width) * res.height * m.iterations;
+            reporter.report("image.renderLegacy", { { "width", res.width }, { "height", res.height }, { "sectorSize", sectorSize }, { "threads", 1 } }, m,
+                { { "framesPerSec", m.iterations / m.seconds }, { "nsPerPixel", m.seconds * 1e9 / pixels }, { "matchingPixels", matching / legacy.buf.size() } });
+        }
+    }
+}
+//--------------------------------------------------------------------------------------------------
+static void imageRenderIncremental(Bench::Reporter& reporter, const char* name, bool_t texture)
+{
+    Palette palette;
+
+    for (const Resolution& res : resolutions)
+    {
+        for (bool_t data8Bit : { false, true })
+        {
+            PingGenerator::Config config = makeConfig(Sonar::maxAngle, 32, 1000, data8Bit);
+            PingGenerator generator(config);
+            std::vector<std::vector<uint8_t>> buffers;
+            std::vector<Sonar::PingView> pings;
+            SonarDataStore store;
+            SonarImage image(res.width, res.height, true);
+            uint_t idx = 0;
+
+            generateSweep(generator, buffers, pings);
+            for (const Sonar::PingView& ping : pings)
+            {
+                store.add(ping);
+            }
+
+            if (texture) image.renderTexture(store, palette, true);
+            else image.render(store, palette, true);
+
+            // One ping per frame, as a display updating on every ping would
+            Bench::Measurement m = Bench::measure(reporter.minSeconds(), [&]()
+            {
+                store.add(pings[idx]);
+                idx = (idx + 1) % pings.size();
+                if (texture) image.renderTexture(store, palette);
+                else image.render(store, palette);
+            });
+
+            reporter.report(name, { { "width", res.width }, { "height", res.height }, { "bitDepth", data8Bit ? 8 : 16 } }, m,
+                { { "framesPerSec", m.iterations / m.seconds }, { "usPerFrame", m.seconds * 1e6 / m.iterations } });
+        }
+    }
+}
+//--------------------------------------------------------------------------------------------------
+static void paletteSet(Bench::Reporter& reporter)
+{
+    Palette palette;
+    std::vector<Palette::GradientValue> gradient;
+    gradient.emplace_back(0xff000000, 0);
+    gradient.emplace_back(0xffab5a20, 14000);
+    gradient.emplace_back(0xff3dce27, 26000);
+    gradient.emplace_back(0xff0012ce, 65535);
+
+    Bench::Measurement m = Bench::measure(reporter.minSeconds(), [&]() { palette.set(gradient, 0xff000000); });
+    reporter.report("palette.set", { { "gradientSize", gradient.size() } }, m, { { "perSec", m.iterations / m.seconds } });
+
+    uint_t i = 0;
+    m = Bench::measure(reporter.minSeconds(), [&]() { palette.setTransfer(1.0f + (i++ & 1), 0.8f); });
+    reporter.report("palette.setTransfer", {}, m, { { "perSec", m.iterations / m.seconds } });
+}
+//--------------------------------------------------------------------------------------------------
+static Bench::Case addCase("dataStore.add", dataStoreAdd);
+static Bench::Case renderCase("image.render", [](Bench::Reporter& r) { imageRender(r, "image.render", 0); });
+static Bench::Case legacyCase("image.renderLegacy", imageRenderLegacy);
+static Bench::Case render16Case("image.render16Bit", [](Bench::Reporter& r) { imageRender(r, "image.render16Bit", 1); });
+static Bench::Case textureCase("image.renderTexture", [](Bench::Reporter& r) { imageRender(r, "image.renderTexture", 2); });
+static Bench::Case incrementalCase("image.renderIncremental", [](Bench::Reporter& r) { imageRenderIncremental(r, "image.renderIncremental", false); });
+static Bench::Case textureIncrementalCase("image.renderTextureIncremental", [](Bench::Reporter& r) { imageRenderIncremental(r, "image.renderTextureIncremental", true); });
+static Bench::Case paletteCase("palette.set", paletteSet);
+//--------------------------------------------------------------------------------------------------
@@ -20,12 +20,8 @@ namespace IslSdk
         uint32_t ipAddress;                         ///< IpAddress data is sent to
         uint16_t port;                              ///< The port data is sent to
 
-        ConnectionMeta(const ConnectionMeta& meta)
-        {
-            baudrate = meta.baudrate;
-            ipAddress = meta.ipAddress;
-            port = meta.port;
-        }
+        ConnectionMeta(const ConnectionMeta& meta) = default;
+        ConnectionMeta& operator=(const ConnectionMeta& meta) = default;
 
         bool_t isDifferent(const ConnectionMeta& meta) const
         {
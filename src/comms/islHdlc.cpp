@@ -6,6 +6,7 @@
 #include "maths/maths.h"
 #include "platform/timeUtils.h"
 #include "platform/debug.h"
+#include "platform/eventLoop.h"
 
 using namespace IslSdk;
 
@@ -70,7 +71,7 @@ bool_t IslHdlcPacket::fromFrame(const uint8_t* frame, uint_t frameSize)
                 header.address = 0;
                 size = 14;
                 frame += 10;
-                static uint8_t buf[14];
+                static thread_local uint8_t buf[14];
                 buf[0] = frame[4];
                 buf[1] = frame[5];
                 buf[2] = frame[0];
@@ -136,13 +137,22 @@ const std::vector<uint8_t> IslHdlc::BuildDiscovery(uint16_t pid, uint16_t pn, ui
 }
 //--------------------------------------------------------------------------------------------------
 IslHdlc::IslHdlc(uint_t mtu, uint_t txQueSize, uint8_t armWindowSize, uint8_t nrmWindowSize) :
+    id(static_cast<uint32_t>(Math::randomNum(1, Math::maxUint32))),
+    m_timeoutMs(500),
+    m_nrmWindowSize(nrmWindowSize),
+    m_armWindowSize(armWindowSize),
     m_mtu(mtu),
     m_txPacketQ(txQueSize),
-    m_armWindowSize(armWindowSize),
-    m_nrmWindowSize(nrmWindowSize),
-    m_timeoutMs(500),
-    id(static_cast<uint32_t>(Math::randomNum(1, Math::maxUint32)))
+    m_rxPool(mtu, 4),
+    m_selectiveReject(false)
 {
+    uint_t reorderSize = 1;
+    while (reorderSize <= Math::max(armWindowSize, nrmWindowSize))
+    {
+        reorderSize <<= 1;
+    }
+    m_rxReorder.resize(reorderSize);
+
     if (m_addressCounter == 0)
     {
         m_addressCounter = static_cast<uint8_t>(Math::randomNum(1, 254));
@@ -155,6 +165,7 @@ IslHdlc::IslHdlc(uint_t mtu, uint_t txQueSize, uint8_t armWindowSize, uint8_t nr
 
     m_address = m_addressCounter++;
     m_windowSize = nrmWindowSize;
+    m_maxWindowSize = nrmWindowSize;
     reset();
 }
 //--------------------------------------------------------------------------------------------------
@@ -187,10 +198,21 @@ void IslHdlc::reset()
     m_timeoutCount = 0;
     m_timeout = 0;
     m_pollFlagTxTime = 0;
+    m_windowAckCount = 0;
+    m_windowReduceTime = 0;
+    m_rttMeasured = false;
+    m_srtt = 0;
+    m_rttVar = 0;
+    m_rtoMs = m_timeoutMs;
     m_txPacketQ.reset();
     m_ctrlFrameSize = 0;
-    m_multiFrameBuffering = false;
-    m_multiFrameBuf.clear();
+    m_fragments.clear();
+    m_fragmentsSize = 0;
+    for (RxFrame& frame : m_rxReorder)
+    {
+        frame.valid = false;
+        frame.payload = BufferSlice();
+    }
     m_packetCount.tx = 0;
     m_packetCount.rx = 0;
     m_packetCount.resent = 0;
@@ -199,11 +221,40 @@ void IslHdlc::reset()
 //--------------------------------------------------------------------------------------------------
 void IslHdlc::setCommsTimeout(uint32_t timeoutMs)
 {
+    std::lock_guard<std::recursive_mutex> lock(SysPort::commsMutex);
+
     m_timeoutMs = timeoutMs;
+    if (!m_rttMeasured)
+    {
+        m_rtoMs = timeoutMs;
+    }
+}
+//--------------------------------------------------------------------------------------------------
+IslHdlc::LinkStats IslHdlc::getLinkStats() const
+{
+    std::lock_guard<std::recursive_mutex> lock(SysPort::commsMutex);
+
+    LinkStats stats;
+    stats.rttMs = static_cast<uint_t>(m_srtt >> 3);
+    stats.rttVarMs = static_cast<uint_t>(m_rttVar >> 2);
+    stats.rtoMs = m_rtoMs;
+    stats.windowSize = m_windowSize;
+    stats.maxWindowSize = m_maxWindowSize;
+
+    return stats;
+}
+//--------------------------------------------------------------------------------------------------
+void IslHdlc::setSelectiveReject(bool_t enable)
+{
+    std::lock_guard<std::recursive_mutex> lock(SysPort::commsMutex);
+
+    m_selectiveReject = enable;
 }
 //--------------------------------------------------------------------------------------------------
 void IslHdlc::connect(uint16_t pn, uint16_t sn, uint32_t timeout)
 {
+    std::lock_guard<std::recursive_mutex> lock(SysPort::commsMutex);
+
     uint8_t buf[10];
     uint8_t* ptr;
 
@@ -220,6 +271,8 @@ void IslHdlc::connect(uint16_t pn, uint16_t sn, uint32_t timeout)
 //--------------------------------------------------------------------------------------------------
 void IslHdlc::disconnect()
 {
+    std::lock_guard<std::recursive_mutex> lock(SysPort::commsMutex);
+
     sendUFrame(IslHdlcPacket::UframeCode::Disconnect, m_address, nullptr, 0);
     process();
     if (m_connected)
@@ -235,16 +288,20 @@ void IslHdlc::setNrmMode(bool_t isNrm)
     m_isNrm = isNrm;
     if (m_isNrm && m_armWindowSize > m_nrmWindowSize)
     {
-        m_windowSize = m_nrmWindowSize;
+        m_maxWindowSize = m_nrmWindowSize;
     }
     else
     {
-        m_windowSize = m_armWindowSize;
+        m_maxWindowSize = m_armWindowSize;
     }
+    m_windowAckCount = 0;
+    setWindowSize(m_maxWindowSize);
 }
 //--------------------------------------------------------------------------------------------------
 bool_t IslHdlc::process()
 {
+    std::lock_guard<std::recursive_mutex> lock(SysPort::commsMutex);
+
     bool_t didSend = false;
     uint_t windowSize;
 
@@ -253,7 +310,7 @@ bool_t IslHdlc::process()
         uint64_t time = Time::getTimeMs();
         if (m_waitForFinalFlag)
         {
-            if (time >= m_timeout || time >= (m_pollFlagTxTime + m_timeoutMs + 4500))
+            if (time >= m_timeout || time >= (m_pollFlagTxTime + m_rtoMs + 4500))
             {
                 if (m_connection)
                 {
@@ -275,6 +332,7 @@ bool_t IslHdlc::process()
                 else
                 {
                     m_timeoutCount++;
+                    reduceWindow();
                 }
             }
         }
@@ -292,6 +350,11 @@ bool_t IslHdlc::process()
         }
     }
 
+    if (m_talkToken && m_ctrlFrameSize && isAckOnly(&m_ctrlFrameBuf[0]) && iFrameReady())
+    {
+        m_ctrlFrameSize = 0;        // The I frame about to be sent carries the same ack
+    }
+
     if (m_talkToken && m_ctrlFrameSize)
     {
         didSend = transmitFrame(&m_ctrlFrameBuf[0], m_ctrlFrameSize);
@@ -342,7 +405,16 @@ bool_t IslHdlc::process()
 //--------------------------------------------------------------------------------------------------
 void IslHdlc::processPacket(const IslHdlcPacket& packet)
 {
+    std::lock_guard<std::recursive_mutex> lock(SysPort::commsMutex);
+
     m_packetCount.rx++;
+
+    // Only time polls that weren't resent, as the final could be the response to either
+    if (m_waitForFinalFlag && m_timeoutCount == 0 && packet.header.pf && !packet.header.cr)
+    {
+        updateRtt(static_cast<uint_t>(Time::getTimeMs() - m_pollFlagTxTime));
+    }
+
     if (packet.header.pf && !packet.header.cr)
     {
         m_talkToken = true;
@@ -352,8 +424,9 @@ void IslHdlc::processPacket(const IslHdlcPacket& packet)
     m_waitForFinalFlag = m_waitForFinalFlag && !(packet.header.pf && !packet.header.cr);
     m_timeoutCount = 0;
 
-    m_timeout = Time::getTimeMs() + m_timeoutMs;
+    m_timeout = Time::getTimeMs() + m_rtoMs;
 
+    // The RTT varies with frame size on a serial port, so always allow for a full frame to arrive
     if (m_connection->sysPort->type == SysPort::Type::Serial)
     {
         m_timeout += static_cast<uint64_t>(static_cast<real_t>(m_mtu) * (static_cast<real_t>(10000.0) / static_cast<real_t>(m_connection->meta.baudrate)));
@@ -404,8 +477,12 @@ void IslHdlc::processPacket(const IslHdlcPacket& packet)
 //--------------------------------------------------------------------------------------------------
 void IslHdlc::send(const uint8_t* data, uint_t size)
 {
+    std::lock_guard<std::recursive_mutex> lock(SysPort::commsMutex);
+
     if (m_connected)
     {
+        EventLoop::wake();          // So a waiting Sdk::run() or I/O thread transmits, and flushes batched writes, without waiting for its timeout
+
         while (size)
         {
             uint_t txSize = Math::min<uint_t>(m_mtu, size);
@@ -442,7 +519,8 @@ void IslHdlc::send(const uint8_t* data, uint_t size)
 //--------------------------------------------------------------------------------------------------
 void IslHdlc::sendSFrame(IslHdlcPacket::SframeCode code)
 {
-    if (m_ctrlFrameSize == 0)
+    // A reject replaces a queued RR as it carries the same ack
+    if (m_ctrlFrameSize == 0 || (code != IslHdlcPacket::SframeCode::Rr && isAckOnly(&m_ctrlFrameBuf[0])))
     {
         m_ctrlFrameSize = IslHdlcPacket::overHeadSize;
         m_ctrlFrameBuf[0] = static_cast<uint8_t>(IslHdlcPacket::FrameType::S);
@@ -467,38 +545,56 @@ void IslHdlc::sendUFrame(IslHdlcPacket::UframeCode code, uint8_t address, void*
 //--------------------------------------------------------------------------------------------------
 void IslHdlc::processIFrame(const IslHdlcPacket& packet)
 {
-    if (packet.header.seq == m_nextRxSeq)
+    const uint_t mask = m_rxReorder.size() - 1;
+    uint8_t offset = packet.header.seq - m_nextRxSeq;
+
+    if (offset == 0)
     {
         m_blockRej = false;
+        deliverIFrame(packet.header.type, { BufferPool::Ref(), packet.payload, packet.size });
         m_nextRxSeq++;
 
-        if (packet.header.type == IslHdlcPacket::FrameType::Im && !m_multiFrameBuffering)
+        // Frames that arrived after the gap can now be delivered in order
+        RxFrame* frame = &m_rxReorder[m_nextRxSeq & mask];
+        while (frame->valid)
         {
-            m_multiFrameBuf.clear();
-            m_multiFrameBuffering = true;
+            frame->valid = false;
+            deliverIFrame(frame->type, frame->payload);
+            frame->payload = BufferSlice();
+            m_nextRxSeq++;
+            frame = &m_rxReorder[m_nextRxSeq & mask];
         }
 
-        if (m_multiFrameBuffering)
+        if (rxGap())
         {
-            if (m_multiFrameBuf.capacity() < m_multiFrameBuf.size() + packet.size)
-            {
-                m_multiFrameBuf.reserve((m_multiFrameBuf.size() + packet.size) * 2);
-            }
-
-            m_multiFrameBuf.insert(m_multiFrameBuf.end(), &packet.payload[0], &packet.payload[packet.size]);
+            debugLog("IslHdlc", "Rx sequence gap at:%u. Sending SREJ", FMT_U(m_nextRxSeq));
+            m_blockRej = true;
+            sendSFrame(IslHdlcPacket::SframeCode::Srej);
+        }
+    }
+    else if (m_selectiveReject && offset < m_rxReorder.size())
+    {
+        RxFrame& frame = m_rxReorder[packet.header.seq & mask];
 
-            if (packet.header.type == IslHdlcPacket::FrameType::I)
-            {
-                newPacketEvent(&m_multiFrameBuf[0], m_multiFrameBuf.size());
-                m_multiFrameBuf.clear();
-                m_multiFrameBuffering = false;
-            }
+        if (!frame.valid)
+        {
+            frame.valid = true;
+            frame.type = packet.header.type;
+            frame.payload = keep(packet.payload, packet.size);
         }
-        else
+
+        if (!m_blockRej)
         {
-            newPacketEvent(packet.payload, packet.size);
+            debugLog("IslHdlc", "Rx sequence error, received:%u expected:%u. Sending SREJ", FMT_U(packet.header.seq), FMT_U(m_nextRxSeq));
+            m_blockRej = true;
+            m_packetCount.rxMissed += offset;
+            sendSFrame(IslHdlcPacket::SframeCode::Srej);
         }
     }
+    else if (m_selectiveReject && offset >= 0x80)
+    {
+        sendSFrame(IslHdlcPacket::SframeCode::Rr);          // Already received, so the ack was lost
+    }
     else if (!m_blockRej)
     {
         debugLog("IslHdlc", "Rx sequence error, received:%u expected:%u. Sending REJ", FMT_U(packet.header.seq), FMT_U(m_nextRxSeq));
@@ -508,6 +604,67 @@ void IslHdlc::processIFrame(const IslHdlcPacket& packet)
     }
 }
 //--------------------------------------------------------------------------------------------------
+void IslHdlc::deliverIFrame(IslHdlcPacket::FrameType type, const BufferSlice& payload)
+{
+    if (type == IslHdlcPacket::FrameType::Im)
+    {
+        m_fragments.push_back(payload.buffer ? payload : keep(payload.data, payload.size));
+        m_fragmentsSize += payload.size;
+    }
+    else if (m_fragments.empty())
+    {
+        newPacketEvent(payload.data, payload.size);
+    }
+    else
+    {
+        m_fragments.push_back(payload);
+        newPacketEvent(m_fragments, m_fragmentsSize + payload.size);
+        m_fragments.clear();
+        m_fragmentsSize = 0;
+    }
+}
+//--------------------------------------------------------------------------------------------------
+BufferSlice IslHdlc::keep(const uint8_t* data, uint_t size)
+{
+    const BufferPool::Ref* rxBuffer = m_connection ? m_connection->sysPort->rxBuffer() : nullptr;
+
+    if (rxBuffer && rxBuffer->contains(data, size))
+    {
+        return { *rxBuffer, data, size };
+    }
+
+    // Not received into a pooled buffer, eg decoded from a serial stream, so it has to be copied
+    BufferSlice slice = { m_rxPool.get(size), nullptr, size };
+    slice.data = slice.buffer.data();
+    Mem::memcpy(slice.buffer.data(), data, size);
+    return slice;
+}
+//--------------------------------------------------------------------------------------------------
+void IslHdlc::newPacketEvent(const ScatterList& fragments, uint_t size)
+{
+    m_multiFrameBuf.resize(size);
+    uint8_t* ptr = m_multiFrameBuf.data();
+
+    for (const BufferSlice& fragment : fragments)
+    {
+        Mem::memcpy(ptr, fragment.data, fragment.size);
+        ptr += fragment.size;
+    }
+    newPacketEvent(m_multiFrameBuf.data(), size);
+}
+//--------------------------------------------------------------------------------------------------
+bool_t IslHdlc::rxGap() const
+{
+    for (const RxFrame& frame : m_rxReorder)
+    {
+        if (frame.valid)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+//--------------------------------------------------------------------------------------------------
 void IslHdlc::processSFrame(const IslHdlcPacket& packet)
 {
     TxItem* msg;
@@ -533,15 +690,21 @@ void IslHdlc::processSFrame(const IslHdlcPacket& packet)
                 m_pendingTxCount++;
             }
         }
+        reduceWindow();
         break;
 
     case IslHdlcPacket::SframeCode::Srej:
         msg = reinterpret_cast<TxItem*>(m_txPacketQ.peekNextItem());
-        if (msg != nullptr && !msg->send && msg->seq == packet.header.ack)
+        while (msg != nullptr && msg->seq != packet.header.ack)
+        {
+            msg = reinterpret_cast<TxItem*>(m_txPacketQ.peekNextItem(msg));
+        }
+
+        if (msg != nullptr && !msg->send)
         {
             msg->send = true;
-            m_pendingTxCount++;
         }
+        reduceWindow();
         break;
     }
 }
@@ -600,11 +763,23 @@ void IslHdlc::processAck(const IslHdlcPacket::Header& hdr)
             m_windowLevel--;
             m_txMsgCount--;
             windowCount--;
-            m_pendingTxCount += m_txMsgCount >= m_windowSize;
+            m_windowAckCount++;
+        }
+
+        // Open the window by one frame for each full window acked without loss
+        if (m_windowSize < m_maxWindowSize && m_windowAckCount >= m_windowSize)
+        {
+            m_windowAckCount -= m_windowSize;
+            setWindowSize(m_windowSize + 1);
+        }
+        else
+        {
+            setWindowSize(m_windowSize);
         }
 
         if (hdr.pf && msg != nullptr && (m_checkpointTxSeq != hdr.ack))
         {
+            reduceWindow();
             windowCount = m_windowSize;
             while (msg != nullptr && windowCount)
             {
@@ -620,6 +795,82 @@ void IslHdlc::processAck(const IslHdlcPacket::Header& hdr)
     }
 }
 //--------------------------------------------------------------------------------------------------
+void IslHdlc::updateRtt(uint_t rttMs)
+{
+    // Jacobson / Karels, with srtt scaled by 8 and rttvar by 4 so the gains are shifts
+    if (m_rttMeasured)
+    {
+        int_t err = static_cast<int_t>(rttMs) - (m_srtt >> 3);
+        m_srtt += err;
+        m_rttVar += Math::abs(err) - (m_rttVar >> 2);
+    }
+    else
+    {
+        m_srtt = static_cast<int_t>(rttMs) << 3;
+        m_rttVar = static_cast<int_t>(rttMs) << 1;
+        m_rttMeasured = true;
+    }
+
+    m_rtoMs = Math::clamp<uint_t>(static_cast<uint_t>((m_srtt >> 3) + m_rttVar), minRtoMs, maxRtoMs);
+}
+//--------------------------------------------------------------------------------------------------
+void IslHdlc::reduceWindow()
+{
+    uint64_t time = Time::getTimeMs();
+
+    // Once per round trip, as the loss of one burst is reported by several frames
+    if (time >= m_windowReduceTime)
+    {
+        m_windowReduceTime = time + m_rtoMs;
+        m_windowAckCount = 0;
+        setWindowSize(Math::max<uint8_t>(m_windowSize / 2, 1));
+    }
+    else
+    {
+        setWindowSize(m_windowSize);
+    }
+}
+//--------------------------------------------------------------------------------------------------
+void IslHdlc::setWindowSize(uint8_t windowSize)
+{
+    uint_t count = windowSize;
+    TxItem* msg = reinterpret_cast<TxItem*>(m_txPacketQ.peekNextItem());
+
+    m_windowSize = windowSize;
+    m_pendingTxCount = 0;
+
+    // Frames already sent beyond a reduced window are not pending, so recount rather than adjust
+    while (msg && count)
+    {
+        m_pendingTxCount += msg->send;
+        msg = reinterpret_cast<TxItem*>(m_txPacketQ.peekNextItem(msg));
+        count--;
+    }
+}
+//--------------------------------------------------------------------------------------------------
+bool_t IslHdlc::isAckOnly(const uint8_t* frame) const
+{
+    return static_cast<IslHdlcPacket::FrameType>(frame[0] & HeaderMasks::frameType) == IslHdlcPacket::FrameType::S && static_cast<IslHdlcPacket::SframeCode>(frame[2]) == IslHdlcPacket::SframeCode::Rr;
+}
+//--------------------------------------------------------------------------------------------------
+bool_t IslHdlc::iFrameReady()
+{
+    uint_t windowSize = m_windowSize;
+    TxItem* msg = reinterpret_cast<TxItem*>(m_txPacketQ.peekNextItem());
+
+    while (msg && windowSize)
+    {
+        if (msg->send)
+        {
+            return true;
+        }
+        msg = reinterpret_cast<TxItem*>(m_txPacketQ.peekNextItem(msg));
+        windowSize--;
+    }
+
+    return false;
+}
+//--------------------------------------------------------------------------------------------------
 bool_t IslHdlc::transmitFrame(uint8_t* frame, uint_t size)
 {
     bool_t written = false;
@@ -669,7 +920,7 @@ bool_t IslHdlc::transmitFrame(uint8_t* frame, uint_t size)
                         m_connection->sysPort->block(id);
                     }
                     m_pollFlagTxTime = Time::getTimeMs();
-                    m_timeout = m_pollFlagTxTime + (m_timeoutMs * (static_cast<uint_t>(1) << m_timeoutCount));
+                    m_timeout = m_pollFlagTxTime + (m_rtoMs * (static_cast<uint_t>(1) << m_timeoutCount));
                     m_waitForFinalFlag = true;
                     if (m_connection->sysPort->type == SysPort::Type::Serial)
                     {
@@ -6,6 +6,7 @@
 #include "types/sdkTypes.h"
 #include "comms/ports/sysPort.h"
 #include "types/queue.h"
+#include "types/bufferPool.h"
 #include <vector>
 #include <memory>
 
@@ -53,10 +54,39 @@ namespace IslSdk
     class IslHdlc
     {
     public:
+        struct LinkStats
+        {
+            uint_t rttMs;                               ///< Smoothed round trip time between a poll and the device's final response.
+            uint_t rttVarMs;                            ///< Mean deviation of the round trip time.
+            uint_t rtoMs;                               ///< Retransmit timeout, rttMs + 4 * rttVarMs once measured. Serial ports also allow the time to send a frame at the baudrate.
+            uint8_t windowSize;                         ///< Frames that can be sent before waiting for an ack, halved when frames are lost.
+            uint8_t maxWindowSize;                      ///< The negotiated window size.
+        };
+
         const uint32_t id;
         IslHdlc(uint_t mtu = 1050, uint_t txQueSize = 1024 * 8, uint8_t armWindowSize = 15, uint8_t nrmWindowSize = 8);
         virtual ~IslHdlc();
+
+        /**
+        * @brief Sets the comms timeout used until the round trip time has been measured.
+        * After that the timeout is derived from the measured round trip time.
+        * @param timeoutMs The timeout in milliseconds.
+        */
         void setCommsTimeout(uint32_t timeoutMs);
+
+        /**
+        * @brief Get the measured round trip time, retransmit timeout and current window size of the link.
+        * @return The link statistics.
+        */
+        LinkStats getLinkStats() const;
+
+        /**
+        * @brief Enables selective reject for frames received from the device.
+        * Frames after a gap are kept and only the missing frame is requested with SREJ, rather than REJ which has the
+        * device resend everything from the missing frame on. The device firmware must support SREJ.
+        * @param enable True to use SREJ, false to use REJ.
+        */
+        void setSelectiveReject(bool_t enable);
         void processPacket(const IslHdlcPacket& packet);
         static const std::vector<uint8_t> BuildDiscovery(uint16_t pid, uint16_t pn, uint16_t sn);
         void disconnect();
@@ -79,12 +109,30 @@ namespace IslSdk
         virtual bool_t timeoutEvent() = 0;
         virtual void newPacketEvent(const uint8_t* data, uint_t size) = 0;
 
+        /**
+        * @brief A packet that arrived as several frames.
+        * The fragments are referenced where the port received them rather than being copied together. The default
+        * gathers them into one buffer and calls newPacketEvent(data, size).
+        * @param fragments The payload of each frame in order.
+        * @param size The total size of the packet.
+        */
+        virtual void newPacketEvent(const ScatterList& fragments, uint_t size);
+
         void connect(uint16_t pn, uint16_t sn, uint32_t timeout);
         void setNrmMode(bool_t isNrm);
         bool_t process();
         void send(const uint8_t* data, uint_t size);
 
     private:
+        struct RxFrame
+        {
+            bool_t valid;
+            IslHdlcPacket::FrameType type;
+            BufferSlice payload;
+        };
+
+        static constexpr uint_t minRtoMs = 100;
+        static constexpr uint_t maxRtoMs = 60000;
         static uint8_t m_addressCounter;
         const uint8_t m_nrmWindowSize;
         const uint8_t m_armWindowSize;
@@ -95,6 +143,13 @@ namespace IslSdk
         uint8_t m_nextRxSeq;
         uint8_t m_windowLevel;
         uint8_t m_windowSize;
+        uint8_t m_maxWindowSize;
+        uint_t m_windowAckCount;
+        uint64_t m_windowReduceTime;
+        bool_t m_rttMeasured;
+        int_t m_srtt;                                           ///< Smoothed round trip time in ms, scaled by 8.
+        int_t m_rttVar;                                         ///< Round trip time deviation in ms, scaled by 4.
+        uint_t m_rtoMs;
         uint8_t m_checkpointTxSeq;
         uint8_t m_lastTxSeq;
         bool_t m_pollFlag;
@@ -110,15 +165,27 @@ namespace IslSdk
         uint_t m_ctrlFrameSize;
         uint8_t m_ctrlFrameBuf[256];
         std::vector<uint8_t> m_multiFrameBuf;
-        bool_t m_multiFrameBuffering;
+        ScatterList m_fragments;                                ///< Frames of a multi frame packet received so far.
+        uint_t m_fragmentsSize;
+        BufferPool m_rxPool;                                    ///< Holds received frames that aren't in a pooled port buffer.
+        bool_t m_selectiveReject;
+        std::vector<RxFrame> m_rxReorder;                       ///< Frames received after a gap, indexed by sequence number, size is a power of 2.
 
         void reset();
         void sendSFrame(IslHdlcPacket::SframeCode code);
         void sendUFrame(IslHdlcPacket::UframeCode code, uint8_t address, void* data, uint_t size);
         void processIFrame(const IslHdlcPacket& packet);
+        void deliverIFrame(IslHdlcPacket::FrameType type, const BufferSlice& payload);
+        BufferSlice keep(const uint8_t* data, uint_t size);
+        bool_t rxGap() const;
         void processSFrame(const IslHdlcPacket& packet);
         void processUFrame(const IslHdlcPacket& packet);
         void processAck(const IslHdlcPacket::Header& hdr);
+        void updateRtt(uint_t rttMs);
+        void reduceWindow();
+        void setWindowSize(uint8_t windowSize);
+        bool_t isAckOnly(const uint8_t* frame) const;
+        bool_t iFrameReady();
         bool_t transmitFrame(uint8_t* frame, uint_t size);
     };
 }
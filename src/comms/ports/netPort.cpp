@@ -3,6 +3,8 @@
 #include "netPort.h"
 #include "utils/utils.h"
 #include "platform/debug.h"
+#include "platform/mem.h"
+#include <algorithm>
 
 using namespace IslSdk;
 
@@ -12,8 +14,20 @@ NetPort::NetPort(const std::string& name, bool_t isTcp, bool_t isServer, uint32_
     m_isTcp(isTcp),
     m_isServer(isServer),
     m_ipAddress(ipAddress),
-    m_port(port)
+    m_port(port),
+    m_rxPool(maxDatagramSize, batchSize * 2),
+    m_rxBuffers(batchSize),
+    m_rxDatagrams(batchSize),
+    m_txBuf(batchSize * maxDatagramSize),
+    m_txDatagrams(batchSize),
+    m_txCount(0),
+    m_rxPacketCount(0),
+    m_txPacketCount(0)
 {
+    for (uint_t i = 0; i < batchSize; i++)
+    {
+        m_txDatagrams[i].data = &m_txBuf[i * maxDatagramSize];
+    }
 }
 //--------------------------------------------------------------------------------------------------
 NetPort::~NetPort()
@@ -22,6 +36,8 @@ NetPort::~NetPort()
 //--------------------------------------------------------------------------------------------------
 void NetPort::open()
 {
+    std::lock_guard<std::recursive_mutex> lock(commsMutex);
+
     if (!m_isOpen)
     {
         m_socket = std::make_unique<NetSocket>(m_isTcp, m_isServer, m_ipAddress, m_port);
@@ -34,9 +50,15 @@ void NetPort::open()
 //--------------------------------------------------------------------------------------------------
 void NetPort::close()
 {
+    std::lock_guard<std::recursive_mutex> lock(commsMutex);
+
     if (m_socket)
     {
+        flush();
         m_socket.reset();
+        m_txCount = 0;
+        m_rxPacketCount = 0;
+        m_txPacketCount = 0;
         SysPort::close();
     }
 }
@@ -47,20 +69,82 @@ bool_t NetPort::write(const uint8_t* data, uint_t size, const ConnectionMeta& me
 
     if (m_socket)
     {
-        NetSocket::State state = m_socket->write(data, &size, meta.ipAddress, meta.port);
+        if (NetSocket::hasBatchIo && !m_isTcp && size <= maxDatagramSize)
+        {
+            // Held back until flush() so a burst of frames goes out in one system call
+            if (m_txCount < batchSize)
+            {
+                NetSocket::Datagram& datagram = m_txDatagrams[m_txCount++];
+                Mem::memcpy(datagram.data, data, size);
+                datagram.size = size;
+                datagram.ipAddress = meta.ipAddress;
+                datagram.port = meta.port;
+                written = true;
 
-        if (state == NetSocket::State::Ok)
+                if (m_txCount == batchSize)
+                {
+                    flush();
+                }
+            }
+        }
+        else
         {
-            written = true;
-            txComplete(data, size);
+            flush();
+            NetSocket::State state = m_socket->write(data, &size, meta.ipAddress, meta.port);
+
+            if (state == NetSocket::State::Ok)
+            {
+                written = true;
+                m_txPacketCount++;
+                txComplete(data, size);
+            }
+            else if (state == NetSocket::State::Error)
+            {
+                m_portError = true;
+            }
         }
-        else if (state == NetSocket::State::Error)
+    }
+
+    return written;
+}
+//--------------------------------------------------------------------------------------------------
+void NetPort::flush()
+{
+    if (m_socket && m_txCount)
+    {
+        uint_t count = m_txCount;
+        NetSocket::State state = m_socket->writeMany(m_txDatagrams.data(), &count);
+
+        for (uint_t i = 0; i < count; i++)
+        {
+            txComplete(m_txDatagrams[i].data, m_txDatagrams[i].size);
+        }
+        m_txPacketCount += count;
+
+        // Anything the socket couldn't take yet is kept for the next flush
+        std::rotate(m_txDatagrams.begin(), m_txDatagrams.begin() + count, m_txDatagrams.begin() + m_txCount);
+        m_txCount -= count;
+
+        if (state == NetSocket::State::Error)
         {
             m_portError = true;
         }
     }
+}
+//--------------------------------------------------------------------------------------------------
+NetPort::IoStats NetPort::getIoStats() const
+{
+    IoStats stats = {};
 
-    return written;
+    if (m_socket)
+    {
+        stats.rxSyscalls = m_socket->rxSyscallCount;
+        stats.txSyscalls = m_socket->txSyscallCount;
+    }
+    stats.rxPackets = m_rxPacketCount;
+    stats.txPackets = m_txPacketCount;
+
+    return stats;
 }
 //--------------------------------------------------------------------------------------------------
 void NetPort::discoverIslDevices(uint16_t pid, uint16_t pn, uint16_t sn)
@@ -75,50 +159,74 @@ void NetPort::discoverIslDevices(uint16_t pid, uint16_t pn, uint16_t sn, uint32_
 //--------------------------------------------------------------------------------------------------
 bool_t NetPort::process()
 {
-    uint32_t fromAddress;
-    uint16_t remoteSrcPort;
-    uint8_t rxBuf[1522];
+    return SysPort::process();
+}
+//--------------------------------------------------------------------------------------------------
+void NetPort::receive()
+{
+    NetSocket::State state = NetSocket::State::Ok;
+    uint_t count = batchSize;
 
-    if (m_socket)
+    // A full batch means there may be more waiting
+    while (m_socket && state == NetSocket::State::Ok && count == batchSize)
     {
-        uint_t size = sizeof(rxBuf);
-        NetSocket::State state = m_socket->read(&rxBuf[0], &size, &fromAddress, &remoteSrcPort);
+        for (uint_t i = 0; i < batchSize; i++)
+        {
+            // A buffer still referenced by a device holding a frame can't be reused, so swap it for a free one
+            if (!m_rxBuffers[i] || m_rxBuffers[i].shared())
+            {
+                m_rxBuffers[i] = m_rxPool.get();
+                m_rxDatagrams[i].data = m_rxBuffers[i].data();
+            }
+            m_rxDatagrams[i].size = maxDatagramSize;
+        }
+
+        count = batchSize;
+        state = m_socket->readMany(m_rxDatagrams.data(), &count);
+        m_rxPacketCount += count;
 
-        while (state == NetSocket::State::Ok && size)
+        for (uint_t i = 0; i < count; i++)
         {
-            m_rxBytesCount += size;
-            ConstBuffer buf = { &rxBuf[0], size };
-            onRxData(*this, buf);
+            processDatagram(m_rxDatagrams[i], m_rxBuffers[i]);
+        }
+    }
 
-            if (m_codec)
-            {
-                uint_t bytesToProcess = size;
+    if (state == NetSocket::State::Error)
+    {
+        m_portError = true;
+    }
+}
+//--------------------------------------------------------------------------------------------------
+void NetPort::processDatagram(const NetSocket::Datagram& datagram, const BufferPool::Ref& buffer)
+{
+    ConnectionMeta meta(datagram.ipAddress, datagram.port);
 
-                while (bytesToProcess && m_codec)
-                {
-                    uint_t frameSize = m_codec->decode(&rxBuf[size - bytesToProcess], &bytesToProcess);
+    m_rxBytesCount += datagram.size;
+    ConstBuffer buf = { datagram.data, datagram.size };
+    onRxData(*this, buf);
 
-                    if (frameSize)
-                    {
-                        newFrameEvent(*this, &m_codec->m_frameBuf[0], frameSize, ConnectionMeta(fromAddress, remoteSrcPort), m_codec->type);
-                    }
-                }
-            }
-            else
-            {
-                newFrameEvent(*this, &rxBuf[0], size, ConnectionMeta(fromAddress, remoteSrcPort), Codec::Type::None);
-            }
+    m_rxBuffer = &buffer;
 
-            size = sizeof(rxBuf);
-            state = m_socket->read(&rxBuf[0], &size, &fromAddress, &remoteSrcPort);
-        }
+    if (m_codec)
+    {
+        uint_t bytesToProcess = datagram.size;
 
-        if (state == NetSocket::State::Error)
+        while (bytesToProcess && m_codec)
         {
-            m_portError = true;
+            const uint8_t* frame;
+            uint_t frameSize = m_codec->decodeInPlace(&datagram.data[datagram.size - bytesToProcess], &bytesToProcess, &frame);
+
+            if (frameSize)
+            {
+                newFrameEvent(*this, frame, frameSize, meta, m_codec->type);
+            }
         }
     }
+    else
+    {
+        newFrameEvent(*this, datagram.data, datagram.size, meta, Codec::Type::None);
+    }
 
-    return SysPort::process();
+    m_rxBuffer = nullptr;
 }
 //--------------------------------------------------------------------------------------------------
@@ -6,6 +6,7 @@
 #include "types/sdkTypes.h"
 #include "platform/netSocket.h"
 #include "comms/ports/sysPort.h"
+#include <vector>
 
 //--------------------------------------- Class Definition -----------------------------------------
 
@@ -16,11 +17,28 @@ namespace IslSdk
     public:
         static const uint16_t defaultPort = 33005;
 
+        struct IoStats
+        {
+            uint_t rxSyscalls;                         ///< The number of receive system calls.
+            uint_t rxPackets;                          ///< The number of datagrams received.
+            uint_t txSyscalls;                         ///< The number of send system calls.
+            uint_t txPackets;                          ///< The number of datagrams sent.
+        };
+
         NetPort(const std::string& name, bool_t isTcp, bool_t isServer, uint32_t ipAddress, uint16_t port);
         ~NetPort();
         void open() override;                          ///< Open the port.
         void close() override;                         ///< Close the port.
         bool_t process() override;
+        void receive() override;
+        void flush() override;
+
+        /**
+        * @brief Get the socket counters since the port was opened.
+        * rxSyscalls / rxPackets is the number of system calls per received packet, below 1 when datagrams are read in batches.
+        * @return The counters.
+        */
+        IoStats getIoStats() const;
 
         /**
         * @brief Write data to the port.
@@ -51,11 +69,24 @@ namespace IslSdk
         void discoverIslDevices(uint16_t pid, uint16_t pn, uint16_t sn, uint32_t ipAddress, uint16_t port, uint_t timeoutMs);
 
     private:
+        static const uint_t batchSize = 32;             ///< Datagrams read or sent per system call where the platform supports it.
+        static const uint_t maxDatagramSize = 1522;
+
         std::unique_ptr<NetSocket> m_socket;
         bool_t m_isTcp;
         bool_t m_isServer;
         uint32_t m_ipAddress;
         uint16_t m_port;
+        BufferPool m_rxPool;
+        std::vector<BufferPool::Ref> m_rxBuffers;      ///< The pooled buffer each of m_rxDatagrams reads into.
+        std::vector<NetSocket::Datagram> m_rxDatagrams;
+        std::vector<uint8_t> m_txBuf;
+        std::vector<NetSocket::Datagram> m_txDatagrams;
+        uint_t m_txCount;
+        uint_t m_rxPacketCount;
+        uint_t m_txPacketCount;
+
+        void processDatagram(const NetSocket::Datagram& datagram, const BufferPool::Ref& buffer);
     };
 }
 //--------------------------------------------------------------------------------------------------
@@ -25,6 +25,8 @@ PoweredComPort::~PoweredComPort()
 //--------------------------------------------------------------------------------------------------
 void PoweredComPort::open()
 {
+    std::lock_guard<std::recursive_mutex> lock(commsMutex);
+
     if (!m_isOpen && m_powerOnTimer == 0)
     {   
         m_active = true;
@@ -55,6 +57,8 @@ void PoweredComPort::doOpen()
 //--------------------------------------------------------------------------------------------------
 void PoweredComPort::close()
 {
+    std::lock_guard<std::recursive_mutex> lock(commsMutex);
+
     if (m_isOpen)
     {
         if (m_pcpServices)
@@ -170,6 +174,11 @@ bool_t PoweredComPort::process()
         }
 	}
 
+    return SysPort::process();
+}
+//--------------------------------------------------------------------------------------------------
+void PoweredComPort::receive()
+{
     while (RxBuf* buf = reinterpret_cast<RxBuf*>(m_rx.peekNextItem()))
     {
         m_rxBytesCount += buf->size;
@@ -182,11 +191,12 @@ bool_t PoweredComPort::process()
 
             while (bytesToProcess && m_codec)
             {
-                uint_t frameSize = m_codec->decode(&buf->data[buf->size - bytesToProcess], &bytesToProcess);
+                const uint8_t* frame;
+                uint_t frameSize = m_codec->decodeInPlace(&buf->data[buf->size - bytesToProcess], &bytesToProcess, &frame);
 
                 if (frameSize)
                 {
-                    newFrameEvent(*this, &m_codec->m_frameBuf[0], frameSize, ConnectionMeta(buf->baudrate), m_codec->type);
+                    newFrameEvent(*this, frame, frameSize, ConnectionMeta(buf->baudrate), m_codec->type);
                 }
             }
         }
@@ -197,8 +207,6 @@ bool_t PoweredComPort::process()
 
         m_rx.pop();
     }
-
-    return SysPort::process();
 }
 //--------------------------------------------------------------------------------------------------
 void PoweredComPort::rxData(const uint8_t* data, uint_t size, uint32_t baudrate)
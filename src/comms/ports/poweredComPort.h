@@ -23,6 +23,7 @@ namespace IslSdk
         void open() override;           ///< Open the port.
         void close() override;          ///< Close the port.
         bool_t process() override;
+        void receive() override;
 
         /**
         * @brief Configure the serial port.
@@ -40,6 +40,8 @@ SolPort::~SolPort()
 //--------------------------------------------------------------------------------------------------
 void SolPort::open()
 {
+    std::lock_guard<std::recursive_mutex> lock(commsMutex);
+
     if (!m_isOpen)
     {
         m_socket = std::make_unique<NetSocket>(m_isTcp, false, m_ipAddress, m_port);
@@ -53,6 +55,8 @@ void SolPort::open()
 //--------------------------------------------------------------------------------------------------
 void SolPort::close()
 {
+    std::lock_guard<std::recursive_mutex> lock(commsMutex);
+
     m_tcpTimeout = 0;
     m_iac = false;
     m_telnetModes.binary = false;
@@ -147,75 +151,101 @@ bool_t SolPort::write(const uint8_t* data, uint_t size, const ConnectionMeta& me
 
     if (!m_lock && m_socket)
     {
-        if (meta.baudrate && m_baudrate != meta.baudrate)
+        if (m_codec && m_codec->type == Codec::Type::Cobs && data && size)
         {
-            setSerial(meta.baudrate, m_dataBits, m_parity, m_stopBits);
+            written = coalesceTx(data, size, meta);
         }
-
-        if (m_codec && data && size)
+        else
         {
-            size = m_codec->encode(data, size, &m_txBuf[0], sizeof(m_txBuf));
-            data = &m_txBuf[0];
+            flush();
+
+            if (m_codec && data && size)
+            {
+                size = m_codec->encode(data, size, &m_txBuf[0], sizeof(m_txBuf));
+                data = &m_txBuf[0];
+            }
+            written = writeSocket(data, size, meta);
         }
+    }
 
-        if (m_useTelnet && data)
-        {
-            uint_t byteCount = 0;
+    return written;
+}
+//--------------------------------------------------------------------------------------------------
+void SolPort::flush()
+{
+    if (m_socket && !m_txFrames.empty() && writeSocket(&m_txFrames[0], m_txFrames.size(), m_txFramesMeta))
+    {
+        m_txFrames.clear();
+    }
+}
+//--------------------------------------------------------------------------------------------------
+bool_t SolPort::writeSocket(const uint8_t* data, uint_t size, const ConnectionMeta& meta)
+{
+    bool_t written = false;
 
-            for (uint_t i = 0; i < size; i++)
-            {
-                if (*data == 0xff)
-                {
-                    m_rxBuf[byteCount++] = 0xff;
-                }
+    if (meta.baudrate && m_baudrate != meta.baudrate)
+    {
+        setSerial(meta.baudrate, m_dataBits, m_parity, m_stopBits);
+    }
+
+    if (m_useTelnet && data)
+    {
+        uint_t byteCount = 0;
+        m_telnetTxBuf.resize(size * 2);
 
-                m_rxBuf[byteCount++] = *data++;
+        for (uint_t i = 0; i < size; i++)
+        {
+            if (*data == 0xff)
+            {
+                m_telnetTxBuf[byteCount++] = 0xff;
             }
 
-            size = byteCount;
-            data = &m_rxBuf[0];
+            m_telnetTxBuf[byteCount++] = *data++;
         }
 
-        uint_t bytesSent = 0;
+        size = byteCount;
+        data = &m_telnetTxBuf[0];
+    }
+
+    uint_t bytesSent = 0;
 
-        if (data)
+    if (data)
+    {
+        while (bytesSent < size)
         {
-            while (bytesSent < size)
+            uint_t amountToSend = (size - bytesSent) > 1200 ? 1200 : (size - bytesSent);
+            NetSocket::State state = m_socket->write(&data[bytesSent], &amountToSend, m_ipAddress, m_port);
+            if (state == NetSocket::State::Ok)
             {
-                uint_t amountToSend = (size - bytesSent) > 1200 ? 1200 : (size - bytesSent);
-                NetSocket::State state = m_socket->write(&data[bytesSent], &amountToSend, m_ipAddress, m_port);
-                if (state == NetSocket::State::Ok)
+                bytesSent += amountToSend;
+            }
+            else
+            {
+                if (state == NetSocket::State::Error)
                 {
-                    bytesSent += amountToSend;
+                    m_portError = true;
                 }
-                else
+                else if (state == NetSocket::State::TcpWating)
                 {
-                    if (state == NetSocket::State::Error)
+                    if (m_tcpTimeout == 0)
                     {
-                        m_portError = true;
+                        m_tcpTimeout = 5000 + Time::getTimeMs();
                     }
-                    else if (state == NetSocket::State::TcpWating)
+                    else if (Time::getTimeMs() >= m_tcpTimeout)
                     {
-                        if (m_tcpTimeout == 0)
-                        {
-                            m_tcpTimeout = 5000 + Time::getTimeMs();
-                        }
-                        else if (Time::getTimeMs() >= m_tcpTimeout)
-                        {
-                            m_tcpTimeout = 0;
-                            m_portError = true;
-                        }
+                        m_tcpTimeout = 0;
+                        m_portError = true;
                     }
-                    break;
                 }
+                break;
             }
         }
+    }
 
-        if (bytesSent == size)
-        {
-            written = true;
-            txComplete(data, size);
-        }
+    if (bytesSent == size)
+    {
+        written = true;
+        txComplete(data, size);
     }
 
     return written;
@@ -248,6 +278,11 @@ void SolPort::discoverNmeaDevices(uint32_t baudrate, uint_t timeoutMs)
 }
 //--------------------------------------------------------------------------------------------------
 bool_t SolPort::process()
+{
+    return SysPort::process();
+}
+//--------------------------------------------------------------------------------------------------
+void SolPort::receive()
 {
     uint32_t fromAddress;
     uint16_t remoteSrcPort;
@@ -324,11 +359,12 @@ bool_t SolPort::process()
 
                 while (bytesToProcess && m_codec)
                 {
-                    uint_t frameSize = m_codec->decode(&m_rxBuf[size - bytesToProcess], &bytesToProcess);
+                    const uint8_t* frame;
+                    uint_t frameSize = m_codec->decodeInPlace(&m_rxBuf[size - bytesToProcess], &bytesToProcess, &frame);
 
                     if (frameSize)
                     {
-                        newFrameEvent(*this, &m_codec->m_frameBuf[0], frameSize, ConnectionMeta(fromAddress, remoteSrcPort), m_codec->type);
+                        newFrameEvent(*this, frame, frameSize, ConnectionMeta(fromAddress, remoteSrcPort), m_codec->type);
                     }
                 }
             }
@@ -350,8 +386,6 @@ bool_t SolPort::process()
             m_portError = true;
         }
     }
-
-    return SysPort::process();
 }
 //--------------------------------------------------------------------------------------------------
 void SolPort::processTelnetCmd(uint8_t cmd, uint8_t* buf, uint_t size)
@@ -7,6 +7,7 @@
 #include "platform/uart.h"
 #include "platform/netSocket.h"
 #include "comms/ports/sysPort.h"
+#include <vector>
 #include <array>
 
 //--------------------------------------- Class Definition -----------------------------------------
@@ -23,6 +24,8 @@ namespace IslSdk
         void open() override;           ///< Open the port.
         void close() override;          ///< Close the port.
         bool_t process() override;
+        void receive() override;
+        void flush() override;
 
         /**
         * @brief Configure the port.
@@ -85,6 +88,7 @@ namespace IslSdk
 
     private:
         void processTelnetCmd(uint8_t cmd, uint8_t* buf, uint_t size);
+        bool_t writeSocket(const uint8_t* data, uint_t size, const ConnectionMeta& meta);
         std::unique_ptr<NetSocket> m_socket;
         bool_t m_isTcp;
         bool_t m_useTelnet;
@@ -106,6 +110,7 @@ namespace IslSdk
         uint8_t m_rxBuf[1522];
         uint8_t m_telnetCmd[32];
         uint8_t m_txBuf[2048];
+        std::vector<uint8_t> m_telnetTxBuf;
     };
 }
 //--------------------------------------------------------------------------------------------------
@@ -10,6 +10,10 @@
 
 using namespace IslSdk;
 
+const uint_t maxTxFramesSize = 4096;
+
+std::recursive_mutex SysPort::commsMutex;
+
 //--------------------------------------------------------------------------------------------------
 SysPort::SysPort(const std::string& name, ClassType classType, Type type, uint_t discoveryTimeoutMs) :
     name(name),
@@ -17,6 +21,8 @@ SysPort::SysPort(const std::string& name, ClassType classType, Type type, uint_t
     type(type),
     discoveryTimeoutMs(discoveryTimeoutMs),
     id(static_cast<uint32_t>(Math::randomNum(1, Math::maxUint32))),
+    m_rxBuffer(nullptr),
+    m_txFramesMeta(0),
     m_isOpen(false),
     m_active(false),
     m_portError(false),
@@ -27,6 +33,7 @@ SysPort::SysPort(const std::string& name, ClassType classType, Type type, uint_t
     m_badRxPacketCount(0),
     m_sdkCanClose(false)
 {
+    m_txFrames.reserve(maxTxFramesSize);
 }
 //--------------------------------------------------------------------------------------------------
 SysPort::~SysPort()
@@ -50,6 +57,7 @@ void SysPort::close()
         m_rxBytesCount = 0;
         m_badRxPacketCount = 0;
         m_sdkCanClose = false;
+        m_txFrames.clear();
         m_codec.reset();
         debugLog("SysPort", "%s closed", name.c_str());
         onClose(*this);
@@ -79,6 +87,8 @@ bool_t SysPort::isBlocked()
 //--------------------------------------------------------------------------------------------------
 void SysPort::stopDiscovery()
 {
+    std::lock_guard<std::recursive_mutex> lock(commsMutex);
+
     if (m_autoDiscoverer)
     {
         m_autoDiscoverer->stop();
@@ -111,6 +121,35 @@ void SysPort::txComplete(const uint8_t* data, uint_t size)
     onTxData(*this, buf);
 }
 //--------------------------------------------------------------------------------------------------
+bool_t SysPort::coalesceTx(const uint8_t* data, uint_t size, const ConnectionMeta& meta)
+{
+    // COBS frames are delimited so frames written in the same cycle can go out back to back in one write
+    uint_t maxSize = size + 3 + (size / 254);
+
+    if (!m_txFrames.empty() && (m_txFramesMeta.isDifferent(meta) || m_txFrames.size() + maxSize > maxTxFramesSize))
+    {
+        flush();
+    }
+
+    // If the flush couldn't send the held frames they keep their own meta, so don't mix in frames for another destination
+    if (!m_txFrames.empty() && (m_txFramesMeta.isDifferent(meta) || m_txFrames.size() + maxSize > maxTxFramesSize))
+    {
+        return false;
+    }
+
+    if (m_txFrames.empty())
+    {
+        m_txFramesMeta = meta;
+    }
+
+    uint_t offset = m_txFrames.size();
+    m_txFrames.resize(offset + maxSize);
+    size = m_codec->encode(data, size, &m_txFrames[offset], maxSize);
+    m_txFrames.resize(offset + size);
+
+    return size != 0;
+}
+//--------------------------------------------------------------------------------------------------
 const std::unique_ptr<AutoDiscovery>& SysPort::getDiscoverer()
 {
     return m_autoDiscoverer;
@@ -118,6 +157,8 @@ const std::unique_ptr<AutoDiscovery>& SysPort::getDiscoverer()
 //--------------------------------------------------------------------------------------------------
 void SysPort::discoverIslDevices(uint16_t pid, uint16_t pn, uint16_t sn, const ConnectionMeta& meta, uint_t timeoutMs, uint_t count)
 {
+    std::lock_guard<std::recursive_mutex> lock(commsMutex);
+
     if (type != Type::Net)
     {
         if (m_codec == nullptr || m_codec->type != Codec::Type::Cobs)
@@ -146,6 +187,8 @@ void SysPort::discoverIslDevices(uint16_t pid, uint16_t pn, uint16_t sn, const C
 //--------------------------------------------------------------------------------------------------
 void SysPort::nemaDiscovery(const ConnectionMeta& meta, uint_t timeoutMs)
 {
+    std::lock_guard<std::recursive_mutex> lock(commsMutex);
+
     if (m_codec == nullptr || m_codec->type != Codec::Type::Nmea)
     {
         m_codec = std::make_unique<Nmea>(512);
@@ -6,11 +6,14 @@
 #include "types/sdkTypes.h"
 #include "comms/discovery/autoDiscovery.h"
 #include "types/sigSlot.h"
+#include "types/bufferPool.h"
 #include "comms/protocols/codec.h"
 #include "comms/connectionMeta.h"
 #include <list>
 #include <string>
 #include <memory>
+#include <mutex>
+#include <vector>
 
 //--------------------------------------- Class Definition -----------------------------------------
 
@@ -43,6 +46,9 @@ namespace IslSdk
         const bool_t& active = m_active;                        ///< True if the port is open or in the process on opening / closing.
         uint_t deviceCount;                                     ///< The number of SDK devices using the port.
 
+        /// Serialises the ports, devices and their protocol stack between the application and the SDK's I/O thread, see Sdk::startIoThread().
+        static std::recursive_mutex commsMutex;
+
         /**
         * @brief A subscribable event for port errors
         * @param port SysPort& The port that triggered the event.
@@ -136,11 +142,24 @@ namespace IslSdk
         virtual void discoverNmeaDevices() {};
         void nemaDiscovery(const ConnectionMeta& meta, uint_t timeoutMs);
 
+        /**
+        * @brief The pooled buffer holding the frame being passed up from the port.
+        * Only valid during the frame event. Keeping a copy of the reference keeps the frame data valid without copying it.
+        * @return The buffer, or nullptr if the port doesn't receive into pooled buffers.
+        */
+        const BufferPool::Ref* rxBuffer() const { return m_rxBuffer; }
+
     protected:
         virtual bool_t process();
+        virtual void receive() {}                               ///< Reads and decodes received data, called before process() or by the SDK's I/O thread.
+        virtual void flush() {}                                 ///< Sends writes held back so they can go out together.
         void txComplete(const uint8_t* data, uint_t size);
+        bool_t coalesceTx(const uint8_t* data, uint_t size, const ConnectionMeta& meta);
         Callback<SysPort&, const uint8_t*, uint_t, const ConnectionMeta&, Codec::Type> newFrameEvent;
         std::unique_ptr<Codec> m_codec;
+        const BufferPool::Ref* m_rxBuffer;                      ///< Set while newFrameEvent is called with a frame in a pooled buffer.
+        std::vector<uint8_t> m_txFrames;                        ///< COBS encoded frames waiting for flush() to send them in one write.
+        ConnectionMeta m_txFramesMeta;
         bool_t m_portError;
         bool_t m_isOpen;
         bool_t m_active;
@@ -36,6 +36,8 @@ UartPort::~UartPort()
 //--------------------------------------------------------------------------------------------------
 void UartPort::open()
 {
+    std::lock_guard<std::recursive_mutex> lock(commsMutex);
+
     if (!m_isOpen && !m_threadOpen.joinable())
     {
         m_rx.reset();
@@ -48,6 +50,8 @@ void UartPort::open()
 //--------------------------------------------------------------------------------------------------
 void UartPort::close()
 {
+    std::lock_guard<std::recursive_mutex> lock(commsMutex);
+
     if (m_isOpen && !m_threadClose.joinable())
     {
         m_threadClose = std::thread(&SerialPort::close, &m_serialPort);
@@ -67,40 +71,19 @@ bool_t UartPort::write(const uint8_t* data, uint_t size, const ConnectionMeta& m
     {
         if (data && size)
         {
-            uint_t bufSize = size;
-
-            if (m_codec)
+            if (m_codec && m_codec->type == Codec::Type::Cobs)
             {
-                bufSize += (size / 254) + 8;
+                written = coalesceTx(data, size, meta);
             }
-
-            TxRxBuf* buf = (TxRxBuf*)m_tx.newItem(sizeof(TxRxBuf) + bufSize);
-            if (buf)
+            else
             {
-                buf->data = reinterpret_cast<uint8_t*>(buf) + sizeof(TxRxBuf);
-                if (m_codec)
-                {
-                    size = m_codec->encode(data, size, buf->data, bufSize);
-                    m_tx.reduceSize(sizeof(TxRxBuf) + size);
-                }
-                else
-                {
-				    Mem::memcpy(buf->data, data, size);
-                }
-                buf->size = size;
-                buf->baudrate = meta.baudrate;
-                m_tx.push();
-                written = true;
-                m_serialPort.write(buf->data, buf->size, meta.baudrate);
+                flush();
+                written = writeSerial(data, size, meta.baudrate, m_codec != nullptr);
             }
-			else
-			{
-				debugLog("UartPort", "%s tx buffer full. Discarding packet", name.c_str());
-				return false;
-			}
         }
         else
         {
+            flush();
             written = m_serialPort.write(data, size, meta.baudrate);
         }
     }
@@ -108,6 +91,42 @@ bool_t UartPort::write(const uint8_t* data, uint_t size, const ConnectionMeta& m
     return written;
 }
 //--------------------------------------------------------------------------------------------------
+void UartPort::flush()
+{
+    if (!m_txFrames.empty() && writeSerial(&m_txFrames[0], m_txFrames.size(), m_txFramesMeta.baudrate, false))
+    {
+        m_txFrames.clear();
+    }
+}
+//--------------------------------------------------------------------------------------------------
+bool_t UartPort::writeSerial(const uint8_t* data, uint_t size, uint32_t baudrate, bool_t encode)
+{
+    uint_t bufSize = encode ? size + (size / 254) + 8 : size;
+    TxRxBuf* buf = (TxRxBuf*)m_tx.newItem(sizeof(TxRxBuf) + bufSize);
+
+    if (buf)
+    {
+        buf->data = reinterpret_cast<uint8_t*>(buf) + sizeof(TxRxBuf);
+        if (encode)
+        {
+            size = m_codec->encode(data, size, buf->data, bufSize);
+            m_tx.reduceSize(sizeof(TxRxBuf) + size);
+        }
+        else
+        {
+            Mem::memcpy(buf->data, data, size);
+        }
+        buf->size = size;
+        buf->baudrate = baudrate;
+        m_tx.push();
+        m_serialPort.write(buf->data, buf->size, baudrate);
+        return true;
+    }
+
+    debugLog("UartPort", "%s tx buffer full. Discarding packet", name.c_str());
+    return false;
+}
+//--------------------------------------------------------------------------------------------------
 void UartPort::discoverIslDevices(uint16_t pid, uint16_t pn, uint16_t sn)
 {
     for (uint_t i = 0; i < defaultBaudrates.size(); i++)
@@ -136,10 +155,6 @@ void UartPort::discoverNmeaDevices(uint32_t baudrate, uint_t timeoutMs)
 //--------------------------------------------------------------------------------------------------
 bool_t UartPort::process()
 {
-    TxRxBuf* buf;
-    uint_t bytesToProcess;
-    uint_t frameSize;
-    
     if (m_eventOpen)
     {
         m_eventOpen = false;
@@ -163,6 +178,16 @@ bool_t UartPort::process()
         SysPort::close();
     }
 
+    return SysPort::process();
+}
+//--------------------------------------------------------------------------------------------------
+void UartPort::receive()
+{
+    TxRxBuf* buf;
+    uint_t bytesToProcess;
+    uint_t frameSize;
+    const uint8_t* frame;
+
     while (buf = reinterpret_cast<TxRxBuf*>(m_rx.peekNextItem()))
     {
         m_rxBytesCount += buf->size;
@@ -175,11 +200,11 @@ bool_t UartPort::process()
 
             while (bytesToProcess && m_codec)
             {
-                frameSize = m_codec->decode(&buf->data[buf->size - bytesToProcess], &bytesToProcess);
+                frameSize = m_codec->decodeInPlace(&buf->data[buf->size - bytesToProcess], &bytesToProcess, &frame);
 
                 if (frameSize)
                 {
-                    newFrameEvent(*this, &m_codec->m_frameBuf[0], frameSize, ConnectionMeta(buf->baudrate), m_codec->type);
+                    newFrameEvent(*this, frame, frameSize, ConnectionMeta(buf->baudrate), m_codec->type);
                 }
             }
         }
@@ -190,8 +215,6 @@ bool_t UartPort::process()
 
         m_rx.pop();
     }
-
-    return SysPort::process();
 }
 //--------------------------------------------------------------------------------------------------
 void UartPort::rxDataCallback(const uint8_t* data, uint_t size, uint32_t baudrate)
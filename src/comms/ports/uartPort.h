@@ -33,6 +33,8 @@ namespace IslSdk
         void open() override;           ///< Open the port.
         void close() override;          ///< Close the port.
         bool_t process() override;
+        void receive() override;
+        void flush() override;
 
         /**
         * @brief Configure the port.
@@ -101,6 +103,7 @@ namespace IslSdk
         std::thread m_threadOpen;
         std::thread m_threadClose;
 
+        bool_t writeSerial(const uint8_t* data, uint_t size, uint32_t baudrate, bool_t encode);
         void rxDataCallback(const uint8_t* data, uint_t size, uint32_t baudrate);
         void txCompeteCallback(const uint8_t* data, uint_t bytesWritten);
         void uartEvent(Uart::Events event);
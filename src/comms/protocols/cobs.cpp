@@ -2,9 +2,86 @@
 
 #include "comms/protocols/cobs.h"
 #include "platform/debug.h"
+#include "platform/mem.h"
+#include "maths/maths.h"
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define COBS_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#define COBS_NEON
+#include <arm_neon.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 
 using namespace IslSdk;
 
+//--------------------------------------------------------------------------------------------------
+static inline uint_t firstSetBit(uint64_t mask)
+{
+#if defined(_MSC_VER)
+    unsigned long idx;
+    _BitScanForward64(&idx, mask);
+    return idx;
+#else
+    return static_cast<uint_t>(__builtin_ctzll(mask));
+#endif
+}
+//--------------------------------------------------------------------------------------------------
+#if defined(COBS_SSE2)
+static const uint_t maskBits = 1;                       // Bits per byte in a zeroMask()
+
+static inline uint64_t zeroMask(const uint8_t* data)
+{
+    __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+    return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, _mm_setzero_si128())));
+}
+#elif defined(COBS_NEON)
+static const uint_t maskBits = 4;
+
+static inline uint64_t zeroMask(const uint8_t* data)
+{
+    uint8x16_t eq = vceqq_u8(vld1q_u8(data), vdupq_n_u8(0));
+    return vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(eq), 4)), 0);
+}
+#else
+static const uint_t maskBits = 1;
+
+static inline uint64_t zeroMask(const uint8_t* data)
+{
+    uint64_t mask = 0;
+    for (uint_t i = 0; i < 16; i++)
+    {
+        mask |= static_cast<uint64_t>(data[i] == 0) << i;
+    }
+    return mask;
+}
+#endif
+//--------------------------------------------------------------------------------------------------
+/// Returns the index of the first zero byte in data, or size if there isn't one.
+static inline uint_t zeroRun(const uint8_t* data, uint_t size)
+{
+    uint_t i = 0;
+
+    for (; i + 16 <= size; i += 16)
+    {
+        uint64_t mask = zeroMask(&data[i]);
+        if (mask)
+        {
+            return i + firstSetBit(mask) / maskBits;
+        }
+    }
+
+    while (i < size && data[i])
+    {
+        i++;
+    }
+    return i;
+}
 //--------------------------------------------------------------------------------------------------
 Cobs::Cobs(uint_t mtu) : Codec(mtu, Type::Cobs)
 {
@@ -20,10 +97,10 @@ Cobs::~Cobs()
 //--------------------------------------------------------------------------------------------------
 uint_t Cobs::encode(const uint8_t* data, uint_t size, uint8_t* buf, uint_t bufSize)
 {
-    uint8_t* frame;
-    uint8_t* idx;
-    uint8_t blockLength;
+    uint8_t* frame;                     // Where data[0] goes, moves on by one each time a block is split
+    uint8_t* code;                      // The length byte of the current block
     uint_t maxSize;
+    uint_t i = 0;
 
     maxSize = size + 3 + (size / 254);
 
@@ -33,52 +110,102 @@ uint_t Cobs::encode(const uint8_t* data, uint_t size, uint8_t* buf, uint_t bufSi
         return 0;
     }
 
-    frame = buf;
-    blockLength = 1;
-    *frame++ = 0;
-    idx = frame;
-    frame++;
+    buf[0] = 0;
+    code = &buf[1];
+    frame = &buf[2];
 
-    while (size)
+    // Data is copied a chunk at a time, then each zero is overwritten with the length of the block it ends
+    while (i < size)
     {
-        if (*data == 0)                 // Data is 0 so must be removed
+        uint_t n = Math::min<uint_t>(size - i, 16);
+        uint_t next = i + n;
+        uint64_t mask = 0;
+
+        if (n == 16)
         {
-            *idx = blockLength;
-            blockLength = 1;
-            idx = frame;
-            frame++;
+            Mem::memcpy(&frame[i], &data[i], 16);
+            mask = zeroMask(&data[i]);
         }
         else
         {
-            *frame++ = *data;
-            blockLength++;              // Count the size of this block
-            if (blockLength == 0xff)    // Reached max block size
+            for (uint_t k = 0; k < n; k++)
+            {
+                frame[i + k] = data[i + k];
+                mask |= static_cast<uint64_t>(data[i + k] == 0) << (k * maskBits);
+            }
+        }
+
+        while (true)
+        {
+            uint_t zero = mask ? i + firstSetBit(mask) / maskBits : next;
+
+            if (&frame[zero] - code >= 0xff)    // Reached max block size, so insert a length byte and redo the rest of the chunk after it
             {
-                *idx = blockLength;
-                blockLength = 1;
-                idx = frame;
+                next = static_cast<uint_t>(code + 0xff - frame);
+                *code = 0xff;
+                code = &frame[next];
                 frame++;
+                break;
             }
+
+            if (!mask)
+            {
+                break;
+            }
+
+            *code = static_cast<uint8_t>(&frame[zero] - code);
+            code = &frame[zero];
+            mask &= ~(((static_cast<uint64_t>(1) << maskBits) - 1) << ((zero - i) * maskBits));
         }
-        data++;
-        size--;
+        i = next;
     }
 
-    *idx = blockLength;
-    *frame++ = 0;
+    *code = static_cast<uint8_t>(&frame[size] - code);
+    frame[size] = 0;
 
-    return (uint_t)(frame - buf);
+    return (uint_t)(&frame[size + 1] - buf);
 }
 //--------------------------------------------------------------------------------------------------
 uint_t Cobs::decode(const uint8_t* data, uint_t* size)
 {
     uint_t frameLength;
+    const uint8_t* end = data + *size;
 
-    while (*size)
+    while (data != end)
     {
-        (*size)--;
+        if (m_waitForSof)
+        {
+            data += zeroRun(data, static_cast<uint_t>(end - data));
+            if (data == end)
+            {
+                break;
+            }
+        }
+        else if (m_blockCount >= 32 && *data != 0)
+        {
+            // Long block, copy up to its end or a zero which ends the frame early
+            uint_t run = zeroRun(data, Math::min<uint_t>(m_blockCount, static_cast<uint_t>(end - data)));
+            Mem::memcpy(&m_frameBuf[m_size], data, run);
+            m_size += run;
+            m_blockCount -= run;
+            data += run;
+            continue;
+        }
+        else if (*data != 0 && end - data >= 16 && m_size + 16 <= m_frameBuf.size())
+        {
+            data += decodeChunk(data);
+            continue;
+        }
+        else if (m_blockCount && *data != 0)
+        {
+            m_frameBuf[m_size++] = *data++;
+            m_blockCount--;
+            continue;
+        }
+
         if (*data == 0)                 // Start or end of frame marker
         {
+            data++;
             m_waitForSof = false;
             if (m_size && m_blockCount == 0)
             {
@@ -86,6 +213,7 @@ uint_t Cobs::decode(const uint8_t* data, uint_t* size)
                 m_size = 0;
                 m_blockCount = 0;
                 m_blockSize = 0xff;
+                *size = static_cast<uint_t>(end - data);
                 return frameLength;
             }
             else if (m_size)
@@ -97,31 +225,163 @@ uint_t Cobs::decode(const uint8_t* data, uint_t* size)
             m_blockCount = 0;
             m_blockSize = 0xff;
         }
-        else if (!m_waitForSof)
+        else
         {
-            if (m_blockCount)
+            if (m_blockSize != 0xff)
             {
-                m_frameBuf[m_size++] = *data;
+                m_frameBuf[m_size++] = 0;
             }
-            else
+            m_blockSize = *data++;
+            m_blockCount = m_blockSize - 1;
+
+            if ((m_size + m_blockSize) > m_frameBuf.size())
             {
-                if (m_blockSize != 0xff)
+                m_size = 0;
+                m_waitForSof = true;
+                debugLog("Cobs", "Cobs rx frame exceeds buffer size, discarding data");
+            }
+        }
+    }
+
+    *size = 0;
+    return 0;
+}
+//--------------------------------------------------------------------------------------------------
+uint_t Cobs::decodeChunk(const uint8_t* data)
+{
+    uint64_t zeros = zeroMask(data);
+    uint_t frameEnd = zeros ? firstSetBit(zeros) / maskBits : 16;
+    uint8_t* out = &m_frameBuf[m_size];         // Where data[0] goes, moves back one for each length byte that is removed
+    uint_t idx = m_blockCount;                  // The next length byte
+
+    // Copy all 16 bytes, then fix up the length bytes within them
+    Mem::memcpy(out, data, 16);
+
+    while (idx < frameEnd)
+    {
+        if (m_blockSize != 0xff)
+        {
+            out[idx] = 0;
+        }
+        else
+        {
+            out--;
+            std::memmove(&out[idx + 1], &out[idx + 2], 15 - idx);
+        }
+
+        m_blockSize = data[idx];
+
+        if (static_cast<uint_t>(&out[idx + 1] - &m_frameBuf[0]) + m_blockSize > m_frameBuf.size())
+        {
+            m_size = 0;
+            m_blockCount = 0;
+            m_waitForSof = true;
+            debugLog("Cobs", "Cobs rx frame exceeds buffer size, discarding data");
+            return idx + 1;
+        }
+        idx += m_blockSize;
+    }
+
+    m_blockCount = idx - frameEnd;
+    m_size = static_cast<uint_t>(&out[frameEnd] - &m_frameBuf[0]);
+
+    return frameEnd;
+}
+//--------------------------------------------------------------------------------------------------
+uint_t Cobs::decodeInPlace(uint8_t* data, uint_t* size, const uint8_t** frame)
+{
+    // Only between frames, as a frame that began in an earlier buffer is already in m_frameBuf
+    if (!m_waitForSof && m_size == 0 && m_blockCount == 0 && m_blockSize == 0xff)
+    {
+        // Extra delimiters, such as the start of frame marker, don't change the state
+        while (*size && *data == 0)
+        {
+            data++;
+            (*size)--;
+        }
+
+        if (*size == 0)
+        {
+            return 0;
+        }
+
+        uint_t length = zeroRun(data, *size);
+
+        // A frame no longer than m_frameBuf can't overflow it, so the only error left is an incomplete last block
+        if (length < *size && length <= m_frameBuf.size())
+        {
+            uint_t shift = 0;                       // How far each byte moves back, one for each length byte removed
+            uint_t idx = 0;                         // The next length byte
+            uint_t blockSize = 0xff;
+            uint_t i = 0;
+            uint8_t chunk[16];
+
+            // As decodeChunk(), but writing behind the bytes still to be read
+            while (i + 16 <= length)
+            {
+                if (idx >= i + 32)
                 {
-                    m_frameBuf[m_size++] = 0;
+                    // Long block, move it in one go
+                    uint_t run = (Math::min<uint_t>(idx, length) - i) & ~static_cast<uint_t>(15);
+                    std::memmove(&data[i - shift], &data[i], run);
+                    i += run;
+                    continue;
                 }
-                m_blockSize = m_blockCount = *data;
 
-                if ((m_size + m_blockSize) > m_frameBuf.size())
+                Mem::memcpy(&chunk[0], &data[i], 16);
+                Mem::memcpy(&data[i - shift], &chunk[0], 16);
+
+                while (idx < i + 16)
                 {
-                    m_size = 0;
-                    m_waitForSof = true;
-                    debugLog("Cobs", "Cobs rx frame exceeds buffer size, discarding data");
+                    if (blockSize != 0xff)
+                    {
+                        data[idx - shift] = 0;
+                    }
+                    else
+                    {
+                        shift++;
+                        std::memmove(&data[idx + 1 - shift], &data[idx + 2 - shift], i + 15 - idx);
+                    }
+                    blockSize = chunk[idx - i];
+                    idx += blockSize;
                 }
+                i += 16;
             }
-            m_blockCount--;
+
+            for (; i < length; i++)
+            {
+                if (i == idx)
+                {
+                    if (blockSize != 0xff)
+                    {
+                        data[i - shift] = 0;
+                    }
+                    else
+                    {
+                        shift++;
+                    }
+                    blockSize = data[i];
+                    idx += blockSize;
+                }
+                else
+                {
+                    data[i - shift] = data[i];
+                }
+            }
+
+            *size -= length + 1;
+            *frame = data;
+
+            if (idx != length)
+            {
+                debugLog("Cobs", "Cobs rx frame incomplete, discarding data");
+                return 0;
+            }
+            return length - shift;
         }
-        data++;
     }
-    return 0;
+
+    *frame = &m_frameBuf[0];
+    return decode(data, size);
 }
 //--------------------------------------------------------------------------------------------------
@@ -17,12 +17,15 @@ namespace IslSdk
         ~Cobs();
         uint_t encode(const uint8_t* data, uint_t size, uint8_t* buf, uint_t bufSize) override;
         uint_t decode(const uint8_t* data, uint_t* size) override;
+        uint_t decodeInPlace(uint8_t* data, uint_t* size, const uint8_t** frame) override;
 
     private:
         uint_t m_blockSize;
         uint_t m_blockCount;
         uint_t m_size;
         bool_t m_waitForSof;
+
+        uint_t decodeChunk(const uint8_t* data);
     };
 }
 //--------------------------------------------------------------------------------------------------
@@ -13,3 +13,9 @@ Codec::~Codec()
 {
 }
 //--------------------------------------------------------------------------------------------------
+uint_t Codec::decodeInPlace(uint8_t* data, uint_t* size, const uint8_t** frame)
+{
+    *frame = &m_frameBuf[0];
+    return decode(data, size);
+}
+//--------------------------------------------------------------------------------------------------
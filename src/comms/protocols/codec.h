@@ -18,6 +18,15 @@ namespace IslSdk
         Codec(uint_t bufSize, Type type);
         virtual ~Codec();
         virtual uint_t decode(const uint8_t* data, uint_t* size) = 0;
+
+        /**
+        * @brief Decodes like decode(), but may decode a frame over itself in \p data instead of copying it to m_frameBuf.
+        * @param data The received bytes, which may be modified.
+        * @param size The number of bytes, updated to the number left to process.
+        * @param frame Set to the start of the decoded frame, either in \p data or m_frameBuf.
+        * @return The size of the decoded frame, or 0 if no frame is complete.
+        */
+        virtual uint_t decodeInPlace(uint8_t* data, uint_t* size, const uint8_t** frame);
         virtual uint_t encode(const uint8_t* data, uint_t size, uint8_t* buf, uint_t bufSize) = 0;
         Type type;
         std::vector<uint8_t> m_frameBuf;
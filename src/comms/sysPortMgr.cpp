@@ -40,6 +40,8 @@ SysPort::SharedPtr SysPortMgr::getSharedPtr(SysPort& sysPort)
 //--------------------------------------------------------------------------------------------------
 const std::shared_ptr<NetPort> SysPortMgr::createNetPort(const std::string& name, bool_t isTcp, bool_t isServer, uint32_t ipAddress, uint16_t port)
 {
+    std::lock_guard<std::recursive_mutex> lock(SysPort::commsMutex);
+
     const std::shared_ptr<NetPort> ptr = std::make_shared<NetPort>(name, isTcp, isServer, ipAddress, port);
     m_sysPortList.push_back(ptr);
     debugLog("SysPort", "New network port %s", name.c_str());
@@ -50,6 +52,8 @@ const std::shared_ptr<NetPort> SysPortMgr::createNetPort(const std::string& name
 //--------------------------------------------------------------------------------------------------
 const std::shared_ptr<SolPort> SysPortMgr::createSol(const std::string& name, bool_t isTcp, bool_t useTelnet, uint32_t ipAddress, uint16_t port)
 {
+    std::lock_guard<std::recursive_mutex> lock(SysPort::commsMutex);
+
     std::shared_ptr<SolPort> ptr;
 
     if (name.empty())
@@ -77,6 +81,8 @@ void SysPortMgr::addSysPort(const SysPort::SharedPtr& sysPort)
 //--------------------------------------------------------------------------------------------------
 void SysPortMgr::deleteSolSysPort(const SysPort::SharedPtr& sysPort)
 {
+    std::lock_guard<std::recursive_mutex> lock(SysPort::commsMutex);
+
     if (sysPort && sysPort->classType == SysPort::ClassType::Sol)
     {
         deleteSysPort(sysPort);
@@ -200,3 +206,25 @@ void SysPortMgr::run()
     }
 }
 //--------------------------------------------------------------------------------------------------
+void SysPortMgr::receive()
+{
+    for (const SysPort::SharedPtr& sysPort : m_sysPortList)
+    {
+        if (sysPort->active)
+        {
+            sysPort->receive();
+        }
+    }
+}
+//--------------------------------------------------------------------------------------------------
+void SysPortMgr::flush()
+{
+    for (const SysPort::SharedPtr& sysPort : m_sysPortList)
+    {
+        if (sysPort->active)
+        {
+            sysPort->flush();
+        }
+    }
+}
+//--------------------------------------------------------------------------------------------------
@@ -69,6 +69,8 @@ namespace IslSdk
     private:
         SysPortMgr();
         void run();
+        void receive();
+        void flush();
         SysPort::SharedPtr getSharedPtr(SysPort& sysPort);
         uint64_t m_timer;
         std::list<SysPort::SharedPtr> m_sysPortList;
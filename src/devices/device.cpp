@@ -130,6 +130,8 @@ void Device::CustomStr::unPackStr(const uint8_t* data, uint_t size)
 //--------------------------------------------------------------------------------------------------
 Device::Device(const Device::Info& info) : IslHdlc(), m_info(info)
 {
+    m_pingPolicy = EventQueue::Policy::DropOldest;
+    m_replyPolicy = EventQueue::Policy::NeverDrop;
     m_connectionDataSynced = false;
     m_reconnectCount = 0;
     m_resetting = false;
@@ -148,6 +150,8 @@ Device::~Device()
 //---------------------------------------------------------------------------------------------------
 void Device::connect()
 {
+    std::lock_guard<std::recursive_mutex> lock(SysPort::commsMutex);
+
     if (!m_connected)
     {
         if (m_connection)
@@ -171,6 +175,8 @@ void Device::setCommsRetries(uint_t retries)
 //---------------------------------------------------------------------------------------------------
 void Device::reset()
 {
+    std::lock_guard<std::recursive_mutex> lock(SysPort::commsMutex);
+
     m_resetting = true;
     const uint8_t payload[1] = { static_cast<uint8_t>(Commands::Reset) };
     sendPacket(&payload[0], sizeof(payload));
@@ -189,7 +195,6 @@ void Device::connectionEvent(bool_t connected)
         debugLog("Device", "Device %s connected", info.pnSnAsStr().c_str());
         m_connectionDataSynced = !bootloaderMode();
         m_info.inUse = false;
-        m_resetting = false;
         onConnect(*this);
         m_reconnectCount++;
         
@@ -233,6 +238,9 @@ bool_t Device::sendPacket(const uint8_t* data, uint_t size)
 //---------------------------------------------------------------------------------------------------
 void Device::connectionSettingsUpdated(const ConnectionMeta& meta, bool_t isHalfDuplex)
 {
+    // Called from setSettings() on the application thread, timeoutEvent() takes the pending meta on the I/O thread
+    std::lock_guard<std::recursive_mutex> lock(SysPort::commsMutex);
+
     if (m_connection)
     {
         m_pendingMeta = std::make_unique<ConnectionMeta>(meta);
@@ -313,11 +321,28 @@ uint_t Device::reDiscover(uint_t timeoutMs, uint_t count)
 }
 //---------------------------------------------------------------------------------------------------
 void Device::hdlcConnectionEvent(bool_t connected)
+{
+    if (m_events)
+    {
+        queueEvent(connected ? EventType::Connected : EventType::Disconnected, nullptr, 0, EventQueue::Policy::NeverDrop);
+    }
+    else
+    {
+        processConnectionEvent(connected);
+    }
+}
+//---------------------------------------------------------------------------------------------------
+void Device::processConnectionEvent(bool_t connected)
 {
     if (connected)
     {
+        // dispatchEvents() runs without the lock, and shouldDelete() and timeoutEvent() use the timer on the I/O thread
+        {
+            std::lock_guard<std::recursive_mutex> lock(SysPort::commsMutex);
+            m_deleteTimer = 0;
+            m_resetting = false;
+        }
         m_epochUs = Time::getTimeMs() * 1000;
-        m_deleteTimer = 0;
         uint8_t buf[9];
         buf[0] = 1;
         Mem::pack64Bit(&buf[1], m_epochUs);
@@ -356,11 +381,56 @@ bool_t Device::timeoutEvent()
         }
     }
 
-    onCommsTimeout(*this, !tryAgain);
+    if (m_events)
+    {
+        uint8_t lost = !tryAgain;
+        queueEvent(EventType::CommsTimeout, &lost, sizeof(lost), EventQueue::Policy::NeverDrop);
+    }
+    else
+    {
+        onCommsTimeout(*this, !tryAgain);
+    }
     return tryAgain;
 }
 //---------------------------------------------------------------------------------------------------
 void Device::newPacketEvent(const uint8_t* data, uint_t size)
+{
+    if (m_events)
+    {
+        bool_t isPing = size >= 1 && isPingData(*data & 0x7f);
+        queueEvent(EventType::Packet, data, size, isPing ? m_pingPolicy : m_replyPolicy);
+    }
+    else
+    {
+        processPacketData(data, size);
+    }
+}
+//--------------------------------------------------------------------------------------------------
+void Device::newPacketEvent(const ScatterList& fragments, uint_t size)
+{
+    if (m_events)
+    {
+        // Gathered straight into the event queue, which has to hold the whole packet anyway
+        bool_t isPing = fragments[0].size >= 1 && isPingData(*fragments[0].data & 0x7f);
+        uint8_t* buf = m_events->newEvent(static_cast<uint8_t>(EventType::Packet), size, isPing ? m_pingPolicy : m_replyPolicy);
+
+        if (buf)
+        {
+            for (const BufferSlice& fragment : fragments)
+            {
+                Mem::memcpy(buf, fragment.data, fragment.size);
+                buf += fragment.size;
+            }
+            m_events->push();
+        }
+    }
+    else
+    {
+        IslHdlc::newPacketEvent(fragments, size);
+    }
+}
+//--------------------------------------------------------------------------------------------------
+void Device::processPacketData(const uint8_t* data, uint_t size)
 {
     if (size >= 1)
     {
@@ -404,6 +474,51 @@ void Device::newPacketEvent(const uint8_t* data, uint_t size)
     }
 }
 //--------------------------------------------------------------------------------------------------
+void Device::queueEvent(EventType type, const uint8_t* data, uint_t size, EventQueue::Policy policy)
+{
+    uint8_t* buf = m_events->newEvent(static_cast<uint8_t>(type), size, policy);
+
+    if (buf && size)
+    {
+        Mem::memcpy(buf, data, size);
+    }
+    m_events->push();
+}
+//--------------------------------------------------------------------------------------------------
+bool_t Device::dispatchEvents()
+{
+    bool_t dispatched = false;
+    const EventQueue::Event* event = m_events->peek();
+
+    while (event)
+    {
+        switch (static_cast<EventType>(event->type))
+        {
+        case EventType::Packet:
+            processPacketData(event->data, event->size);
+            break;
+
+        case EventType::Connected:
+            processConnectionEvent(true);
+            break;
+
+        case EventType::Disconnected:
+            processConnectionEvent(false);
+            break;
+
+        case EventType::CommsTimeout:
+            onCommsTimeout(*this, event->data[0] != 0);
+            break;
+        }
+
+        m_events->pop();
+        dispatched = true;
+        event = m_events->peek();
+    }
+
+    return dispatched;
+}
+//--------------------------------------------------------------------------------------------------
 LoggingDevice::Type Device::getTrackData(std::vector<uint8_t>& buf)
 {
     uint_t size = buf.size();
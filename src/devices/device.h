@@ -7,6 +7,7 @@
 #include "comms/islHdlc.h"
 #include "comms/ports/sysPort.h"
 #include "types/sigSlot.h"
+#include "types/eventQueue.h"
 #include "logging/loggingDevice.h"
 #include "platform/uart.h"
 #include <list>
@@ -198,6 +199,14 @@ namespace IslSdk
         */
         Signal<Device&, uint_t, uint_t, uint_t, uint_t> onPacketCount;
 
+        /**
+        * @brief A subscribable event that fires every second and reports the link timing for the device
+        * The retransmit timeout follows the measured round trip time and the window shrinks when packets are lost.
+        * @param device Device& The device that triggered the event.
+        * @param stats const IslHdlc::LinkStats& The round trip time, retransmit timeout and window size.
+        */
+        Signal<Device&, const IslHdlc::LinkStats&> onLinkStats;
+
 
         /**
         * @brief A subscribable event for when a comms timeout occurs.
@@ -291,6 +300,7 @@ namespace IslSdk
         enum class Commands { Reset = 1, Descriptor, ReplyBit = 0x80 };
         virtual void connectionEvent(bool_t connected);
         virtual bool_t newPacket(uint8_t command, const uint8_t* data, uint_t size) { return false; }
+        virtual bool_t isPingData(uint8_t command) const { return false; }      ///< True if packets with this command are streamed ping data, used to pick the I/O thread's back-pressure policy.
         bool_t enqueuePacket(const uint8_t* data, uint_t size);
         bool_t sendPacket(const uint8_t* data, uint_t size);
         void connectionSettingsUpdated(const ConnectionMeta& meta, bool_t isHalfDuplex);
@@ -300,6 +310,10 @@ namespace IslSdk
         bool_t m_waitingForXmlConfig;
 
     private:
+        enum class EventType : uint8_t { Packet, Connected, Disconnected, CommsTimeout };
+        std::unique_ptr<EventQueue> m_events;               ///< Set while the SDK's I/O thread is running, events are queued for dispatchEvents()
+        EventQueue::Policy m_pingPolicy;
+        EventQueue::Policy m_replyPolicy;
         std::unique_ptr<ConnectionMeta> m_pendingMeta;
         uint_t m_packetResendLimit;
         uint32_t m_deviceTimeOut;
@@ -319,6 +333,11 @@ namespace IslSdk
         void hdlcConnectionEvent(bool_t connected) override;
         bool_t timeoutEvent() override;
         void newPacketEvent(const uint8_t* data, uint_t size) override;
+        void newPacketEvent(const ScatterList& fragments, uint_t size) override;
+        void processConnectionEvent(bool_t connected);
+        void processPacketData(const uint8_t* data, uint_t size);
+        void queueEvent(EventType type, const uint8_t* data, uint_t size, EventQueue::Policy policy);
+        bool_t dispatchEvents();
         LoggingDevice::Type getTrackData(std::vector<uint8_t>& buf) override;
         void logData(uint8_t dataType, const std::vector<uint8_t> data) override;
         
@@ -86,6 +86,8 @@ void DeviceMgr::removePortFromAll(SysPort& sysPort)
 //--------------------------------------------------------------------------------------------------
 void DeviceMgr::remove(Device& device)
 {
+    std::lock_guard<std::recursive_mutex> lock(SysPort::commsMutex);
+
     std::list<Device::SharedPtr>::iterator it = m_deviceList.begin();
 
     while (it != m_deviceList.end())
@@ -138,6 +140,21 @@ void DeviceMgr::run()
         }
     }
 
+    if (timerEvent)
+    {
+        for (const Device::SharedPtr& device : m_deviceList)
+        {
+            if (device->m_connected)
+            {
+                device->onPacketCount(*device, device->m_packetCount.tx, device->m_packetCount.rx, device->m_packetCount.resent, device->m_packetCount.rxMissed);
+                device->onLinkStats(*device, device->getLinkStats());
+            }
+        }
+    }
+}
+//--------------------------------------------------------------------------------------------------
+void DeviceMgr::process()
+{
     std::list<Device::SharedPtr>::iterator deviceIt = m_deviceList.begin();
     std::list<Device::SharedPtr>::iterator listEndIt = m_deviceList.end();
 
@@ -151,11 +168,6 @@ void DeviceMgr::run()
         {
             m_deviceList.splice(m_deviceList.end(), m_deviceList, currentIt);
         }
-
-        if (device->m_connected && timerEvent)
-        {
-            device->onPacketCount(*device, device->m_packetCount.tx, device->m_packetCount.rx, device->m_packetCount.resent, device->m_packetCount.rxMissed);
-        }
     }
 }
 //--------------------------------------------------------------------------------------------------
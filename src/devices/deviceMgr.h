@@ -67,6 +67,7 @@ namespace IslSdk
         const Device::SharedPtr findByAddress(uint8_t address) const;
         void removePortFromAll(SysPort& sysPort);
         void run();
+        void process();
         Device::SharedPtr createDevice(const Device::Info& deviceInfo);
         SysPortServices& m_sysPortServices;
         std::list<Device::SharedPtr> m_deviceList;
@@ -364,6 +364,11 @@ void Isa500::connectionEvent(bool_t isConnected)
     }
 }
 //--------------------------------------------------------------------------------------------------
+bool_t Isa500::isPingData(uint8_t command) const
+{
+    return command == Commands::EchogramData;
+}
+//--------------------------------------------------------------------------------------------------
 bool_t Isa500::newPacket(uint8_t command, const uint8_t* data, uint_t size)
 {
     bool_t shouldLog = false;
@@ -341,6 +341,7 @@ namespace IslSdk
 
         void connectionEvent(bool_t isConnected) override;
         bool_t newPacket(uint8_t command, const uint8_t* data, uint_t size) override;
+        bool_t isPingData(uint8_t command) const override;
         void signalSubscribersChanged(uint_t subscriberCount);
         void echogramSignalSubscribersChanged(uint_t subscriberCount);
         bool_t logSettings();
@@ -4,6 +4,7 @@
 #include "maths/maths.h"
 #include "platform/debug.h"
 #include "platform/mem.h"
+#include "platform/cpu.h"
 #include "utils/xmlSettings.h"
 #include "utils/stringUtils.h"
 #include "utils/utils.h"
@@ -12,6 +13,53 @@ using namespace IslSdk;
 
 const uint_t Sonar::maxAngle;
 
+//--------------------------------------------------------------------------------------------------
+static void widen8BitScalar(uint16_t* dst, const uint8_t* src, uint_t size)
+{
+	for (uint_t i = 0; i < size; i++)
+	{
+		dst[i] = static_cast<uint16_t>(src[i]) << 8;
+	}
+}
+//--------------------------------------------------------------------------------------------------
+#ifdef CPU_X86
+CPU_TARGET("sse2") static void widen8BitSse2(uint16_t* dst, const uint8_t* src, uint_t size)
+{
+	const __m128i zero = _mm_setzero_si128();
+	uint_t i = 0;
+
+	for (; i + 16 <= size; i += 16)
+	{
+		__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_unpacklo_epi8(zero, v));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 8), _mm_unpackhi_epi8(zero, v));
+	}
+	widen8BitScalar(dst + i, src + i, size - i);
+}
+//--------------------------------------------------------------------------------------------------
+CPU_TARGET("avx2") static void widen8BitAvx2(uint16_t* dst, const uint8_t* src, uint_t size)
+{
+	uint_t i = 0;
+
+	for (; i + 16 <= size; i += 16)
+	{
+		__m256i v = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_slli_epi16(v, 8));
+	}
+	widen8BitScalar(dst + i, src + i, size - i);
+}
+#endif
+//--------------------------------------------------------------------------------------------------
+static void widen8Bit(uint16_t* dst, const uint8_t* src, uint_t size)
+{
+#ifdef CPU_X86
+	static void (*const func)(uint16_t*, const uint8_t*, uint_t) = Cpu::hasAvx2() ? widen8BitAvx2 : Cpu::hasSse2() ? widen8BitSse2 : widen8BitScalar;
+	func(dst, src, size);
+#else
+	widen8BitScalar(dst, src, size);
+#endif
+}
+
 //--------------------------------------------------------------------------------------------------
 Sonar::Sonar(const Device::Info& info) : Device(info), m_macAddress{}
 {
@@ -488,7 +536,7 @@ void Sonar::connectionEvent(bool_t isConnected)
 		else
 		{
 			setSensorRates(m_requestedRates);
-			selectDataOutput(onPingData.hasSubscribers(), onEchoData.hasSubscribers());
+			selectDataOutput(onPingData.hasSubscribers() || onPingView.hasSubscribers(), onEchoData.hasSubscribers());
 			if (!m_connectionDataSynced)
 			{
 				getAhrsCal();
@@ -507,6 +555,11 @@ void Sonar::connectionEvent(bool_t isConnected)
 	}
 }
 //--------------------------------------------------------------------------------------------------
+bool_t Sonar::isPingData(uint8_t command) const
+{
+	return static_cast<Commands>(command) == Commands::PingData || static_cast<Commands>(command) == Commands::EchoData;
+}
+//--------------------------------------------------------------------------------------------------
 bool_t Sonar::newPacket(uint8_t command, const uint8_t* data, uint_t size)
 {
 	bool_t shouldLog = false;
@@ -803,33 +856,30 @@ bool_t Sonar::newPacket(uint8_t command, const uint8_t* data, uint_t size)
 			size *= 2;
 		}
 
-		Ping ping;
+		PingView ping;
 		ping.angle = temp16 & 0x3fff;
 		ping.minRangeMm = Mem::get32Bit(&data);
 		ping.maxRangeMm = Mem::get32Bit(&data);
 		ping.stepSize = static_cast<int32_t>(ping.minRangeMm) >> 20;
 		ping.minRangeMm &= 0x000fffff;
-
-		uint_t dataCount = size / 2;
-		ping.data.resize(dataCount);
-		if (temp16 & 0xc000)
-		{
-			for (uint_t i = 0; i < dataCount; i++)
-			{
-				ping.data[i] = static_cast<uint16_t>(data[i]) << 8;
-			}
-		}
-		else
-		{
-			Mem::memcpy(&ping.data[0], data, size);
-		}
+		ping.data = data;
+		ping.count = size / 2;
+		ping.bitDepth = (temp16 & 0xc000) ? 8 : 16;
+		ping.sampleBytes = ping.bitDepth / 8;
 
 		if (ping.stepSize == 0)
 		{
 			ping.stepSize = settings.setup.stepSize;
 		}
 
-		onPingData(*this, ping);
+		onPingView(*this, ping);
+
+		if (onPingData.hasSubscribers())
+		{
+			Ping pingData;
+			ping.copyTo(pingData);
+			onPingData(*this, pingData);
+		}
 		break;
 	}
 	case Commands::EchoData:
@@ -924,7 +974,7 @@ void Sonar::sonarDataSignalSubscribersChanged(uint_t subscriberCount)
 {
 	if (subscriberCount <= 1)
 	{
-		selectDataOutput(onPingData.hasSubscribers(), onEchoData.hasSubscribers());
+		selectDataOutput(onPingData.hasSubscribers() || onPingView.hasSubscribers(), onEchoData.hasSubscribers());
 	}
 }
 //--------------------------------------------------------------------------------------------------
@@ -1078,6 +1128,44 @@ void Sonar::getTvg()
 	}
 }
 //--------------------------------------------------------------------------------------------------
+uint16_t Sonar::PingView::operator[](uint_t idx) const
+{
+	if (sampleBytes == 1)
+	{
+		return static_cast<uint16_t>(data[idx]) << 8;
+	}
+
+	uint16_t value;
+	Mem::memcpy(&value, &data[idx * 2], sizeof(value));
+	return value;
+}
+//--------------------------------------------------------------------------------------------------
+void Sonar::PingView::copyTo(uint16_t* dst, uint_t first, uint_t size) const
+{
+	if (sampleBytes == 1)
+	{
+		widen8Bit(dst, &data[first], size);
+	}
+	else
+	{
+		Mem::memcpy(dst, &data[first * 2], size * sizeof(uint16_t));
+	}
+}
+//--------------------------------------------------------------------------------------------------
+void Sonar::PingView::copyTo(Ping& ping) const
+{
+	ping.angle = angle;
+	ping.stepSize = stepSize;
+	ping.minRangeMm = minRangeMm;
+	ping.maxRangeMm = maxRangeMm;
+	ping.bitDepth = bitDepth;
+	ping.data.resize(count);
+	if (count)
+	{
+		copyTo(&ping.data[0], 0, count);
+	}
+}
+//--------------------------------------------------------------------------------------------------
 Sonar::Settings::Settings()
 {
 	defaults();
@@ -183,7 +183,43 @@ namespace IslSdk
             uint_t minRangeMm;                  ///< Start distance of the data in millimeters, \p data[0] is aquired at this range
             uint_t maxRangeMm;                  ///< Final distance of the data in millimeters, \p data[data.size()-1] is aquired at this range
             std::vector<uint16_t> data;         ///< Array of ping data. Each value represents the amplitude of the signal at a range. The range is given by: range = minRangeMm + (arrayIndex * ((maxRangeMm - minRangeMm) / data.size()))
-            Ping() : angle(0), stepSize(0), minRangeMm(0), maxRangeMm(0) {}
+            uint_t bitDepth;                    ///< 8 or 16, the resolution the device sent the data at. 8 bit data is scaled to 16 bits in \p data.
+            Ping() : angle(0), stepSize(0), minRangeMm(0), maxRangeMm(0), bitDepth(16) {}
+        };
+
+        struct PingView                         /// Read only view of the ping data straight over the received packet. Only valid for the duration of the onPingView callback, use copyTo() to keep the data.
+        {
+            uint_t angle;                       ///< Angle the data was aquired at in units of 12800th. 360 degrees = a value of 12800.
+            int_t stepSize;                     ///< The step size setting at the time this data was aquired.
+            uint_t minRangeMm;                  ///< Start distance of the data in millimeters.
+            uint_t maxRangeMm;                  ///< Final distance of the data in millimeters.
+            const uint8_t* data;                ///< Raw data, \p count values of \p sampleBytes each. 16 bit values are little endian.
+            uint_t count;                       ///< Number of data points.
+            uint_t bitDepth;                    ///< 8 or 16, the resolution the device sent the data at.
+            uint_t sampleBytes;                 ///< 1 for 8 bit data straight from the device, otherwise 2. 8 bit values are scaled to 16 bit by the accessors.
+            PingView() : angle(0), stepSize(0), minRangeMm(0), maxRangeMm(0), data(nullptr), count(0), bitDepth(16), sampleBytes(2) {}
+            PingView(const Ping& ping) : angle(ping.angle), stepSize(ping.stepSize), minRangeMm(ping.minRangeMm), maxRangeMm(ping.maxRangeMm), data(reinterpret_cast<const uint8_t*>(ping.data.data())), count(static_cast<uint_t>(ping.data.size())), bitDepth(ping.bitDepth), sampleBytes(2) {}
+
+            /**
+            * @brief Gets a single data point scaled to 16 bits.
+            * @param idx The index of the data point.
+            * @return The amplitude.
+            */
+            uint16_t operator[](uint_t idx) const;
+
+            /**
+            * @brief Copies data points to a buffer, widening 8 bit data to 16 bits.
+            * @param dst The buffer to write \p size data points to.
+            * @param first The index of the first data point to copy.
+            * @param size The number of data points to copy.
+            */
+            void copyTo(uint16_t* dst, uint_t first, uint_t size) const;
+
+            /**
+            * @brief Copies the view into a Ping.
+            * @param ping The ping to fill, its data vector is resized to \p count.
+            */
+            void copyTo(Ping& ping) const;
         };
 
         struct Echos                            /// This is a list of echos received from the device on each ping. This is the profiling data.
@@ -250,6 +286,15 @@ namespace IslSdk
         */
         Signal<Sonar&, const Ping&> onPingData{ this, & Sonar::sonarDataSignalSubscribersChanged };
 
+        /**
+        * @brief A subscribable event for knowing when the device has received new ping data, without copying it.
+        * The same data as onPingData but as a view over the received packet. The ping is only decoded into a Ping
+        * if onPingData also has subscribers, so subscribers that only log, forward or store the data should use this.
+        * @param device Sonar& The device that triggered the event.
+        * @param ping const PingView& The ping data, only valid during the call.
+        */
+        Signal<Sonar&, const PingView&> onPingView{ this, & Sonar::sonarDataSignalSubscribersChanged };
+
         /**
         * @brief A subscribable event for knowing when the device has received new echo data.
         * Subscribers to this signal will be called when the device has received new echo data.
@@ -453,6 +498,7 @@ namespace IslSdk
 
         void connectionEvent(bool_t isConnected) override;
         bool_t newPacket(uint8_t command, const uint8_t* data, uint_t size) override;
+        bool_t isPingData(uint8_t command) const override;
         void signalSubscribersChanged(uint_t subscriberCount);
         void sonarDataSignalSubscribersChanged(uint_t subscriberCount);
         bool_t logSettings();
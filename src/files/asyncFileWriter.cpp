@@ -0,0 +1,247 @@
+//------------------------------------------ Includes ----------------------------------------------
+
+#include "asyncFileWriter.h"
+#include "platform/file.h"
+#include "platform/mem.h"
+#include "maths/maths.h"
+#include <chrono>
+
+using namespace IslSdk;
+
+//--------------------------------------------------------------------------------------------------
+AsyncFileWriter::AsyncFileWriter() :
+    m_file(nullptr),
+    m_position(0),
+    m_flushing(false),
+    m_stop(false),
+    m_bufferSize(1024 * 1024),
+    m_flushIntervalMs(1000),
+    m_syncPolicy(SyncPolicy::OnClose),
+    m_stats()
+{
+}
+//--------------------------------------------------------------------------------------------------
+AsyncFileWriter::~AsyncFileWriter()
+{
+    close();
+}
+//--------------------------------------------------------------------------------------------------
+void AsyncFileWriter::setBufferSize(uint_t size)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_bufferSize = Math::max<uint_t>(size, 4096);
+}
+//--------------------------------------------------------------------------------------------------
+void AsyncFileWriter::setPolicy(uint_t flushIntervalMs, SyncPolicy sync)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_flushIntervalMs = Math::max<uint_t>(flushIntervalMs, 1);
+    m_syncPolicy = sync;
+}
+//--------------------------------------------------------------------------------------------------
+void AsyncFileWriter::setEncoder(const Encoder& encoder)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_encoder = encoder;
+}
+//--------------------------------------------------------------------------------------------------
+bool_t AsyncFileWriter::open(const std::string& fileName, uint64_t position)
+{
+    close();
+
+    m_file = std::fopen(fileName.c_str(), "r+b");
+
+    if (m_file && !File::seek(m_file, position))
+    {
+        std::fclose(m_file);
+        m_file = nullptr;
+    }
+
+    if (m_file)
+    {
+        // The buffers are kept between files so they are only allocated once
+        m_fill.reserve(m_bufferSize);
+        m_flush.reserve(m_bufferSize);
+        m_fill.clear();
+        m_flush.clear();
+        m_fillRecords.clear();
+        m_flushRecords.clear();
+        m_offsets.clear();
+        m_position = position;
+        m_flushing = false;
+        m_stop = false;
+        m_stats = Stats();
+        m_stats.bufferSize = m_bufferSize;
+        m_thread = std::thread(&AsyncFileWriter::threadWrite, this);
+    }
+
+    return m_file != nullptr;
+}
+//--------------------------------------------------------------------------------------------------
+bool_t AsyncFileWriter::append(const uint8_t* header, uint_t headerSize, const void* data, uint_t dataSize, bool_t canDrop, bool_t encode)
+{
+    uint_t size = headerSize + dataSize;
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    if (!m_file || m_stats.error)
+    {
+        return false;
+    }
+
+    if (m_fill.size() + size > m_bufferSize && !m_fill.empty())
+    {
+        if (m_flushing)
+        {
+            if (canDrop)
+            {
+                m_stats.droppedRecords++;
+                return false;
+            }
+            m_written.wait(lock, [&]() { return !m_flushing; });
+        }
+        swapBuffers();
+    }
+
+    // A record bigger than the buffer grows it rather than being split
+    uint_t offset = m_fill.size();
+    m_fill.resize(offset + size);
+    Mem::memcpy(&m_fill[offset], header, headerSize);
+    if (dataSize)
+    {
+        Mem::memcpy(&m_fill[offset + headerSize], data, dataSize);
+    }
+
+    if (m_encoder)
+    {
+        m_fillRecords.push_back({ static_cast<uint32_t>(size), encode });
+    }
+    m_stats.appendedBytes += size;
+
+    uint_t pending = m_fill.size() + (m_flushing ? m_flush.size() : 0);
+    m_stats.highWaterBytes = Math::max(m_stats.highWaterBytes, pending);
+
+    return true;
+}
+//--------------------------------------------------------------------------------------------------
+bool_t AsyncFileWriter::close()
+{
+    if (!m_file)
+    {
+        return true;
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        if (!m_fill.empty())
+        {
+            m_written.wait(lock, [&]() { return !m_flushing; });
+            swapBuffers();
+        }
+        m_written.wait(lock, [&]() { return !m_flushing; });
+        m_stop = true;
+        m_wake.notify_one();
+    }
+    m_thread.join();
+
+    bool_t ok = !m_stats.error && std::fflush(m_file) == 0;
+
+    if (ok && m_syncPolicy == SyncPolicy::OnClose)
+    {
+        ok = File::syncData(m_file);
+        m_stats.syncCount++;
+    }
+
+    std::fclose(m_file);
+    m_file = nullptr;
+
+    return ok;
+}
+//--------------------------------------------------------------------------------------------------
+AsyncFileWriter::Stats AsyncFileWriter::getStats()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    Stats stats = m_stats;
+    stats.pendingBytes = m_fill.size() + (m_flushing ? m_flush.size() : 0);
+    return stats;
+}
+//--------------------------------------------------------------------------------------------------
+void AsyncFileWriter::swapBuffers()
+{
+    std::swap(m_fill, m_flush);
+    std::swap(m_fillRecords, m_flushRecords);
+    m_fill.clear();
+    m_fillRecords.clear();
+    m_flushing = true;
+    m_wake.notify_one();
+}
+//--------------------------------------------------------------------------------------------------
+void AsyncFileWriter::threadWrite()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    while (true)
+    {
+        if (!m_wake.wait_for(lock, std::chrono::milliseconds(m_flushIntervalMs), [&]() { return m_flushing || m_stop; }))
+        {
+            // Nothing filled a buffer within the interval, so write what there is
+            if (!m_fill.empty())
+            {
+                swapBuffers();
+            }
+        }
+
+        if (m_flushing)
+        {
+            SyncPolicy sync = m_syncPolicy;
+            lock.unlock();
+
+            const std::vector<uint8_t>& data = m_flushRecords.empty() ? m_flush : encodeRecords();
+            bool_t ok = std::fwrite(data.data(), 1, data.size(), m_file) == data.size() && std::fflush(m_file) == 0;
+            m_position += data.size();
+            bool_t synced = ok && sync == SyncPolicy::EveryWrite;
+            if (synced)
+            {
+                ok = File::syncData(m_file);
+            }
+
+            lock.lock();
+            m_stats.error = m_stats.error || !ok;
+            m_stats.writeCount++;
+            m_stats.syncCount += synced;
+            m_stats.writtenBytes += data.size();
+            m_flushing = false;
+            m_written.notify_all();
+        }
+        else if (m_stop)
+        {
+            break;
+        }
+    }
+}
+//--------------------------------------------------------------------------------------------------
+const std::vector<uint8_t>& AsyncFileWriter::encodeRecords()
+{
+    uint_t offset = 0;
+    m_encoded.clear();
+
+    for (const Record& record : m_flushRecords)
+    {
+        const uint8_t* data = &m_flush[offset];
+        m_offsets.push_back(m_position + m_encoded.size());
+
+        if (record.encode && m_encoder(data, record.size, m_record))
+        {
+            m_encoded.insert(m_encoded.end(), m_record.begin(), m_record.end());
+        }
+        else
+        {
+            m_encoded.insert(m_encoded.end(), data, data + record.size);
+        }
+        offset += record.size;
+    }
+
+    return m_encoded;
+}
+//--------------------------------------------------------------------------------------------------
@@ -0,0 +1,156 @@
+#ifndef ASYNCFILEWRITER_H_
+#define ASYNCFILEWRITER_H_
+
+//------------------------------------------ Includes ----------------------------------------------
+
+#include "types/sdkTypes.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+//--------------------------------------- Class Definition -----------------------------------------
+
+namespace IslSdk
+{
+    /**
+    * @brief Appends to a file from a background thread.
+    * Data is copied into one of two buffers while the other is written out, so a slow disk only holds up the caller
+    * when both buffers are full. Data is written in the order it was appended.
+    */
+    class AsyncFileWriter
+    {
+    public:
+        /// When the written data is forced out to the storage device with fdatasync.
+        enum class SyncPolicy
+        {
+            Never,          ///< Left to the operating system.
+            OnClose,        ///< Once when the file is closed.
+            EveryWrite,     ///< After each buffer is written, so at most one buffer or one flush interval is lost on power failure.
+        };
+
+        struct Stats
+        {
+            uint_t bufferSize;                      ///< The size of each of the two buffers in bytes.
+            uint_t pendingBytes;                    ///< Bytes waiting to be written.
+            uint_t highWaterBytes;                  ///< The most bytes that have been waiting to be written.
+            uint_t droppedRecords;                  ///< Records discarded because both buffers were full.
+            uint_t writeCount;                      ///< The number of buffers written.
+            uint_t syncCount;                       ///< The number of times the file was synced.
+            bool_t error;                           ///< True if a write failed, nothing more is written after an error.
+            uint64_t appendedBytes;                 ///< Bytes appended since the file was opened.
+            uint64_t writtenBytes;                  ///< Bytes written since the file was opened, less than appendedBytes when records are encoded.
+        };
+
+        /**
+        * @brief Rewrites a record on the background thread, eg to compress it.
+        * @param record The record as appended, header then data.
+        * @param size The size of the record.
+        * @param out Where to put the record to write instead.
+        * @return True to write \p out, false to write the record as it was appended.
+        */
+        typedef std::function<bool_t(const uint8_t* record, uint_t size, std::vector<uint8_t>& out)> Encoder;
+
+        AsyncFileWriter();
+        ~AsyncFileWriter();
+
+        /**
+        * @brief Sets the size of the buffers, takes effect when the next file is opened.
+        * @param size The size of each of the two buffers in bytes.
+        */
+        void setBufferSize(uint_t size);
+
+        /**
+        * @brief Sets when data is written and synced.
+        * @param flushIntervalMs A partly full buffer is written once it has waited this long.
+        * @param sync When to sync the file.
+        */
+        void setPolicy(uint_t flushIntervalMs, SyncPolicy sync);
+
+        /**
+        * @brief Sets the encoder for records appended with encode set, call while the file is closed.
+        * While an encoder is set the file position of every record is kept, see recordOffsets().
+        * @param encoder The encoder, or nullptr for none.
+        */
+        void setEncoder(const Encoder& encoder);
+
+        /**
+        * @brief Opens an existing file and starts the background thread.
+        * @param fileName The file to write to.
+        * @param position The position in the file to start writing at.
+        * @return True if the file was opened.
+        */
+        bool_t open(const std::string& fileName, uint64_t position);
+
+        /**
+        * @brief Appends a record, made of a header and data.
+        * @param header The record header.
+        * @param headerSize The size of the header in bytes.
+        * @param data The record data.
+        * @param dataSize The size of the data in bytes.
+        * @param canDrop True to discard the record if both buffers are full, otherwise waits for a buffer to be written.
+        * @param encode True to pass the record through the encoder before it's written.
+        * @return True if the record was buffered, false if it was dropped or a write has failed.
+        */
+        bool_t append(const uint8_t* header, uint_t headerSize, const void* data, uint_t dataSize, bool_t canDrop, bool_t encode = false);
+
+        /**
+        * @brief Writes everything buffered, stops the background thread and closes the file.
+        * @return True if all the data was written.
+        */
+        bool_t close();
+        bool_t isOpen() const { return m_file != nullptr; }
+        bool_t isEncoding() const { return m_encoder != nullptr; }
+        Stats getStats();
+
+        /**
+        * @brief The file position of each record appended since open(), in the order they were appended.
+        * Only kept while an encoder is set, and only complete once the file is closed.
+        */
+        const std::vector<uint64_t>& recordOffsets() const { return m_offsets; }
+
+        /**
+        * @brief The position in the file after the last data written, the end of the file once it's closed.
+        */
+        uint64_t position() const { return m_position; }
+
+    private:
+        std::FILE* m_file;
+        std::thread m_thread;
+        std::mutex m_mutex;
+        std::condition_variable m_wake;             ///< Signals the thread that a buffer is ready or it should stop.
+        std::condition_variable m_written;          ///< Signals the caller that the thread has finished writing a buffer.
+        std::vector<uint8_t> m_fill;                ///< Being appended to.
+        std::vector<uint8_t> m_flush;               ///< Being written by the thread.
+
+        struct Record
+        {
+            uint32_t size;
+            bool_t encode;
+        };
+
+        Encoder m_encoder;
+        std::vector<Record> m_fillRecords;          ///< The records in m_fill, only kept while there's an encoder.
+        std::vector<Record> m_flushRecords;
+        std::vector<uint8_t> m_encoded;             ///< m_flush after encoding, used by the thread.
+        std::vector<uint8_t> m_record;
+        std::vector<uint64_t> m_offsets;
+        uint64_t m_position;
+        bool_t m_flushing;
+        bool_t m_stop;
+        uint_t m_bufferSize;
+        uint_t m_flushIntervalMs;
+        SyncPolicy m_syncPolicy;
+        Stats m_stats;
+
+        void swapBuffers();
+        void threadWrite();
+        const std::vector<uint8_t>& encodeRecords();
+    };
+}
+
+//--------------------------------------------------------------------------------------------------
+#endif
@@ -3,19 +3,46 @@
 #include "logFile.h"
 #include "platform/file.h"
 #include "platform/mem.h"
+#include "maths/maths.h"
+#include "utils/lz4.h"
 
 using namespace IslSdk;
 
 //--------------------------------------------------------------------------------------------------
 
 const uint32_t logFileHeaderId = 0xc0debe02;
+const uint8_t logFileVersion = 3;
 const uint32_t fileHeaderSize = 17;
 const uint32_t recordHeaderSize = 11;
 const uint32_t indexHeaderSize = 11;
 const uint32_t indexRecordSize = 10;
 
+// Version 3 has 64 bit file offsets and microsecond record times, the layout is otherwise the same
+const uint32_t fileHeaderSizeV3 = 21;
+const uint32_t recordHeaderSizeV3 = 15;
+const uint32_t indexRecordSizeV3 = 18;
+
+static uint32_t fileHeaderSizeOf(uint8_t version) { return version >= 3 ? fileHeaderSizeV3 : fileHeaderSize; }
+static uint32_t recordHeaderSizeOf(uint8_t version) { return version >= 3 ? recordHeaderSizeV3 : recordHeaderSize; }
+
 //--------------------------------------------------------------------------------------------------
-LogFile::LogFile() : m_timeMs(0) , m_isModified(false), m_fileWritePosition(0), m_durationMs(0)
+/// Builds a version 3 record with compressed data, returns false if compressing doesn't make it smaller.
+static bool_t encodeRecord(LogFile::RecordHeader::Codec codec, const uint8_t* header, const uint8_t* data, uint_t dataSize, std::vector<uint8_t>& out)
+{
+    out.assign(header, header + recordHeaderSizeV3);
+    codec = LogFile::compressData(codec, data, dataSize, out);
+
+    if (codec == LogFile::RecordHeader::Codec::None)
+    {
+        return false;
+    }
+
+    Mem::pack32Bit(&out[0], static_cast<uint32_t>(out.size()));
+    out[13] |= static_cast<uint8_t>(codec) << 4;            // The flags byte, after the size, time and track id
+    return true;
+}
+//--------------------------------------------------------------------------------------------------
+LogFile::LogFile() : m_access(MappedFile::Access::Normal), m_readPosition(0), m_version(logFileVersion), m_writer(nullptr), m_codec(RecordHeader::Codec::None), m_offsetsPending(false), m_appendCount(0), m_timeMs(0) , m_isModified(false), m_fileWritePosition(0), m_durationMs(0)
 {
 }
 //--------------------------------------------------------------------------------------------------
@@ -30,25 +57,33 @@ LogFile::Error LogFile::open(const std::string& fileName)
 
     m_tracks.clear();
     m_records.clear();
+    m_timeIndex.clear();
     m_isModified = false;
     m_timeMs = 0;
     m_fileWritePosition = 0;
     m_durationMs = 0;
+    m_access = MappedFile::Access::Normal;
 
-    m_file.open(fileName, std::fstream::in | std::fstream::out | std::fstream::binary);
+    // Reading from a mapping only touches the pages used, so opening costs the size of the index rather than the file
+    if (!m_map.open(fileName))
+    {
+        m_file.open(fileName, std::fstream::in | std::fstream::out | std::fstream::binary);
+    }
 
-    if (!m_file.fail())
+    if (m_map.isOpen() || !m_file.fail())
     {
         bool_t ok = false;
         LogFile::FileHeader fileHeader;
         if (readFileHeader(fileHeader))
         {
-            if (fileHeader.id == logFileHeaderId && (fileHeader.version == 1 || fileHeader.version == 2) && fileHeader.indexPosition)
+            if (fileHeader.id == logFileHeaderId && fileHeader.version >= 1 && fileHeader.version <= logFileVersion && fileHeader.indexPosition)
             {
+                m_version = fileHeader.version;
                 m_timeMs = fileHeader.timeMs;
                 m_fileWritePosition = fileHeader.indexPosition;
 
-                ok = readFileIndexes(fileHeader.indexPosition, fileHeader.version);
+                m_map.prefetch(fileHeader.indexPosition, m_map.size() - fileHeader.indexPosition);
+                ok = readFileIndexes(fileHeader.indexPosition);
             }
         }
 
@@ -56,9 +91,11 @@ LogFile::Error LogFile::open(const std::string& fileName)
         {
             m_tracks.clear();
             m_records.clear();
+            m_timeIndex.clear();
 
             err = LogFile::Error::Damaged;
 
+            m_map.close();
             if (m_file.is_open())
             {
                 m_file.close();
@@ -101,15 +138,17 @@ LogFile::Error LogFile::repair(const std::string& fileName)
         m_isModified = true;
         m_fileWritePosition = 0;
         m_records.clear();
+        m_timeIndex.clear();
         m_tracks.clear();
 
         LogFile::FileHeader fileHeader;
         if (readFileHeader(fileHeader))
         {
-            if (fileHeader.id == logFileHeaderId && fileHeader.version == 2)
+            if (fileHeader.id == logFileHeaderId && fileHeader.version >= 2 && fileHeader.version <= logFileVersion)
             {
                 bool_t ok = true;
-                uint32_t filePosition = fileHeaderSize;
+                m_version = fileHeader.version;
+                uint64_t filePosition = fileHeaderSizeOf(m_version);
                 m_timeMs = fileHeader.timeMs;
 
                 LogFile::RecordHeader recordHeader;
@@ -137,7 +176,7 @@ LogFile::Error LogFile::repair(const std::string& fileName)
                             Track* track = findTrack(recordHeader.trackId);
                             if (track)
                             {
-                                addIndex(*track, filePosition, recordHeader.timeMs, recordHeader.recordType, recordHeader.canSkip);
+                                addIndex(*track, filePosition, recordHeader.timeUs, recordHeader.recordType, recordHeader.canSkip);
                             }
                             break;
                         }
@@ -145,7 +184,7 @@ LogFile::Error LogFile::repair(const std::string& fileName)
                             break;
                         }
 
-                        filePosition += recordHeader.dataSize + recordHeaderSize;
+                        filePosition += recordHeader.dataSize + recordHeaderSizeOf(m_version);
                     }
                 }
 
@@ -159,6 +198,7 @@ LogFile::Error LogFile::repair(const std::string& fileName)
                 }
 
                 m_records.clear();
+                m_timeIndex.clear();
                 m_tracks.clear();
             }
         }
@@ -180,27 +220,30 @@ LogFile::Error LogFile::startNew(const std::string& fileName, uint64_t timeMs)
 {
     LogFile::Error err = LogFile::Error::None;
 
-    if (m_file.is_open())
+    if (m_file.is_open() || m_map.isOpen())
     {
         close();
     }
 
-    for (Track track : m_tracks)
+    for (Track& track : m_tracks)
     {
         track.startIndex = 0;
         track.recordCount = 0;
         track.startTime = 0;
         track.durationMs = 0;
+        track.timeIndex.clear();
     }
 
     m_records.clear();
+    m_timeIndex.clear();
     m_timeMs = timeMs;
-    m_fileWritePosition = fileHeaderSize;
+    m_version = logFileVersion;
+    m_fileWritePosition = fileHeaderSizeOf(m_version);
     m_isModified = false;
 
     LogFile::FileHeader fileHeader;
     fileHeader.id = logFileHeaderId;
-    fileHeader.version = 2;
+    fileHeader.version = m_version;
     fileHeader.timeMs = timeMs;
     fileHeader.indexPosition = 0;
 
@@ -210,11 +253,30 @@ LogFile::Error LogFile::startNew(const std::string& fileName, uint64_t timeMs)
     if (!m_file.fail())
     {
         m_isModified = true;
-        if (!writeFileHeader(fileHeader))
+        if (!writeFileHeader(fileHeader) || !m_file.flush())
         {
             m_file.close();
             err = LogFile::Error::CannotWrite;
         }
+        else if (m_writer)
+        {
+            RecordHeader::Codec codec = m_codec;
+            m_writer->setEncoder(codec == RecordHeader::Codec::None ? nullptr : AsyncFileWriter::Encoder([codec](const uint8_t* record, uint_t size, std::vector<uint8_t>& out)
+            {
+                return encodeRecord(codec, record, record + recordHeaderSizeV3, size - recordHeaderSizeV3, out);
+            }));
+
+            if (m_writer->open(fileName, m_fileWritePosition))
+            {
+                m_offsetsPending = m_writer->isEncoding();
+                m_appendCount = 0;
+            }
+            else
+            {
+                m_file.close();
+                err = LogFile::Error::CannotOpen;
+            }
+        }
     }
     else
     {
@@ -247,13 +309,12 @@ bool_t LogFile::logRecord(Track& track, const RecordHeader& recordHeader, const
     {
         LogFile::RecordHeader rh;
         rh.dataSize = static_cast<uint32_t>(track.data.size());
-        rh.timeMs = recordHeader.timeMs;
+        rh.timeUs = recordHeader.timeUs;
         rh.trackId = track.id;
         rh.canSkip = true;
         rh.recordType = RecordHeader::Type::Track;
         rh.dataType = track.dataType;
 
-        track.fileOffset = m_fileWritePosition;
         ok = writeRecord(track, rh, &track.data[0]);
     }
 
@@ -266,27 +327,32 @@ bool_t LogFile::logRecord(Track& track, const RecordHeader& recordHeader, const
     return ok;
 }
 //--------------------------------------------------------------------------------------------------
-bool_t LogFile::readRecordHeader(RecordHeader& recordHeader, uint_t position)
+bool_t LogFile::readRecordHeader(RecordHeader& recordHeader, uint64_t position)
 {
-    uint8_t buf[recordHeaderSize];
-
-    if (!m_file.seekg(position))
-    {
-        return false;
-    }
+    uint8_t buf[recordHeaderSizeV3];
+    uint32_t headerSize = recordHeaderSizeOf(m_version);
 
-    m_file.read(reinterpret_cast<char*>(&buf[0]), recordHeaderSize);
-    if (m_file.gcount() != recordHeaderSize)
+    if (readAt(position, &buf[0], headerSize) != headerSize)
     {
         return false;
     }
+    m_readPosition = position + headerSize;
 
     const uint8_t* ptr = &buf[0];
-    recordHeader.dataSize = Mem::get32Bit(&ptr) - recordHeaderSize;
-    recordHeader.timeMs = Mem::get32Bit(&ptr);
+    recordHeader.dataSize = Mem::get32Bit(&ptr) - headerSize;
+    recordHeader.timeUs = m_version >= 3 ? Mem::get64Bit(&ptr) : static_cast<uint64_t>(Mem::get32Bit(&ptr)) * 1000;
     recordHeader.trackId = *ptr++;
     recordHeader.canSkip = (*ptr & 0x80) != 0;
-    recordHeader.recordType = static_cast<RecordHeader::Type>(*ptr++ & 0x7f);
+    if (m_version >= 3)
+    {
+        recordHeader.codec = static_cast<RecordHeader::Codec>((*ptr >> 4) & 0x07);
+        recordHeader.recordType = static_cast<RecordHeader::Type>(*ptr++ & 0x0f);
+    }
+    else
+    {
+        recordHeader.codec = RecordHeader::Codec::None;
+        recordHeader.recordType = static_cast<RecordHeader::Type>(*ptr++ & 0x7f);
+    }
     recordHeader.dataType = *ptr;
 
     return true;
@@ -296,20 +362,186 @@ bool_t LogFile::readRecordData(uint8_t* data, uint_t size)
 {
     if (size != 0)
     {
-        m_file.read(reinterpret_cast<char*>(data), size);
-        return m_file.gcount() == static_cast<int_t>(size);
+        if (readAt(m_readPosition, data, size) != size)
+        {
+            return false;
+        }
+        m_readPosition += size;
     }
 
     return true;
 }
 //--------------------------------------------------------------------------------------------------
+bool_t LogFile::readRecordData(const RecordHeader& recordHeader, std::vector<uint8_t>& data)
+{
+    if (recordHeader.codec == RecordHeader::Codec::None)
+    {
+        data.resize(recordHeader.dataSize);
+        return readRecordData(data.data(), recordHeader.dataSize);
+    }
+
+    const uint8_t* stored = mapRecordData(recordHeader.dataSize);
+    if (!stored)
+    {
+        m_encoded.resize(recordHeader.dataSize);
+        if (!readRecordData(m_encoded.data(), recordHeader.dataSize))
+        {
+            return false;
+        }
+        stored = m_encoded.data();
+    }
+
+    return decompressData(recordHeader.codec, stored, recordHeader.dataSize, data);
+}
+//--------------------------------------------------------------------------------------------------
+LogFile::RecordHeader::Codec LogFile::compressData(RecordHeader::Codec codec, const uint8_t* data, uint_t size, std::vector<uint8_t>& out)
+{
+    if (codec == RecordHeader::Codec::Lz4Shuffle16 && (size & 1))
+    {
+        codec = RecordHeader::Codec::Lz4;
+    }
+
+    if (size == 0 || (codec != RecordHeader::Codec::Lz4 && codec != RecordHeader::Codec::Lz4Shuffle16))
+    {
+        return RecordHeader::Codec::None;
+    }
+
+    uint_t start = out.size();
+    uint_t bound = Lz4::compressBound(size);
+    bool_t shuffle = codec == RecordHeader::Codec::Lz4Shuffle16;
+    const uint8_t* src = data;
+
+    out.resize(start + 4 + bound + (shuffle ? size : 0));
+
+    if (shuffle)
+    {
+        // Shuffled into the space after the compressed block
+        uint8_t* shuffled = &out[start + 4 + bound];
+        uint_t half = size / 2;
+        for (uint_t i = 0; i < half; i++)
+        {
+            shuffled[i] = data[i * 2];
+            shuffled[half + i] = data[i * 2 + 1];
+        }
+        src = shuffled;
+    }
+
+    uint_t compressedSize = Lz4::compress(src, size, &out[start + 4], bound);
+
+    if (compressedSize == 0 || compressedSize + 4 >= size)
+    {
+        out.resize(start);
+        return RecordHeader::Codec::None;
+    }
+
+    Mem::pack32Bit(&out[start], static_cast<uint32_t>(size));
+    out.resize(start + 4 + compressedSize);
+
+    return codec;
+}
+//--------------------------------------------------------------------------------------------------
+bool_t LogFile::decompressData(RecordHeader::Codec codec, const uint8_t* stored, uint_t size, std::vector<uint8_t>& data)
+{
+    if (size < 4)
+    {
+        return false;
+    }
+
+    // LZ4 can't expand more than 255 times, so anything bigger is a damaged record
+    uint32_t dataSize = Mem::get32Bit(stored);
+    if (dataSize == 0 || dataSize / 255 > size)
+    {
+        return false;
+    }
+
+    if (codec == RecordHeader::Codec::Lz4)
+    {
+        data.resize(dataSize);
+        return Lz4::decompress(stored + 4, size - 4, &data[0], dataSize);
+    }
+
+    if (codec == RecordHeader::Codec::Lz4Shuffle16 && (dataSize & 1) == 0)
+    {
+        // Decompressed into the second half then unshuffled into the first, each write is behind the reads
+        data.resize(dataSize * 2);
+        uint8_t* shuffled = &data[dataSize];
+        if (!Lz4::decompress(stored + 4, size - 4, shuffled, dataSize))
+        {
+            return false;
+        }
+
+        uint_t half = dataSize / 2;
+        for (uint_t i = 0; i < half; i++)
+        {
+            data[i * 2] = shuffled[i];
+            data[i * 2 + 1] = shuffled[half + i];
+        }
+        data.resize(dataSize);
+        return true;
+    }
+
+    return false;
+}
+//--------------------------------------------------------------------------------------------------
+const uint8_t* LogFile::mapRecordData(uint_t size)
+{
+    if (m_map.isOpen() && m_readPosition + size <= m_map.size())
+    {
+        const uint8_t* data = m_map.data() + m_readPosition;
+        m_readPosition += size;
+        return data;
+    }
+
+    return nullptr;
+}
+//--------------------------------------------------------------------------------------------------
+void LogFile::setAccess(MappedFile::Access access)
+{
+    if (access != m_access)
+    {
+        m_access = access;
+        m_map.advise(access);
+    }
+}
+//--------------------------------------------------------------------------------------------------
+uint_t LogFile::readAt(uint64_t position, uint8_t* buf, uint_t size)
+{
+    if (m_map.isOpen())
+    {
+        if (position >= m_map.size())
+        {
+            return 0;
+        }
+
+        size = static_cast<uint_t>(Math::min<uint64_t>(size, m_map.size() - position));
+        Mem::memcpy(buf, m_map.data() + position, size);
+        return size;
+    }
+
+    if (!m_file.seekg(static_cast<std::streamoff>(position)))
+    {
+        return 0;
+    }
+
+    m_file.read(reinterpret_cast<char*>(buf), size);
+    return static_cast<uint_t>(m_file.gcount());
+}
+//--------------------------------------------------------------------------------------------------
 bool_t LogFile::close()
 {
     bool_t ok = false;
 
+    m_map.close();
+
     if (m_file.is_open())
     {
-        ok = writeFileIndexes();
+        // The indexes go after the last record, so every record has to be written first
+        bool_t written = !m_writer || m_writer->close();
+        if (m_offsetsPending)
+        {
+            applyRecordOffsets();
+        }
+        ok = writeFileIndexes() && written;
         m_file.close();
     }
 
@@ -328,15 +560,42 @@ LogFile::Track* LogFile::findTrack(uint8_t id)
     return nullptr;
 }
 //--------------------------------------------------------------------------------------------------
-void LogFile::addIndex(Track& track, uint32_t position, uint32_t timeMs, RecordHeader::Type type, bool_t canSkip)
+uint_t LogFile::findRecord(uint32_t timeMs) const
+{
+    return m_timeIndex.find(timeMs);
+}
+//--------------------------------------------------------------------------------------------------
+uint_t LogFile::findRecord(uint8_t trackId, uint32_t timeMs) const
+{
+    for (const Track& track : m_tracks)
+    {
+        if (track.id == trackId)
+        {
+            uint_t pos = track.timeIndex.find(timeMs);
+            if (pos < track.timeIndex.size())
+            {
+                return track.timeIndex[pos].recordIndex;
+            }
+            break;
+        }
+    }
+
+    return m_records.size();
+}
+//--------------------------------------------------------------------------------------------------
+void LogFile::addIndex(Track& track, uint64_t position, uint64_t timeUs, RecordHeader::Type type, bool_t canSkip)
 {
+    uint32_t timeMs = static_cast<uint32_t>(timeUs / 1000);
+
     if (track.recordCount == 0)
     {
         track.startTime = timeMs;
         track.startIndex = static_cast<uint32_t>(m_records.size());
     }
 
-    m_records.emplace_back(track.id, position, timeMs, canSkip, type);
+    track.timeIndex.add(timeMs, static_cast<uint32_t>(m_records.size()));
+    m_timeIndex.add(timeMs, static_cast<uint32_t>(m_records.size()));
+    m_records.emplace_back(track.id, position, timeUs, canSkip, type);
 
     track.recordCount++;
     track.durationMs = timeMs - track.startTime;
@@ -349,46 +608,99 @@ void LogFile::addIndex(Track& track, uint32_t position, uint32_t timeMs, RecordH
 //--------------------------------------------------------------------------------------------------
 bool_t LogFile::writeRecord(Track& track, const RecordHeader& recordHeader, const void* data)
 {
-    if (!m_file.seekp(m_fileWritePosition))
+    uint8_t buf[recordHeaderSizeV3];
+    uint32_t headerSize = recordHeaderSizeOf(m_version);
+    uint8_t* ptr = &buf[0];
+    Mem::pack32Bit(&ptr, headerSize + recordHeader.dataSize);
+    if (m_version >= 3)
     {
-        return false;
+        Mem::pack64Bit(&ptr, recordHeader.timeUs);
     }
-
-    if (recordHeader.recordType == RecordHeader::Type::Data)
+    else
     {
-        addIndex(track, m_fileWritePosition, recordHeader.timeMs, recordHeader.recordType, recordHeader.canSkip);
+        Mem::pack32Bit(&ptr, static_cast<uint32_t>(recordHeader.timeUs / 1000));
     }
-
-    uint8_t buf[recordHeaderSize];
-    uint8_t* ptr = &buf[0];
-    Mem::pack32Bit(&ptr, recordHeaderSize + recordHeader.dataSize);
-    Mem::pack32Bit(&ptr, recordHeader.timeMs);
     *ptr++ = recordHeader.trackId;
     *ptr++ = static_cast<uint8_t>(recordHeader.recordType) | static_cast<uint8_t>(recordHeader.canSkip << 7);
     *ptr++ = recordHeader.dataType;
 
-    m_file.write(reinterpret_cast<const char*>(&buf[0]), recordHeaderSize);
-    if (m_file.fail())
+    bool_t compress = m_codec != RecordHeader::Codec::None && m_version >= 3 && recordHeader.recordType == RecordHeader::Type::Data;
+    uint64_t position = m_offsetsPending ? m_appendCount : m_fileWritePosition;
+    uint64_t size = headerSize + recordHeader.dataSize;
+
+    if (m_writer && m_writer->isOpen())
     {
-        return false;
+        if (!m_writer->append(&buf[0], headerSize, data, recordHeader.dataSize, recordHeader.canSkip, compress))
+        {
+            return false;
+        }
+        m_appendCount++;
     }
+    else
+    {
+        if (!m_file.seekp(static_cast<std::streamoff>(m_fileWritePosition)))
+        {
+            return false;
+        }
 
-    m_fileWritePosition += recordHeaderSize;
+        if (compress && encodeRecord(m_codec, &buf[0], static_cast<const uint8_t*>(data), recordHeader.dataSize, m_encoded))
+        {
+            m_file.write(reinterpret_cast<const char*>(m_encoded.data()), m_encoded.size());
+            size = m_encoded.size();
+        }
+        else
+        {
+            m_file.write(reinterpret_cast<const char*>(&buf[0]), headerSize);
+            if (recordHeader.dataSize && !m_file.fail())
+            {
+                m_file.write(static_cast<const char*>(data), recordHeader.dataSize);
+            }
+        }
 
-    if (recordHeader.dataSize)
-    {
-        m_file.write(static_cast<const char*>(data), recordHeader.dataSize);
         if (m_file.fail())
         {
             return false;
         }
-        m_fileWritePosition += recordHeader.dataSize;
     }
 
+    if (recordHeader.recordType == RecordHeader::Type::Data)
+    {
+        addIndex(track, position, recordHeader.timeUs, recordHeader.recordType, recordHeader.canSkip);
+    }
+    else if (recordHeader.recordType == RecordHeader::Type::Track)
+    {
+        track.fileOffset = position;
+    }
+    m_fileWritePosition += size;
+
     return true;
 }
 //--------------------------------------------------------------------------------------------------
-bool_t LogFile::readFileIndexes(uint_t indexPosition, uint_t version)
+void LogFile::applyRecordOffsets()
+{
+    const std::vector<uint64_t>& offsets = m_writer->recordOffsets();
+
+    for (RecordIndex& record : m_records)
+    {
+        if (record.fileOffset < offsets.size())
+        {
+            record.fileOffset = offsets[static_cast<uint_t>(record.fileOffset)];
+        }
+    }
+
+    for (Track& track : m_tracks)
+    {
+        if (track.recordCount && track.fileOffset < offsets.size())
+        {
+            track.fileOffset = offsets[static_cast<uint_t>(track.fileOffset)];
+        }
+    }
+
+    m_fileWritePosition = m_writer->position();
+    m_offsetsPending = false;
+}
+//--------------------------------------------------------------------------------------------------
+bool_t LogFile::readFileIndexes(uint64_t indexPosition)
 {
     LogFile::RecordHeader recordHeader;
     if (!readRecordHeader(recordHeader, indexPosition))
@@ -396,17 +708,20 @@ bool_t LogFile::readFileIndexes(uint_t indexPosition, uint_t version)
         return false;
     }
 
-    uint8_t buf[indexRecordSize * 50];
-    m_file.read(reinterpret_cast<char*>(&buf[0]), 4);
-    if (m_file.gcount() != 4)
+    uint8_t buf[indexRecordSizeV3 * 50];
+    uint_t offsetSize = m_version >= 3 ? 8 : 4;
+    uint_t recordSize = m_version >= 3 ? indexRecordSizeV3 : indexRecordSize;
+    uint64_t position = m_readPosition;
+    if (readAt(position, &buf[0], 4) != 4)
     {
         return false;
     }
+    position += 4;
 
     uint32_t recordCount = Mem::get32Bit(&buf[0]);
     uint_t trackCount = recordHeader.dataType;
 
-    if (version > 1)
+    if (m_version > 1)
     {
         if (recordHeader.recordType != RecordHeader::Type::Index)
         {
@@ -415,14 +730,12 @@ bool_t LogFile::readFileIndexes(uint_t indexPosition, uint_t version)
 
         for (uint_t i = 0; i < trackCount; i++)
         {
-            m_file.read(reinterpret_cast<char*>(&buf[0]), 4);
-            std::streampos readPos = m_file.tellg();
-
-            if (m_file.gcount() != 4)
+            if (readAt(position, &buf[0], offsetSize) != offsetSize)
             {
                 return false;
             }
-            uint32_t trackPosition = Mem::get32Bit(&buf[0]);
+            position += offsetSize;
+            uint64_t trackPosition = m_version >= 3 ? Mem::get64Bit(&buf[0]) : Mem::get32Bit(&buf[0]);
 
             if (!readRecordHeader(recordHeader, trackPosition))
             {
@@ -443,23 +756,17 @@ bool_t LogFile::readFileIndexes(uint_t indexPosition, uint_t version)
                 return false;
             }
             track->fileOffset = trackPosition;
-
-            if (!m_file.seekg(readPos, std::ios::beg))
-            {
-                return false;
-            }
         }
     }
     else
     {
         for (uint_t i = 0; i < trackCount; i++)
         {
-            m_file.read(reinterpret_cast<char*>(&buf[0]), indexHeaderSize);
-
-            if (m_file.gcount() != indexHeaderSize)
+            if (readAt(position, &buf[0], indexHeaderSize) != indexHeaderSize)
             {
                 return false;
             }
+            position += indexHeaderSize;
 
             if (addTrack(buf[0], 0, &buf[0], indexHeaderSize) == nullptr)
             {
@@ -468,15 +775,29 @@ bool_t LogFile::readFileIndexes(uint_t indexPosition, uint_t version)
         }
     }
 
-    m_file.read(reinterpret_cast<char*>(&buf[0]), sizeof(buf));
-    uint_t bytesRead = m_file.gcount();
+    m_records.reserve(recordCount);
+    uint_t chunkSize = recordSize * 50;
+    uint_t bytesRead = readAt(position, &buf[0], chunkSize);
     while (bytesRead && recordCount)
     {
         const uint8_t* ptr = &buf[0];
-        while (bytesRead >= indexRecordSize && recordCount)
+        position += bytesRead;
+        while (bytesRead >= recordSize && recordCount)
         {
-            uint32_t fileOffset = Mem::get32Bit(&ptr);
-            uint32_t timeMs = Mem::get32Bit(&ptr);
+            uint64_t fileOffset;
+            uint64_t timeUs;
+
+            if (m_version >= 3)
+            {
+                fileOffset = Mem::get64Bit(&ptr);
+                timeUs = Mem::get64Bit(&ptr);
+            }
+            else
+            {
+                fileOffset = Mem::get32Bit(&ptr);
+                timeUs = static_cast<uint64_t>(Mem::get32Bit(&ptr)) * 1000;
+            }
+
             RecordHeader::Type type = static_cast<RecordHeader::Type>(*ptr & 0x7f);
             bool_t canSkip = (*ptr++ & 0x80) != 0;
             LogFile::Track* logTrack = findTrack(*ptr++);
@@ -486,13 +807,12 @@ bool_t LogFile::readFileIndexes(uint_t indexPosition, uint_t version)
                 return false;
             }
 
-            addIndex(*logTrack, fileOffset, timeMs, type, canSkip);
-            bytesRead -= indexRecordSize;
+            addIndex(*logTrack, fileOffset, timeUs, type, canSkip);
+            bytesRead -= recordSize;
             recordCount--;
         }
 
-        m_file.read(reinterpret_cast<char*>(&buf[0]), sizeof(buf));
-        bytesRead = m_file.gcount();
+        bytesRead = readAt(position, &buf[0], chunkSize);
     }
 
     m_file.clear();
@@ -508,23 +828,35 @@ bool_t LogFile::writeFileIndexes()
     }
 
     m_file.clear();
-    if (!m_file.seekp(m_fileWritePosition))
+    if (!m_file.seekp(static_cast<std::streamoff>(m_fileWritePosition)))
     {
         return false;
     }
 
     uint32_t recordCount = static_cast<uint32_t>(m_records.size());
-    uint8_t buf[recordHeaderSize + 4];
+    uint32_t headerSize = recordHeaderSizeOf(m_version);
+    uint_t offsetSize = m_version >= 3 ? 8 : 4;
+    uint_t recordSize = m_version >= 3 ? indexRecordSizeV3 : indexRecordSize;
+    uint8_t buf[recordHeaderSizeV3 + 4];
     uint8_t* ptr = &buf[0];
 
-    Mem::pack32Bit(&ptr, static_cast<uint32_t>(sizeof(buf) + (m_tracks.size() * 4) + (recordCount * indexRecordSize)));
-    Mem::pack32Bit(&ptr, 0);
+    // Nothing reads the size of the index record, which can overflow in version 3 as it's the last record in the file
+    uint64_t size = headerSize + 4 + (m_tracks.size() * offsetSize) + (static_cast<uint64_t>(recordCount) * recordSize);
+    Mem::pack32Bit(&ptr, static_cast<uint32_t>(Math::min<uint64_t>(size, 0xffffffff)));
+    if (m_version >= 3)
+    {
+        Mem::pack64Bit(&ptr, 0);
+    }
+    else
+    {
+        Mem::pack32Bit(&ptr, 0);
+    }
     *ptr++ = 0;
     *ptr++ = static_cast<uint8_t>(RecordHeader::Type::Index);
     *ptr++ = static_cast<uint8_t>(m_tracks.size());
     Mem::pack32Bit(&ptr, recordCount);
 
-    m_file.write(reinterpret_cast<const char*>(&buf[0]), sizeof(buf));
+    m_file.write(reinterpret_cast<const char*>(&buf[0]), headerSize + 4);
     if (m_file.fail())
     {
         return false;
@@ -532,8 +864,15 @@ bool_t LogFile::writeFileIndexes()
 
     for (const Track& track : m_tracks)
     {
-        Mem::pack32Bit(&buf[0], track.fileOffset);
-        m_file.write(reinterpret_cast<const char*>(&buf[0]), 4);
+        if (m_version >= 3)
+        {
+            Mem::pack64Bit(&buf[0], track.fileOffset);
+        }
+        else
+        {
+            Mem::pack32Bit(&buf[0], static_cast<uint32_t>(track.fileOffset));
+        }
+        m_file.write(reinterpret_cast<const char*>(&buf[0]), offsetSize);
         if (m_file.fail())
         {
             return false;
@@ -543,46 +882,69 @@ bool_t LogFile::writeFileIndexes()
     for (const RecordIndex& record : m_records)
     {
         ptr = &buf[0];
-        Mem::pack32Bit(&ptr, record.fileOffset);
-        Mem::pack32Bit(&ptr, record.timeMs);
+        if (m_version >= 3)
+        {
+            Mem::pack64Bit(&ptr, record.fileOffset);
+            Mem::pack64Bit(&ptr, record.timeUs);
+        }
+        else
+        {
+            Mem::pack32Bit(&ptr, static_cast<uint32_t>(record.fileOffset));
+            Mem::pack32Bit(&ptr, record.timeMs());
+        }
         *ptr++ = static_cast<uint8_t>(record.type) | static_cast<uint8_t>(record.canSkip << 7);
         *ptr = record.trackId;
 
-        m_file.write(reinterpret_cast<const char*>(&buf[0]), indexRecordSize);
+        m_file.write(reinterpret_cast<const char*>(&buf[0]), recordSize);
         if (m_file.fail())
         {
             return false;
         }
     }
 
-    if (!m_file.seekp(fileHeaderSize - sizeof(uint32_t)))
+    if (!m_file.seekp(fileHeaderSizeOf(m_version) - offsetSize))
     {
         return false;
     }
     m_file.clear();
 
-    Mem::pack32Bit(&buf[0], m_fileWritePosition);
-    m_file.write(reinterpret_cast<const char*>(&buf[0]), 4);
+    if (m_version >= 3)
+    {
+        Mem::pack64Bit(&buf[0], m_fileWritePosition);
+    }
+    else
+    {
+        Mem::pack32Bit(&buf[0], static_cast<uint32_t>(m_fileWritePosition));
+    }
+    m_file.write(reinterpret_cast<const char*>(&buf[0]), offsetSize);
 
     return !m_file.fail();
 }
 //--------------------------------------------------------------------------------------------------
 bool_t LogFile::readFileHeader(FileHeader& fileHeader)
 {
-    if (!m_file.seekg(0))
-    {
-        return false;
-    }
+    uint8_t buf[fileHeaderSizeV3];
+    uint_t size = readAt(0, &buf[0], fileHeaderSizeV3);
 
-    uint8_t buf[fileHeaderSize];
-    m_file.read(reinterpret_cast<char*>(&buf[0]), fileHeaderSize);
-    if (m_file.gcount() == fileHeaderSize)
+    if (size >= fileHeaderSize)
     {
         const uint8_t* ptr = &buf[0];
         fileHeader.id = Mem::get32Bit(&ptr);
         fileHeader.version = *ptr++;
         fileHeader.timeMs = Mem::get64Bit(&ptr);
-        fileHeader.indexPosition = Mem::get32Bit(&ptr);
+
+        if (fileHeader.version >= 3)
+        {
+            if (size < fileHeaderSizeV3)
+            {
+                return false;
+            }
+            fileHeader.indexPosition = Mem::get64Bit(&ptr);
+        }
+        else
+        {
+            fileHeader.indexPosition = Mem::get32Bit(&ptr);
+        }
         return true;
     }
     return false;
@@ -595,14 +957,21 @@ bool_t LogFile::writeFileHeader(const FileHeader& fileHeader)
         return false;
     }
 
-    uint8_t buf[fileHeaderSize];
+    uint8_t buf[fileHeaderSizeV3];
     uint8_t* ptr = &buf[0];
     Mem::pack32Bit(&ptr, fileHeader.id);
     *ptr++ = fileHeader.version;
     Mem::pack64Bit(&ptr, fileHeader.timeMs);
-    Mem::pack32Bit(&ptr, fileHeader.indexPosition);
+    if (fileHeader.version >= 3)
+    {
+        Mem::pack64Bit(&ptr, fileHeader.indexPosition);
+    }
+    else
+    {
+        Mem::pack32Bit(&ptr, static_cast<uint32_t>(fileHeader.indexPosition));
+    }
 
-    m_file.write(reinterpret_cast<const char*>(&buf[0]), sizeof(buf));
+    m_file.write(reinterpret_cast<const char*>(&buf[0]), fileHeaderSizeOf(fileHeader.version));
     return !m_file.fail();
 }
 //--------------------------------------------------------------------------------------------------
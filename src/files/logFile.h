@@ -5,6 +5,9 @@
 
 #include "types/sdkTypes.h"
 #include "platform/mem.h"
+#include "files/asyncFileWriter.h"
+#include "platform/mappedFile.h"
+#include "files/timeIndex.h"
 #include <fstream>
 #include <vector>
 
@@ -20,30 +23,38 @@ namespace IslSdk
             uint32_t id;
             uint8_t version;
             uint64_t timeMs;
-            uint32_t indexPosition;
+            uint64_t indexPosition;
         };
 
         struct RecordHeader
         {
-            enum class Type { Meta = 1, Data, Index, Track };
-            uint32_t timeMs;
+            enum class Type : uint8_t { Meta = 1, Data, Index, Track };
+            enum class Codec : uint8_t
+            {
+                None,
+                Lz4,                                    ///< The LZ4 block format.
+                Lz4Shuffle16,                           ///< LZ4 after splitting 16 bit values into their low then high bytes, suits ping data and 8 bit data widened to 16 bits.
+            };
+            uint64_t timeUs;                            ///< Microseconds from the start of the log, millisecond resolution before version 3.
             uint8_t trackId;
             bool_t canSkip;
             Type recordType;
-            uint32_t dataSize;
+            uint32_t dataSize;                          ///< The size of the data in the file, which is compressed if codec isn't None.
             uint8_t dataType;
+            Codec codec = Codec::None;                  ///< How the data is stored, only used in version 3. Set by LogFile when writing, see setCompression().
         };
 
         struct Track
         {
             uint8_t id;
-            uint32_t fileOffset;
+            uint64_t fileOffset;
             uint32_t startIndex;
             uint32_t recordCount;
             uint32_t startTime;
             uint32_t durationMs;
             uint8_t dataType;
             std::vector<uint8_t> data;
+            TimeIndex timeIndex;                        ///< The times of this track's records, and their index in records.
 
             Track(uint8_t id, uint8_t dataType, const uint8_t* data, uint_t size) :
                 id(id), fileOffset(0), dataType(dataType), startIndex(0), recordCount(0), startTime(0), durationMs(0), data(size)
@@ -57,13 +68,14 @@ namespace IslSdk
 
         struct RecordIndex
         {
+            uint64_t fileOffset;
+            uint64_t timeUs;
             uint8_t trackId;
-            uint32_t fileOffset;
-            uint32_t timeMs;
             bool_t canSkip;
             RecordHeader::Type type;
-            RecordIndex(uint8_t trackId, uint32_t fileOffset, uint32_t timeMs, bool_t canSkip, RecordHeader::Type type) :
-                trackId(trackId), fileOffset(fileOffset), timeMs(timeMs), canSkip(canSkip), type(type) {}
+            RecordIndex(uint8_t trackId, uint64_t fileOffset, uint64_t timeUs, bool_t canSkip, RecordHeader::Type type) :
+                fileOffset(fileOffset), timeUs(timeUs), trackId(trackId), canSkip(canSkip), type(type) {}
+            uint32_t timeMs() const { return static_cast<uint32_t>(timeUs / 1000); }
         };
 
         enum class Error { None, CannotOpen, CannotCreate, CannotWrite, Damaged };
@@ -75,29 +87,114 @@ namespace IslSdk
         LogFile::Error startNew(const std::string& fileName, uint64_t timeMs);
         Track* addTrack(uint8_t trackId, uint8_t dataType, const uint8_t* data, uint_t size);
         bool_t logRecord(Track& track, const RecordHeader& recordHeader, const void* data);
-        bool_t readRecordHeader(RecordHeader& recordHeader, uint_t position);
+        bool_t readRecordHeader(RecordHeader& recordHeader, uint64_t position);
         bool_t readRecordData(uint8_t* data, uint_t size);
+
+        /**
+        * @brief Reads the data of the record from the last readRecordHeader(), decompressing it if need be.
+        * @param recordHeader The header of the record.
+        * @param data Set to the data.
+        * @return True if the data was read.
+        */
+        bool_t readRecordData(const RecordHeader& recordHeader, std::vector<uint8_t>& data);
+
+        /**
+        * @brief Gets the data of the record from the last readRecordHeader() without copying it.
+        * @param size The size of the data.
+        * @return A pointer into the file mapping, valid until the file is closed. nullptr if the file isn't mapped.
+        */
+        const uint8_t* mapRecordData(uint_t size);
+
+        /**
+        * @brief Tells the operating system how records are going to be read, only used when the file is mapped.
+        * @param access Sequential for playback, Random for seeking.
+        */
+        void setAccess(MappedFile::Access access);
+        bool_t isMapped() const { return m_map.isOpen(); }
         bool_t close();
         Track* findTrack(uint8_t id);
 
+        /**
+        * @brief Finds the first record at or after a time.
+        * @param timeMs Milliseconds from the start of the log.
+        * @return The index of the record in records, records.size() if the log ends before timeMs.
+        */
+        uint_t findRecord(uint32_t timeMs) const;
+
+        /**
+        * @brief Finds the first record of a track at or after a time.
+        * @param trackId The track.
+        * @param timeMs Milliseconds from the start of the log.
+        * @return The index of the record in records, records.size() if the track has no records from timeMs.
+        */
+        uint_t findRecord(uint8_t trackId, uint32_t timeMs) const;
+
+        /**
+        * @brief Has records written by \p writer on its own thread rather than by the caller of logRecord().
+        * Applies from the next call to startNew(). The header and indexes are still written by LogFile.
+        * @param writer The writer, or nullptr to write records directly.
+        */
+        void setAsyncWriter(AsyncFileWriter* writer) { m_writer = writer; }
+
+        /**
+        * @brief Compresses each data record from the next call to startNew(), records stay individually readable.
+        * Compression is done on the AsyncFileWriter's thread if there is one, in which case fileWritePosition()
+        * counts the uncompressed size until the file is closed.
+        * @param codec The codec, or RecordHeader::Codec::None to store records as they are.
+        */
+        void setCompression(RecordHeader::Codec codec) { m_codec = codec; }
+
+        /**
+        * @brief Compresses record data as it's stored in the file, the uncompressed size then the compressed block.
+        * @param codec The codec to use.
+        * @param data The data to compress.
+        * @param size The size of the data.
+        * @param out The compressed data is appended to this.
+        * @return The codec used, RecordHeader::Codec::None if compressing didn't make the data smaller, in which case out is unchanged.
+        */
+        static RecordHeader::Codec compressData(RecordHeader::Codec codec, const uint8_t* data, uint_t size, std::vector<uint8_t>& out);
+
+        /**
+        * @brief Decompresses record data from compressData().
+        * @param codec The codec it was compressed with.
+        * @param stored The compressed data.
+        * @param size The size of the compressed data.
+        * @param data Set to the decompressed data.
+        * @return True if the data was valid.
+        */
+        static bool_t decompressData(RecordHeader::Codec codec, const uint8_t* stored, uint_t size, std::vector<uint8_t>& data);
+
         const uint64_t& timeMs = m_timeMs;
         const uint32_t& durationMs = m_durationMs;
         const std::vector<RecordIndex>& records = m_records;
         const std::vector<Track>& tracks = m_tracks;
-        uint_t fileWritePosition() const { return m_fileWritePosition; }
+        uint64_t fileWritePosition() const { return m_fileWritePosition; }
+        uint8_t version() const { return m_version; }  ///< The format version of the open file. startNew() writes version 3, with 64 bit offsets and microsecond times.
 
     private:
         std::fstream m_file;
+        MappedFile m_map;                                       ///< open() maps the file when it can, so records are read without system calls or copies.
+        MappedFile::Access m_access;
+        uint64_t m_readPosition;
+        uint8_t m_version;
+        AsyncFileWriter* m_writer;
+        RecordHeader::Codec m_codec;
+        bool_t m_offsetsPending;                                ///< Record offsets are the order they were given to m_writer, which knows where they went once it has compressed them.
+        uint64_t m_appendCount;
+        std::vector<uint8_t> m_encoded;
         uint64_t m_timeMs;
         uint32_t m_durationMs;
         bool_t m_isModified;
-        uint32_t m_fileWritePosition;
+        uint64_t m_fileWritePosition;
         std::vector<RecordIndex> m_records;
+        TimeIndex m_timeIndex;
         std::vector<Track> m_tracks;
 
-        void addIndex(Track& track, uint32_t position, uint32_t timeMs, RecordHeader::Type type, bool_t canSkip);
+        uint_t readAt(uint64_t position, uint8_t* buf, uint_t size);
+        void addIndex(Track& track, uint64_t position, uint64_t timeUs, RecordHeader::Type type, bool_t canSkip);
         bool_t writeRecord(Track& track, const RecordHeader& recordHeader, const void* data);
-        bool_t readFileIndexes(uint_t indexPosition, uint_t version);
+        void applyRecordOffsets();
+        bool_t readFileIndexes(uint64_t indexPosition);
         bool_t writeFileIndexes();
         bool_t readFileHeader(FileHeader& fileHeader);
         bool_t writeFileHeader(const FileHeader& fileHeader);
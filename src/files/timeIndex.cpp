@@ -0,0 +1,136 @@
+//------------------------------------------ Includes ----------------------------------------------
+
+#include "timeIndex.h"
+#include "maths/maths.h"
+
+using namespace IslSdk;
+
+//--------------------------------------------------------------------------------------------------
+TimeIndex::TimeIndex() : m_size(0), m_last({ 0, 0 }), m_maxTimeMs(0)
+{
+}
+//--------------------------------------------------------------------------------------------------
+void TimeIndex::clear()
+{
+    m_blocks.clear();
+    m_deltas.clear();
+    m_size = 0;
+    m_last = { 0, 0 };
+    m_maxTimeMs = 0;
+}
+//--------------------------------------------------------------------------------------------------
+void TimeIndex::add(uint32_t timeMs, uint32_t recordIndex)
+{
+    if (m_size == 0 || timeMs > m_maxTimeMs)
+    {
+        m_maxTimeMs = timeMs;
+    }
+
+    if (m_size % blockSize == 0)
+    {
+        m_blocks.push_back({ timeMs, recordIndex, m_maxTimeMs, static_cast<uint32_t>(m_deltas.size()) });
+    }
+    else
+    {
+        // Times can go backwards so are zigzag encoded, record indexes only go forwards
+        int64_t dt = static_cast<int64_t>(timeMs) - static_cast<int64_t>(m_last.timeMs);
+        putVarint((static_cast<uint64_t>(dt) << 1) ^ static_cast<uint64_t>(dt >> 63));
+        putVarint(recordIndex - m_last.recordIndex);
+    }
+
+    m_last = { timeMs, recordIndex };
+    m_size++;
+}
+//--------------------------------------------------------------------------------------------------
+uint_t TimeIndex::find(uint32_t timeMs) const
+{
+    uint_t lo = 0;
+    uint_t hi = m_blocks.size();
+
+    // First block that starts at or after timeMs
+    while (lo < hi)
+    {
+        uint_t mid = lo + (hi - lo) / 2;
+        if (m_blocks[mid].maxTimeMs < timeMs)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+
+    // Which is the answer, unless an entry in the block before it gets there first
+    if (lo)
+    {
+        const Block& block = m_blocks[lo - 1];
+        const uint8_t* data = m_deltas.data() + block.offset;
+        Entry entry = { block.timeMs, block.recordIndex };
+        uint32_t maxTimeMs = block.maxTimeMs;
+        uint_t pos = (lo - 1) * blockSize;
+        uint_t end = Math::min<uint_t>(pos + blockSize, m_size);
+
+        for (pos++; pos < end; pos++)
+        {
+            next(entry, &data);
+            maxTimeMs = Math::max<uint32_t>(maxTimeMs, entry.timeMs);
+            if (maxTimeMs >= timeMs)
+            {
+                return pos;
+            }
+        }
+    }
+
+    return Math::min<uint_t>(lo * blockSize, m_size);
+}
+//--------------------------------------------------------------------------------------------------
+TimeIndex::Entry TimeIndex::operator[](uint_t pos) const
+{
+    const Block& block = m_blocks[pos / blockSize];
+    const uint8_t* data = m_deltas.data() + block.offset;
+    Entry entry = { block.timeMs, block.recordIndex };
+
+    for (uint_t i = pos % blockSize; i; i--)
+    {
+        next(entry, &data);
+    }
+
+    return entry;
+}
+//--------------------------------------------------------------------------------------------------
+void TimeIndex::putVarint(uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        m_deltas.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    m_deltas.push_back(static_cast<uint8_t>(value));
+}
+//--------------------------------------------------------------------------------------------------
+uint64_t TimeIndex::getVarint(const uint8_t** data)
+{
+    uint64_t value = 0;
+    uint_t shift = 0;
+    uint8_t byte;
+
+    do
+    {
+        byte = *(*data)++;
+        value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        shift += 7;
+    } while (byte & 0x80);
+
+    return value;
+}
+//--------------------------------------------------------------------------------------------------
+void TimeIndex::next(Entry& entry, const uint8_t** data)
+{
+    uint64_t zigzag = getVarint(data);
+    int64_t dt = static_cast<int64_t>(zigzag >> 1) ^ -static_cast<int64_t>(zigzag & 1);
+
+    entry.timeMs = static_cast<uint32_t>(static_cast<int64_t>(entry.timeMs) + dt);
+    entry.recordIndex += static_cast<uint32_t>(getVarint(data));
+}
+//--------------------------------------------------------------------------------------------------
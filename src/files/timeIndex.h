@@ -0,0 +1,73 @@
+#ifndef TIMEINDEX_H_
+#define TIMEINDEX_H_
+
+//------------------------------------------ Includes ----------------------------------------------
+
+#include "types/sdkTypes.h"
+#include <vector>
+
+//--------------------------------------- Class Definition -----------------------------------------
+
+namespace IslSdk
+{
+    /**
+    * @brief A compact index of record times, for finding the record at a time in O(log n).
+    * Entries are delta encoded as variable length integers, about 2 bytes each for records a few ms apart,
+    * with a skip table entry every blockSize entries for the binary search.
+    * Times don't have to be in order, find() goes by the latest time seen so far.
+    */
+    class TimeIndex
+    {
+    public:
+        struct Entry
+        {
+            uint32_t timeMs;
+            uint32_t recordIndex;
+        };
+
+        TimeIndex();
+        void clear();
+        void add(uint32_t timeMs, uint32_t recordIndex);
+        uint_t size() const { return m_size; }
+
+        /**
+        * @brief Finds the first entry at or after a time.
+        * @param timeMs The time.
+        * @return The position of the first entry whose time, or that of any entry before it, is >= timeMs. size() if there isn't one.
+        */
+        uint_t find(uint32_t timeMs) const;
+
+        /**
+        * @brief Gets an entry, decoding at most blockSize entries.
+        * @param pos The position of the entry, must be less than size().
+        * @return The entry.
+        */
+        Entry operator[](uint_t pos) const;
+
+        uint_t memoryUsed() const { return m_blocks.capacity() * sizeof(Block) + m_deltas.capacity(); }
+
+    private:
+        static constexpr uint_t blockSize = 64;
+
+        struct Block
+        {
+            uint32_t timeMs;                    ///< Time of the first entry.
+            uint32_t recordIndex;               ///< Record index of the first entry.
+            uint32_t maxTimeMs;                 ///< Latest time up to and including the first entry.
+            uint32_t offset;                    ///< Where the deltas for the rest of the block start in m_deltas.
+        };
+
+        std::vector<Block> m_blocks;
+        std::vector<uint8_t> m_deltas;
+        uint_t m_size;
+        Entry m_last;
+        uint32_t m_maxTimeMs;
+
+        void putVarint(uint64_t value);
+        static uint64_t getVarint(const uint8_t** data);
+        static void next(Entry& entry, const uint8_t** data);
+    };
+}
+
+//--------------------------------------------------------------------------------------------------
+#endif
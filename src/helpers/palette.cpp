@@ -1,6 +1,8 @@
 //------------------------------------------ Includes ----------------------------------------------
 
 #include "palette.h"
+#include <algorithm>
+#include <cmath>
 
 using namespace IslSdk;
 
@@ -35,7 +37,7 @@ Palette::Colour Palette::Colour::interpolate(Colour from, Colour to, float_t wei
         static_cast<uint8_t>(static_cast<float_t>(from.b[3]) * (1.0f - weight) + static_cast<float_t>(to.b[3]) * weight) };
 }
 //--------------------------------------------------------------------------------------------------
-Palette::Palette()
+Palette::Palette() : m_gain(1.0f), m_gamma(1.0f)
 {
     setToDefault();
 }
@@ -58,20 +60,53 @@ void Palette::setToDefault()
 //--------------------------------------------------------------------------------------------------
 void Palette::set(const std::vector<GradientValue>& gradient, Colour nullColour)
 {
-    m_data[m_data.size() - 1] = nullColour;
+    m_gradient = gradient;
+    m_nullColour = nullColour;
+    build();
+}
+//--------------------------------------------------------------------------------------------------
+void Palette::setTransfer(float_t gain, float_t gamma)
+{
+    if (gain != m_gain || gamma != m_gamma)
+    {
+        m_gain = gain;
+        m_gamma = gamma;
+        build();
+    }
+}
+//--------------------------------------------------------------------------------------------------
+const uint32_t* Palette::lut(uint_t bits) const
+{
+    switch (bits)
+    {
+    case 8:
+        return &m_lut8[0].val;
+    case 10:
+        return &m_lut10[0].val;
+    case 12:
+        return &m_lut12[0].val;
+    default:
+        return &m_data[0].val;
+    }
+}
+//--------------------------------------------------------------------------------------------------
+void Palette::buildGradient(std::vector<Colour>& base) const
+{
+    const std::vector<GradientValue>& gradient = m_gradient;
+    const Colour nullColour = m_nullColour;
 
     if (gradient.size())
     {
         for (uint_t i = 0; i < gradient[0].position; i++)
         {
-            m_data[i] = nullColour;
+            base[i] = nullColour;
         }
 
         if (gradient.size() == 1)
         {
-            for (uint_t i = gradient[0].position; i < (m_data.size() - 1); i++)
+            for (uint_t i = gradient[0].position; i < base.size(); i++)
             {
-                m_data[i] = gradient[0].colour;
+                base[i] = gradient[0].colour;
             }
         }
         else
@@ -86,19 +121,60 @@ void Palette::set(const std::vector<GradientValue>& gradient, Colour nullColour)
 
                 for (uint_t i = startIdx, x = 0; i <= endIdx; i++, x++)
                 {
-                    m_data[i] = gradient[n - 1].colour.interpolate(gradient[n].colour, scale * x);
+                    base[i] = gradient[n - 1].colour.interpolate(gradient[n].colour, scale * x);
                 }
             }
 
-            if (endIdx < m_data.size() - 2)
+            if (endIdx < base.size() - 1)
             {
-                for (uint_t i = endIdx; i < (m_data.size() - 1); i++)
+                for (uint_t i = endIdx; i < base.size(); i++)
                 {
-                    m_data[i] = nullColour;
+                    base[i] = nullColour;
                 }
             }
         }
     }
+    else
+    {
+        std::fill(base.begin(), base.end(), Colour());
+    }
+}
+//--------------------------------------------------------------------------------------------------
+/// Rebuilds the lookup tables from the gradient and transfer function, the gradient is only needed while doing so.
+void Palette::build()
+{
+    std::vector<Colour> gradient(65536);
+    buildGradient(gradient);
+
+    if (m_gain == 1.0f && m_gamma == 1.0f)
+    {
+        std::copy(gradient.begin(), gradient.end(), m_data.begin());
+    }
+    else
+    {
+        for (uint_t i = 0; i < gradient.size(); i++)
+        {
+            float_t amplitude = m_gain * 65535.0f * std::pow(i / 65535.0f, m_gamma);
+            m_data[i] = gradient[static_cast<uint16_t>(amplitude < 65535.0f ? amplitude : 65535.0f)];
+        }
+    }
+    m_data[m_data.size() - 1] = m_nullColour;
+
+    // The compact tables take the colour at the bottom of each step so 8 bit data (value << 8) maps exactly
+    for (uint_t i = 0; i < m_lut12.size(); i++)
+    {
+        m_lut12[i] = m_data[i << 4];
+    }
+
+    for (uint_t i = 0; i < m_lut10.size(); i++)
+    {
+        m_lut10[i] = m_data[i << 6];
+    }
+
+    for (uint_t i = 0; i < m_lut8.size(); i++)
+    {
+        m_lut8[i] = m_data[i << 8];
+    }
 }
 //--------------------------------------------------------------------------------------------------
 void Palette::render(uint32_t* buf, uint_t width, uint_t height, bool_t horizontal)
@@ -38,11 +38,37 @@ namespace IslSdk
         ~Palette();
         void setToDefault();
         void set(const std::vector<GradientValue>& gradient, Colour nullColour);
+
+        /**
+        * @brief Sets the transfer function applied to the amplitude before the colour lookup, it is folded into
+        * the lookup tables so costs nothing at render time. colour = gradient(gain * 65535 * (amplitude / 65535) ^ gamma)
+        * @param gain Multiplier applied after the gamma, the result is clipped to 65535. 1 for none.
+        * @param gamma Gamma exponent. 1 for none.
+        */
+        void setTransfer(float_t gain, float_t gamma);
         void render(uint32_t* buf, uint_t width, uint_t height, bool_t horizontal);
+
+        /**
+        * @brief Gets a lookup table indexed by the amplitude shifted right by 16 - \p bits.
+        * The smaller tables stay in L1 cache and lose nothing for 8 bit data.
+        * @param bits 8, 10, 12 or 16.
+        * @return (1 << \p bits) + 1 colours, the last is the null colour.
+        */
+        const uint32_t* lut(uint_t bits) const;
         const std::array<Colour, 65536 + 1>& data = m_data;
 
     private:
+        void buildGradient(std::vector<Colour>& base) const;
+        void build();
+
         std::array<Colour, 65536 + 1> m_data;
+        std::array<Colour, 4096 + 1> m_lut12;
+        std::array<Colour, 1024 + 1> m_lut10;
+        std::array<Colour, 256 + 1> m_lut8;
+        std::vector<GradientValue> m_gradient;
+        Colour m_nullColour;
+        float_t m_gain;
+        float_t m_gamma;
     };
 }
 
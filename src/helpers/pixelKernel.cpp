@@ -0,0 +1,196 @@
+//------------------------------------------ Includes ----------------------------------------------
+
+#include "pixelKernel.h"
+#include "platform/cpu.h"
+
+using namespace IslSdk;
+
+typedef void (*Blend16BitFn)(const PixelKernel::Batch& batch, uint_t count, uint16_t* dst);
+typedef void (*BlendPaletteFn)(const PixelKernel::Batch& batch, uint_t count, const uint32_t* palette, uint_t shift, uint32_t* dst);
+
+// The order of the floating point operations must match SonarImage::calculatePixel so the result is bit exact
+//--------------------------------------------------------------------------------------------------
+static inline uint16_t blendScalar(const PixelKernel::Batch& batch, uint_t i)
+{
+    float_t pix = batch.a0[i] * (1.0f - batch.w1[i]) + batch.a1[i] * batch.w1[i];
+    float_t pix2 = batch.b0[i] * (1.0f - batch.w2[i]) + batch.b1[i] * batch.w2[i];
+    pix = pix * (1.0f - batch.w[i]) + pix2 * batch.w[i];
+    return static_cast<uint16_t>(pix);
+}
+//--------------------------------------------------------------------------------------------------
+static void blend16BitScalar(const PixelKernel::Batch& batch, uint_t i, uint_t count, uint16_t* dst)
+{
+    for (; i < count; i++)
+    {
+        if (batch.write[i])
+        {
+            dst[i] = blendScalar(batch, i);
+        }
+    }
+}
+//--------------------------------------------------------------------------------------------------
+static void blendPaletteScalar(const PixelKernel::Batch& batch, uint_t i, uint_t count, const uint32_t* palette, uint_t shift, uint32_t* dst)
+{
+    for (; i < count; i++)
+    {
+        if (batch.write[i])
+        {
+            dst[i] = palette[batch.null[i] ? (0x10000 >> shift) : (blendScalar(batch, i) >> shift)];
+        }
+    }
+}
+//--------------------------------------------------------------------------------------------------
+static void blend16BitGeneric(const PixelKernel::Batch& batch, uint_t count, uint16_t* dst)
+{
+    blend16BitScalar(batch, 0, count, dst);
+}
+//--------------------------------------------------------------------------------------------------
+static void blendPaletteGeneric(const PixelKernel::Batch& batch, uint_t count, const uint32_t* palette, uint_t shift, uint32_t* dst)
+{
+    blendPaletteScalar(batch, 0, count, palette, shift, dst);
+}
+//--------------------------------------------------------------------------------------------------
+
+#if defined(CPU_X86)
+
+//--------------------------------------------------------------------------------------------------
+CPU_TARGET("sse4.1") static inline __m128i blendSse41(const PixelKernel::Batch& batch, uint_t i)
+{
+    const __m128 one = _mm_set1_ps(1.0f);
+    __m128 w1 = _mm_loadu_ps(&batch.w1[i]);
+    __m128 w2 = _mm_loadu_ps(&batch.w2[i]);
+    __m128 w = _mm_loadu_ps(&batch.w[i]);
+
+    __m128 pix = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&batch.a0[i]), _mm_sub_ps(one, w1)), _mm_mul_ps(_mm_loadu_ps(&batch.a1[i]), w1));
+    __m128 pix2 = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&batch.b0[i]), _mm_sub_ps(one, w2)), _mm_mul_ps(_mm_loadu_ps(&batch.b1[i]), w2));
+    pix = _mm_add_ps(_mm_mul_ps(pix, _mm_sub_ps(one, w)), _mm_mul_ps(pix2, w));
+
+    // Keep the low 16 bits like the scalar conversion to uint16_t, this also keeps palette indexes in range
+    return _mm_and_si128(_mm_cvttps_epi32(pix), _mm_set1_epi32(0xffff));
+}
+//--------------------------------------------------------------------------------------------------
+CPU_TARGET("sse4.1") static void blend16BitSse41(const PixelKernel::Batch& batch, uint_t count, uint16_t* dst)
+{
+    uint_t i = 0;
+
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i pix = _mm_packus_epi32(blendSse41(batch, i), blendSse41(batch, i + 4));
+        __m128i mask = _mm_packs_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&batch.write[i])), _mm_loadu_si128(reinterpret_cast<const __m128i*>(&batch.write[i + 4])));
+        __m128i old = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&dst[i]));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&dst[i]), _mm_blendv_epi8(old, pix, mask));
+    }
+
+    blend16BitScalar(batch, i, count, dst);
+}
+//--------------------------------------------------------------------------------------------------
+CPU_TARGET("sse4.1") static void blendPaletteSse41(const PixelKernel::Batch& batch, uint_t count, const uint32_t* palette, uint_t shift, uint32_t* dst)
+{
+    const __m128i nullIdx = _mm_set1_epi32(0x10000 >> shift);
+    const __m128i shiftCount = _mm_cvtsi32_si128(static_cast<int>(shift));
+    uint_t i = 0;
+
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i idx = _mm_blendv_epi8(_mm_srl_epi32(blendSse41(batch, i), shiftCount), nullIdx, _mm_loadu_si128(reinterpret_cast<const __m128i*>(&batch.null[i])));
+        __m128i pix = _mm_set_epi32(palette[_mm_extract_epi32(idx, 3)], palette[_mm_extract_epi32(idx, 2)], palette[_mm_extract_epi32(idx, 1)], palette[_mm_extract_epi32(idx, 0)]);
+        __m128i old = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&dst[i]));
+        __m128i mask = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&batch.write[i]));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&dst[i]), _mm_blendv_epi8(old, pix, mask));
+    }
+
+    blendPaletteScalar(batch, i, count, palette, shift, dst);
+}
+//--------------------------------------------------------------------------------------------------
+CPU_TARGET("avx2") static inline __m256i blendAvx2(const PixelKernel::Batch& batch, uint_t i)
+{
+    const __m256 one = _mm256_set1_ps(1.0f);
+    __m256 w1 = _mm256_loadu_ps(&batch.w1[i]);
+    __m256 w2 = _mm256_loadu_ps(&batch.w2[i]);
+    __m256 w = _mm256_loadu_ps(&batch.w[i]);
+
+    __m256 pix = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(&batch.a0[i]), _mm256_sub_ps(one, w1)), _mm256_mul_ps(_mm256_loadu_ps(&batch.a1[i]), w1));
+    __m256 pix2 = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(&batch.b0[i]), _mm256_sub_ps(one, w2)), _mm256_mul_ps(_mm256_loadu_ps(&batch.b1[i]), w2));
+    pix = _mm256_add_ps(_mm256_mul_ps(pix, _mm256_sub_ps(one, w)), _mm256_mul_ps(pix2, w));
+
+    // Keep the low 16 bits like the scalar conversion to uint16_t, this also keeps palette indexes in range
+    return _mm256_and_si256(_mm256_cvttps_epi32(pix), _mm256_set1_epi32(0xffff));
+}
+//--------------------------------------------------------------------------------------------------
+CPU_TARGET("avx2") static void blend16BitAvx2(const PixelKernel::Batch& batch, uint_t count, uint16_t* dst)
+{
+    uint_t i = 0;
+
+    for (; i + 16 <= count; i += 16)
+    {
+        // packus works within 128 bit lanes so restore the pixel order with a permute
+        __m256i pix = _mm256_permute4x64_epi64(_mm256_packus_epi32(blendAvx2(batch, i), blendAvx2(batch, i + 8)), 0xd8);
+        __m256i mask = _mm256_permute4x64_epi64(_mm256_packs_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(&batch.write[i])), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&batch.write[i + 8]))), 0xd8);
+        __m256i old = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&dst[i]));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(&dst[i]), _mm256_blendv_epi8(old, pix, mask));
+    }
+
+    blend16BitScalar(batch, i, count, dst);
+}
+//--------------------------------------------------------------------------------------------------
+CPU_TARGET("avx2") static void blendPaletteAvx2(const PixelKernel::Batch& batch, uint_t count, const uint32_t* palette, uint_t shift, uint32_t* dst)
+{
+    const __m256i nullIdx = _mm256_set1_epi32(0x10000 >> shift);
+    const __m128i shiftCount = _mm_cvtsi32_si128(static_cast<int>(shift));
+    uint_t i = 0;
+
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256i mask = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&batch.write[i]));
+        __m256i idx = _mm256_blendv_epi8(_mm256_srl_epi32(blendAvx2(batch, i), shiftCount), nullIdx, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&batch.null[i])));
+        __m256i pix = _mm256_mask_i32gather_epi32(_mm256_setzero_si256(), reinterpret_cast<const int*>(palette), idx, mask, 4);
+        _mm256_maskstore_epi32(reinterpret_cast<int*>(&dst[i]), mask, pix);
+    }
+
+    blendPaletteScalar(batch, i, count, palette, shift, dst);
+}
+//--------------------------------------------------------------------------------------------------
+static Blend16BitFn selectBlend16Bit()
+{
+    if (Cpu::hasAvx2()) return blend16BitAvx2;
+    if (Cpu::hasSse41()) return blend16BitSse41;
+    return blend16BitGeneric;
+}
+//--------------------------------------------------------------------------------------------------
+static BlendPaletteFn selectBlendPalette()
+{
+    if (Cpu::hasAvx2()) return blendPaletteAvx2;
+    if (Cpu::hasSse41()) return blendPaletteSse41;
+    return blendPaletteGeneric;
+}
+//--------------------------------------------------------------------------------------------------
+
+#else
+
+//--------------------------------------------------------------------------------------------------
+static Blend16BitFn selectBlend16Bit()
+{
+    return blend16BitGeneric;
+}
+//--------------------------------------------------------------------------------------------------
+static BlendPaletteFn selectBlendPalette()
+{
+    return blendPaletteGeneric;
+}
+//--------------------------------------------------------------------------------------------------
+
+#endif
+
+//--------------------------------------------------------------------------------------------------
+void PixelKernel::blend16Bit(const Batch& batch, uint_t count, uint16_t* dst)
+{
+    static const Blend16BitFn fn = selectBlend16Bit();
+    fn(batch, count, dst);
+}
+//--------------------------------------------------------------------------------------------------
+void PixelKernel::blendPalette(const Batch& batch, uint_t count, const uint32_t* palette, uint_t shift, uint32_t* dst)
+{
+    static const BlendPaletteFn fn = selectBlendPalette();
+    fn(batch, count, palette, shift, dst);
+}
+//--------------------------------------------------------------------------------------------------
@@ -0,0 +1,45 @@
+#ifndef PIXELKERNEL_H_
+#define PIXELKERNEL_H_
+
+//------------------------------------------ Includes ----------------------------------------------
+
+#include "types/sdkTypes.h"
+
+//--------------------------------------- Class Definition -----------------------------------------
+
+namespace IslSdk
+{
+    namespace PixelKernel
+    {
+        const uint_t batchSize = 64;
+
+        /// Inputs for a run of consecutive pixels. Each pixel is blended from two samples along
+        /// the range of the first row (a0, a1), two samples of the second row (b0, b1) and then
+        /// across the two rows by weight w.
+        struct Batch
+        {
+            float_t a0[batchSize];
+            float_t a1[batchSize];
+            float_t w1[batchSize];
+            float_t b0[batchSize];
+            float_t b1[batchSize];
+            float_t w2[batchSize];
+            float_t w[batchSize];
+            uint32_t write[batchSize];          ///< All bits set if the pixel is written, else the destination is left untouched
+            uint32_t null[batchSize];           ///< All bits set if the pixel has no data and takes the null colour
+        };
+
+        void blend16Bit(const Batch& batch, uint_t count, uint16_t* dst);
+
+        /**
+        * @brief Blends a batch and writes the colours from \p palette.
+        * @param palette The colours, indexed by the blended amplitude shifted right by \p shift. The entry after
+        * the last (index 0x10000 >> shift) is the null colour. See Palette::lut().
+        * @param shift The amplitude shift, 16 - the number of palette index bits.
+        */
+        void blendPalette(const Batch& batch, uint_t count, const uint32_t* palette, uint_t shift, uint32_t* dst);
+    }
+}
+//--------------------------------------------------------------------------------------------------
+
+#endif
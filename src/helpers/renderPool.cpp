@@ -0,0 +1,93 @@
+//------------------------------------------ Includes ----------------------------------------------
+
+#include "renderPool.h"
+
+using namespace IslSdk;
+
+//--------------------------------------------------------------------------------------------------
+RenderPool::RenderPool(uint_t threadCount) : m_fn(nullptr), m_context(nullptr), m_taskCount(0), m_nextTask(0), m_busyCount(0), m_generation(0), m_exit(false)
+{
+    if (threadCount == 0)
+    {
+        uint_t hwThreads = std::thread::hardware_concurrency();
+        threadCount = hwThreads > 1 ? hwThreads - 1 : 0;
+    }
+
+    m_threads.reserve(threadCount);
+    for (uint_t i = 0; i < threadCount; i++)
+    {
+        m_threads.emplace_back(&RenderPool::worker, this);
+    }
+}
+//--------------------------------------------------------------------------------------------------
+RenderPool::~RenderPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_exit = true;
+    }
+    m_start.notify_all();
+
+    for (std::thread& thread : m_threads)
+    {
+        thread.join();
+    }
+}
+//--------------------------------------------------------------------------------------------------
+void RenderPool::run(uint_t taskCount, TaskFn fn, const void* context)
+{
+    std::lock_guard<std::mutex> runLock(m_runMutex);
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_fn = fn;
+        m_context = context;
+        m_taskCount = taskCount;
+        m_nextTask = 0;
+        m_busyCount = m_threads.size();
+        m_generation++;
+    }
+    m_start.notify_all();
+
+    execute();
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [this] { return m_busyCount == 0; });
+}
+//--------------------------------------------------------------------------------------------------
+void RenderPool::worker()
+{
+    uint_t generation = 0;
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    while (true)
+    {
+        m_start.wait(lock, [this, generation] { return m_exit || m_generation != generation; });
+
+        if (m_exit)
+        {
+            break;
+        }
+
+        generation = m_generation;
+        lock.unlock();
+        execute();
+        lock.lock();
+
+        if (--m_busyCount == 0)
+        {
+            m_done.notify_one();
+        }
+    }
+}
+//--------------------------------------------------------------------------------------------------
+void RenderPool::execute()
+{
+    uint_t idx;
+
+    while ((idx = m_nextTask++) < m_taskCount)
+    {
+        m_fn(m_context, idx);
+    }
+}
+//--------------------------------------------------------------------------------------------------
@@ -0,0 +1,71 @@
+#ifndef RENDERPOOL_H_
+#define RENDERPOOL_H_
+
+//------------------------------------------ Includes ----------------------------------------------
+
+#include "types/sdkTypes.h"
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+//--------------------------------------- Class Definition -----------------------------------------
+
+namespace IslSdk
+{
+    /// A pool of worker threads used by SonarImage to render tiles in parallel.
+    /// One pool can be shared by any number of SonarImage objects, calls to run() are serialised so
+    /// each image in turn is rendered using all the threads.
+    class RenderPool
+    {
+    public:
+        /**
+        * @brief Constructor.
+        * @param threadCount The number of worker threads. The thread calling run() also renders so
+        * the default of 0 creates one less thread than the number of hardware threads.
+        */
+        RenderPool(uint_t threadCount = 0);
+        ~RenderPool();
+
+        /**
+        * @brief Runs \p task(index) for every index from 0 to \p taskCount - 1 and returns when all are complete.
+        * Tasks are executed in any order and on any thread so must not depend on each other.
+        * @param taskCount The number of tasks.
+        * @param task A callable object taking a uint_t task index.
+        */
+        template<typename F> void run(uint_t taskCount, const F& task)
+        {
+            run(taskCount, &invoke<F>, &task);
+        }
+
+        uint_t threadCount() const { return m_threads.size() + 1; }     ///< Number of threads that execute tasks, including the caller of run()
+
+    private:
+        typedef void (*TaskFn)(const void* context, uint_t idx);
+        template<typename F> static void invoke(const void* context, uint_t idx)
+        {
+            (*static_cast<const F*>(context))(idx);
+        }
+
+        void run(uint_t taskCount, TaskFn fn, const void* context);
+        void worker();
+        void execute();
+
+        std::vector<std::thread> m_threads;
+        std::mutex m_runMutex;                  ///< Serialises calls to run() from different images or threads
+        std::mutex m_mutex;
+        std::condition_variable m_start;
+        std::condition_variable m_done;
+        TaskFn m_fn;
+        const void* m_context;
+        uint_t m_taskCount;
+        std::atomic<uint_t> m_nextTask;
+        uint_t m_busyCount;
+        uint_t m_generation;
+        bool_t m_exit;
+    };
+}
+
+//--------------------------------------------------------------------------------------------------
+#endif
@@ -0,0 +1,151 @@
+//------------------------------------------ Includes ----------------------------------------------
+
+#include "sonarAtlas.h"
+#include "maths/maths.h"
+
+using namespace IslSdk;
+
+//--------------------------------------------------------------------------------------------------
+SonarAtlas::SonarAtlas() : m_pixels(nullptr), m_width(0), m_height(0), m_stride(0), m_use4BytePixel(true), m_renderPool(nullptr)
+{
+}
+//--------------------------------------------------------------------------------------------------
+SonarAtlas::~SonarAtlas()
+{
+}
+//--------------------------------------------------------------------------------------------------
+void SonarAtlas::setBuffer(uint8_t* pixels, int32_t width, int32_t height, int32_t stride, bool_t use4BytePixel)
+{
+    m_pixels = pixels;
+    m_width = width;
+    m_height = height;
+    m_stride = stride;
+    m_use4BytePixel = use4BytePixel;
+    m_dirtyRects.clear();
+
+    for (View& view : m_views)
+    {
+        setViewBuffer(view);
+    }
+}
+//--------------------------------------------------------------------------------------------------
+uint_t SonarAtlas::addView(int32_t x, int32_t y, int32_t width, int32_t height)
+{
+    m_views.emplace_back(SonarImage::Box(x, y, width, height));
+    m_views.back().image.setRenderPool(m_renderPool);
+    setViewBuffer(m_views.back());
+
+    return static_cast<uint_t>(m_views.size() - 1);
+}
+//--------------------------------------------------------------------------------------------------
+void SonarAtlas::clearViews()
+{
+    m_views.clear();
+}
+//--------------------------------------------------------------------------------------------------
+void SonarAtlas::setRenderPool(RenderPool* pool)
+{
+    m_renderPool = pool;
+
+    for (View& view : m_views)
+    {
+        view.image.setRenderPool(pool);
+    }
+}
+//--------------------------------------------------------------------------------------------------
+void SonarAtlas::render(uint_t view, SonarDataStore& data, const Palette& palette, bool_t reDraw)
+{
+    if (m_views[view].image.width)
+    {
+        m_views[view].image.render(data, palette, reDraw);
+        addDirtyRects(m_views[view]);
+    }
+}
+//--------------------------------------------------------------------------------------------------
+void SonarAtlas::render16Bit(uint_t view, SonarDataStore& data, bool_t reDraw)
+{
+    if (m_views[view].image.width)
+    {
+        m_views[view].image.render16Bit(data, reDraw);
+        addDirtyRects(m_views[view]);
+    }
+}
+//--------------------------------------------------------------------------------------------------
+void SonarAtlas::renderTexture(uint_t view, SonarDataStore& data, const Palette& palette, bool_t reDraw)
+{
+    if (m_views[view].image.width)
+    {
+        m_views[view].image.renderTexture(data, palette, reDraw);
+        addDirtyRects(m_views[view]);
+    }
+}
+//--------------------------------------------------------------------------------------------------
+void SonarAtlas::renderTexture16Bit(uint_t view, SonarDataStore& data, bool_t reDraw)
+{
+    if (m_views[view].image.width)
+    {
+        m_views[view].image.renderTexture16Bit(data, reDraw);
+        addDirtyRects(m_views[view]);
+    }
+}
+//--------------------------------------------------------------------------------------------------
+void SonarAtlas::setViewBuffer(View& view)
+{
+    int32_t bpp = m_use4BytePixel ? 4 : 2;
+    int32_t x = Math::max(view.area.x, 0);
+    int32_t y = Math::max(view.area.y, 0);
+    int32_t width = Math::max(Math::min(view.area.x + view.area.width, m_width) - x, 0);
+    int32_t height = Math::max(Math::min(view.area.y + view.area.height, m_height) - y, 0);
+
+    if (m_pixels == nullptr || width == 0 || height == 0)
+    {
+        view.image.setBuffer(nullptr, 0, 0, 0, m_use4BytePixel);
+    }
+    else
+    {
+        view.image.setBuffer(m_pixels + y * m_stride + x * bpp, width, height, m_stride, m_use4BytePixel);
+    }
+}
+//--------------------------------------------------------------------------------------------------
+void SonarAtlas::addDirtyRects(const View& view)
+{
+    int32_t xOffset = Math::max(view.area.x, 0);
+    int32_t yOffset = Math::max(view.area.y, 0);
+
+    for (const SonarImage::Box& dirty : view.image.dirtyRects)
+    {
+        if (dirty.width <= 0 || dirty.height <= 0)
+        {
+            continue;
+        }
+
+        SonarImage::Box rect(dirty.x + xOffset, dirty.y + yOffset, dirty.width, dirty.height);
+
+        // Merge with any overlapping rect, repeating as the merged rect may now overlap others
+        uint_t i = 0;
+        while (i < m_dirtyRects.size())
+        {
+            const SonarImage::Box& other = m_dirtyRects[i];
+
+            if (rect.x < other.x + other.width && other.x < rect.x + rect.width && rect.y < other.y + other.height && other.y < rect.y + rect.height)
+            {
+                int32_t xEnd = Math::max(rect.x + rect.width, other.x + other.width);
+                int32_t yEnd = Math::max(rect.y + rect.height, other.y + other.height);
+                rect.x = Math::min(rect.x, other.x);
+                rect.y = Math::min(rect.y, other.y);
+                rect.width = xEnd - rect.x;
+                rect.height = yEnd - rect.y;
+
+                m_dirtyRects[i] = m_dirtyRects.back();
+                m_dirtyRects.pop_back();
+                i = 0;
+            }
+            else
+            {
+                i++;
+            }
+        }
+        m_dirtyRects.push_back(rect);
+    }
+}
+//--------------------------------------------------------------------------------------------------
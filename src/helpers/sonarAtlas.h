@@ -0,0 +1,91 @@
+#ifndef SONARATLAS_H_
+#define SONARATLAS_H_
+
+//------------------------------------------ Includes ----------------------------------------------
+
+#include "types/sdkTypes.h"
+#include "sonarImage.h"
+#include "sonarDataStore.h"
+#include "palette.h"
+#include "renderPool.h"
+#include <deque>
+#include <vector>
+
+//--------------------------------------- Class Definition -----------------------------------------
+
+namespace IslSdk
+{
+    /// Renders several sonar heads into viewports of one caller owned buffer, such as a texture atlas shared by
+    /// a multi head display. Each view is a SonarImage drawing straight into its part of the buffer, only the
+    /// changed areas are written and these are collected in dirtyRects so uploads to the display can be limited
+    /// to them.
+    class SonarAtlas
+    {
+    public:
+        const std::vector<SonarImage::Box>& dirtyRects = m_dirtyRects;  ///< Areas of the buffer changed since the last clearDirtyRects(), merged where they overlap
+
+        SonarAtlas();
+        ~SonarAtlas();
+
+        /**
+        * @brief Sets the buffer the views are rendered into. Existing views are moved to the new buffer and fully redrawn.
+        * @param pixels Address of the top left pixel. The buffer must outlive the atlas or be replaced first.
+        * @param width Width of the buffer in pixels.
+        * @param height Height of the buffer in pixels.
+        * @param stride Distance between rows in bytes.
+        * @param use4BytePixel True for palette colours, false for 16 bit amplitude.
+        */
+        void setBuffer(uint8_t* pixels, int32_t width, int32_t height, int32_t stride, bool_t use4BytePixel);
+
+        /**
+        * @brief Adds a view. The area is clipped to the buffer.
+        * @param x Left edge of the view in pixels.
+        * @param y Top edge of the view in pixels.
+        * @param width Width of the view in pixels.
+        * @param height Height of the view in pixels.
+        * @return The index of the view.
+        */
+        uint_t addView(int32_t x, int32_t y, int32_t width, int32_t height);
+        void clearViews();
+        uint_t viewCount() const { return static_cast<uint_t>(m_views.size()); }
+
+        /**
+        * @brief Gets the image of a view, used to set the sector area and interpolation of each head.
+        * @param idx The index of the view.
+        * @return The image.
+        */
+        SonarImage& view(uint_t idx) { return m_views[idx].image; }
+
+        void setRenderPool(RenderPool* pool);
+        void render(uint_t view, SonarDataStore& data, const Palette& palette, bool_t reDraw = false);
+        void render16Bit(uint_t view, SonarDataStore& data, bool_t reDraw = false);
+        void renderTexture(uint_t view, SonarDataStore& data, const Palette& palette, bool_t reDraw = false);
+        void renderTexture16Bit(uint_t view, SonarDataStore& data, bool_t reDraw = false);
+
+        /// Call once the dirty areas have been uploaded to the display.
+        void clearDirtyRects() { m_dirtyRects.clear(); }
+
+    private:
+        struct View
+        {
+            SonarImage image;
+            SonarImage::Box area;
+            View(const SonarImage::Box& area) : area(area) { }
+        };
+
+        void setViewBuffer(View& view);
+        void addDirtyRects(const View& view);
+
+        std::deque<View> m_views;               ///< A deque so adding views keeps the image addresses
+        std::vector<SonarImage::Box> m_dirtyRects;
+        uint8_t* m_pixels;
+        int32_t m_width;
+        int32_t m_height;
+        int32_t m_stride;
+        bool_t m_use4BytePixel;
+        RenderPool* m_renderPool;
+    };
+}
+
+//--------------------------------------------------------------------------------------------------
+#endif
@@ -7,8 +7,10 @@
 using namespace IslSdk;
 
 //--------------------------------------------------------------------------------------------------
-SonarDataStore::SonarDataStore() : m_resetSector(false)
+SonarDataStore::SonarDataStore(uint_t maxDataPoints) : m_rowSize(0), m_maxDataPoints(maxDataPoints), m_bitDepth(16), m_resetSector(false)
 {
+    m_pingData.fill(nullptr);
+    m_dirtySectors.reserve(maxDirtySectors);
 }
 //--------------------------------------------------------------------------------------------------
 SonarDataStore::~SonarDataStore()
@@ -16,6 +18,11 @@ SonarDataStore::~SonarDataStore()
 }
 //--------------------------------------------------------------------------------------------------
 bool_t SonarDataStore::add(const Sonar::Ping& ping, uint_t blankRangeMm)
+{
+    return add(Sonar::PingView(ping), blankRangeMm);
+}
+//--------------------------------------------------------------------------------------------------
+bool_t SonarDataStore::add(const Sonar::PingView& ping, uint_t blankRangeMm)
 {
     uint_t blank = 0;
 
@@ -28,15 +35,20 @@ bool_t SonarDataStore::add(const Sonar::Ping& ping, uint_t blankRangeMm)
         {
             m_resetSector = false;
             m_sector.size = 0;
+            m_dirtySectors.clear();
         }
 
         uint_t idx = wrap(ping.angle, static_cast<int_t>(stepSize) / -2);
-        std::shared_ptr<PingData> node = clearPingData(idx, stepSize);
-        updateSector(idx, stepSize);
+        uint_t dataPoints = Math::min(ping.count, m_maxDataPoints);
+        PingData* node = clearPingData(idx, stepSize);
 
-        if (node == nullptr)
+        if (node == nullptr || dataPoints > m_rowSize)
         {
-            node = std::make_shared<PingData>();
+            if (node)
+            {
+                m_freeNodes.push_back(node);
+            }
+            node = newNode(dataPoints);
         }
 
         node->startIdx = wrap(idx, -1);
@@ -44,13 +56,51 @@ bool_t SonarDataStore::add(const Sonar::Ping& ping, uint_t blankRangeMm)
         node->minRangeMm = ping.minRangeMm;
         node->maxRangeMm = ping.maxRangeMm;
         node->angle = ping.angle;
-        node->data = ping.data;
+        node->data.count = dataPoints;
+        node->slotCount = stepSize;
+        m_bitDepth = ping.bitDepth;
 
-        if (blankRangeMm > ping.minRangeMm)
+        if (dataPoints == ping.count)
         {
-            blank = static_cast<uint_t>(static_cast<float_t>(blankRangeMm - ping.minRangeMm) * (ping.data.size() / static_cast<float_t>(ping.maxRangeMm - ping.minRangeMm)));
-            blank = Math::min(blank, ping.data.size());
-            std::fill_n(node->data.begin(), blank, 0);
+            ping.copyTo(node->data.ptr, 0, dataPoints);
+        }
+        else
+        {
+            for (uint_t i = 0; i < dataPoints; i++)
+            {
+                node->data.ptr[i] = ping[(i * ping.count) / dataPoints];
+            }
+        }
+
+        // Pixels between the neighbouring pings and this one are interpolated from this data so are changed too
+        uint_t dirtyStart = idx;
+        uint_t dirtySize = stepSize;
+
+        if (m_pingData[node->startIdx])
+        {
+            uint_t dif = distance(idx, m_pingData[node->startIdx]->angle);
+            if (dif < Sonar::maxAngle / 4)
+            {
+                dirtyStart = m_pingData[node->startIdx]->angle;
+                dirtySize += dif;
+            }
+        }
+
+        if (m_pingData[node->endIdx])
+        {
+            uint_t dif = distance(m_pingData[node->endIdx]->angle, node->endIdx);
+            if (dif < Sonar::maxAngle / 4)
+            {
+                dirtySize += dif + 1;
+            }
+        }
+        updateSector(dirtyStart, dirtySize);
+
+        if (blankRangeMm > ping.minRangeMm && dataPoints)
+        {
+            blank = static_cast<uint_t>(static_cast<float_t>(blankRangeMm - ping.minRangeMm) * (dataPoints / static_cast<float_t>(ping.maxRangeMm - ping.minRangeMm)));
+            blank = Math::min(blank, dataPoints);
+            std::fill_n(node->data.ptr, blank, 0);
         }
 
         for (uint_t i = 0; i < stepSize; i++)
@@ -71,12 +121,81 @@ void SonarDataStore::clear(uint_t startAngle, int_t angleSize)
         angleSize = -angleSize;
     }
 
-    clearPingData(startAngle, static_cast<uint_t>(angleSize));
+    PingData* node = clearPingData(startAngle, static_cast<uint_t>(angleSize));
+    if (node)
+    {
+        m_freeNodes.push_back(node);
+    }
+}
+//--------------------------------------------------------------------------------------------------
+void SonarDataStore::setMaxDataPoints(uint_t maxDataPoints)
+{
+    if (maxDataPoints != m_maxDataPoints)
+    {
+        m_maxDataPoints = maxDataPoints;
+        m_pingData.fill(nullptr);
+        m_nodes.clear();
+        m_freeNodes.clear();
+        m_rows.clear();
+        m_rows.shrink_to_fit();
+        m_rowSize = 0;
+    }
+}
+//--------------------------------------------------------------------------------------------------
+SonarDataStore::PingData* SonarDataStore::newNode(uint_t dataPoints)
+{
+    if (dataPoints > m_rowSize)
+    {
+        resizeRows((dataPoints + 63) & ~static_cast<uint_t>(63), m_nodes.size());
+    }
+
+    if (m_freeNodes.empty())
+    {
+        uint_t first = m_nodes.size();
+        resizeRows(m_rowSize, first + rowsPerGrow);
+
+        for (uint_t i = 0; i < rowsPerGrow; i++)
+        {
+            m_nodes.emplace_back();
+            m_nodes.back().row = first + i;
+            m_nodes.back().data.ptr = m_rows.data() + (first + i) * m_rowSize;
+            m_freeNodes.push_back(&m_nodes.back());
+        }
+    }
+
+    PingData* node = m_freeNodes.back();
+    m_freeNodes.pop_back();
+
+    return node;
+}
+//--------------------------------------------------------------------------------------------------
+void SonarDataStore::resizeRows(uint_t rowSize, uint_t rowCount)
+{
+    if (rowSize != m_rowSize)
+    {
+        std::vector<uint16_t> rows(rowSize * rowCount);
+
+        for (PingData& node : m_nodes)
+        {
+            Mem::memcpy(rows.data() + node.row * rowSize, node.data.ptr, node.data.count * sizeof(uint16_t));
+        }
+        m_rows.swap(rows);
+        m_rowSize = rowSize;
+    }
+    else
+    {
+        m_rows.resize(rowSize * rowCount);
+    }
+
+    for (PingData& node : m_nodes)
+    {
+        node.data.ptr = m_rows.data() + node.row * m_rowSize;
+    }
 }
 //--------------------------------------------------------------------------------------------------
-std::shared_ptr<SonarDataStore::PingData> SonarDataStore::clearPingData(uint_t startIdx, uint_t angleSize)
+SonarDataStore::PingData* SonarDataStore::clearPingData(uint_t startIdx, uint_t angleSize)
 {
-    std::shared_ptr<PingData> node;
+    PingData* node = nullptr;
 
     if (angleSize)
     {
@@ -91,7 +210,7 @@ std::shared_ptr<SonarDataStore::PingData> SonarDataStore::clearPingData(uint_t s
 
         uint_t endIdx = wrap(startIdx, static_cast<int_t>(angleSize));
 
-        if (m_pingData[endIdx] && m_pingData[startIdx] && (m_pingData[startIdx].get() != m_pingData[endIdx].get()))
+        if (m_pingData[endIdx] && m_pingData[startIdx] && (m_pingData[startIdx] != m_pingData[endIdx]))
         {
             m_pingData[endIdx]->startIdx = wrap(endIdx, -1);
             if (distance(m_pingData[endIdx]->angle, m_pingData[endIdx]->startIdx) > (Sonar::maxAngle / 2))
@@ -102,13 +221,22 @@ std::shared_ptr<SonarDataStore::PingData> SonarDataStore::clearPingData(uint_t s
 
         for (uint_t i = 0; i < angleSize; i++)
         {
-            if (m_pingData[startIdx])
+            PingData* slot = m_pingData[startIdx];
+
+            if (slot)
             {
-                if (!node && m_pingData[startIdx].use_count() == 1)
+                if (--slot->slotCount == 0)
                 {
-                    node = m_pingData[startIdx];
+                    if (node)
+                    {
+                        m_freeNodes.push_back(slot);
+                    }
+                    else
+                    {
+                        node = slot;
+                    }
                 }
-                m_pingData[startIdx].reset();
+                m_pingData[startIdx] = nullptr;
             }
             startIdx = wrap(startIdx, 1);
         }
@@ -118,32 +246,88 @@ std::shared_ptr<SonarDataStore::PingData> SonarDataStore::clearPingData(uint_t s
 //--------------------------------------------------------------------------------------------------
 void SonarDataStore::updateSector(uint_t angle, uint_t sectorSize)
 {
-    if (m_sector.size == 0)
-    {
-        m_sector.start = angle;
-        m_sector.size = sectorSize;
-    }
-    else
+    Sonar::Sector sector;
+    sector.start = angle;
+    sector.size = sectorSize;
+
+    mergeSector(m_sector, sector);
+
+    // Fold in every dirty sector that touches the new one, or the closest one if the list is full
+    while (!m_dirtySectors.empty())
     {
-        uint_t dif = distance(angle, m_sector.start);
+        uint_t closest = 0;
+        uint_t minGap = Sonar::maxAngle;
 
-        if (dif > m_sector.size)
+        for (uint_t i = 0; i < m_dirtySectors.size(); i++)
         {
-            if ((dif - m_sector.size) <= (Sonar::maxAngle - dif))
-            {
-                m_sector.size += (dif - m_sector.size) + sectorSize;
-            }
-            else
+            uint_t gap = sectorGap(m_dirtySectors[i], sector);
+            if (gap < minGap)
             {
-                m_sector.start = angle;
-                m_sector.size += Sonar::maxAngle - dif;
-                if (m_sector.size < sectorSize)
-                {
-                    m_sector.size += sectorSize - m_sector.size;
-                }
+                minGap = gap;
+                closest = i;
             }
         }
+
+        if (minGap != 0 && m_dirtySectors.size() < maxDirtySectors)
+        {
+            break;
+        }
+
+        mergeSector(sector, m_dirtySectors[closest]);
+        m_dirtySectors[closest] = m_dirtySectors.back();
+        m_dirtySectors.pop_back();
+    }
+
+    m_dirtySectors.push_back(sector);
+}
+//--------------------------------------------------------------------------------------------------
+void SonarDataStore::mergeSector(Sonar::Sector& sector, const Sonar::Sector& other) const
+{
+    if (sector.size == 0)
+    {
+        sector = other;
+    }
+    else if (other.size)
+    {
+        uint_t fwd = distance(other.start, sector.start);
+        uint_t bwd = distance(sector.start, other.start);
+
+        if (fwd <= sector.size)
+        {
+            sector.size = Math::max(sector.size, fwd + other.size);
+        }
+        else if (bwd <= other.size)
+        {
+            sector.start = other.start;
+            sector.size = Math::max(other.size, bwd + sector.size);
+        }
+        else if ((fwd + other.size) <= (bwd + sector.size))
+        {
+            sector.size = fwd + other.size;
+        }
+        else
+        {
+            sector.start = other.start;
+            sector.size = bwd + sector.size;
+        }
+
+        if (sector.size > Sonar::maxAngle)
+        {
+            sector.size = Sonar::maxAngle;
+        }
+    }
+}
+//--------------------------------------------------------------------------------------------------
+uint_t SonarDataStore::sectorGap(const Sonar::Sector& sector1, const Sonar::Sector& sector2) const
+{
+    uint_t fwd = distance(sector2.start, sector1.start);
+    uint_t bwd = distance(sector1.start, sector2.start);
+
+    if (fwd <= sector1.size || bwd <= sector2.size)
+    {
+        return 0;
     }
+    return Math::min(fwd - sector1.size, bwd - sector2.size);
 }
 //--------------------------------------------------------------------------------------------------
 uint_t SonarDataStore::wrap(uint_t v1, int_t v2) const
@@ -7,17 +7,44 @@
 #include "devices/sonar.h"
 #include <vector>
 #include <array>
+#include <deque>
 
 //--------------------------------------- Class Definition -----------------------------------------
 
 namespace IslSdk
 {
+    /**
+    * @brief Holds the latest ping at each angle of a sweep, for rendering with SonarImage.
+    * Pings are stored in recycled fixed size rows rather than one allocation each, so the data isn't owned by the
+    * caller. A PingData from pingData, and the Samples it holds, are only valid until the next call to add(), clear()
+    * or setMaxDataPoints(): a ping is recycled for new data once every angle it covered has been overwritten, and
+    * growing the row buffer moves the data of every ping. Copy the data to keep it.
+    */
     class SonarDataStore
     {
     public:
-        SonarDataStore();
+        /**
+        * @brief Constructor.
+        * @param maxDataPoints The most data points stored per ping. Pings with more points are decimated to this.
+        * Memory use is at most (Sonar::maxAngle / stepSize + 1) * maxDataPoints * 2 bytes.
+        */
+        SonarDataStore(uint_t maxDataPoints = 4096);
         ~SonarDataStore();
 
+        struct Samples                          ///< The data points of a ping, held in the store's row buffer. Reads like the std::vector it replaced.
+        {
+            uint16_t* ptr;
+            uint_t count;
+
+            Samples() : ptr(nullptr), count(0) {}
+            uint_t size() const { return count; }
+            bool_t empty() const { return count == 0; }
+            const uint16_t* data() const { return ptr; }
+            uint16_t operator[](uint_t idx) const { return ptr[idx]; }
+            const uint16_t* begin() const { return ptr; }
+            const uint16_t* end() const { return ptr + count; }
+        };
+
         struct PingData
         {
             uint_t startIdx;
@@ -25,28 +52,49 @@ namespace IslSdk
             uint_t minRangeMm;
             uint_t maxRangeMm;
             uint_t angle;
-            std::vector<uint16_t> data;
+            Samples data;
+            uint_t row;                         ///< Index of the row in the row buffer that holds the data
+            uint_t slotCount;                   ///< Number of angles that reference this ping, it is recycled when this reaches 0
 
-            PingData() : startIdx(0), endIdx(0), minRangeMm(0), maxRangeMm(0), angle(0) {}
+            PingData() : startIdx(0), endIdx(0), minRangeMm(0), maxRangeMm(0), angle(0), row(0), slotCount(0) {}
         };
 
-        typedef std::shared_ptr<PingData> SharedPtr;
+        typedef PingData* SharedPtr;            ///< Kept so code written against the shared_ptr version still compiles, it no longer owns the ping. See the class description.
+
+        static const uint_t maxDirtySectors = 8;                ///< Maximum number of separate dirty sectors, closest sectors are merged beyond this
 
-        const Sonar::Sector& sector = m_sector;
-        const std::array<SharedPtr, Sonar::maxAngle>& pingData = m_pingData;
+        const Sonar::Sector& sector = m_sector;                 ///< A single sector covering all angles changed since the last renderComplete()
+        const std::vector<Sonar::Sector>& dirtySectors = m_dirtySectors;   ///< The angles changed since the last renderComplete() as a list of non overlapping sectors
+        const std::array<PingData*, Sonar::maxAngle>& pingData = m_pingData;       ///< The ping at each angle or nullptr, valid until the next add(), clear() or setMaxDataPoints()
+        const uint_t& bitDepth = m_bitDepth;                    ///< Bit depth of the data of the last ping added, 8 or 16
 
         bool_t add(const Sonar::Ping& ping, uint_t blankRangeMm = 0);
+        bool_t add(const Sonar::PingView& ping, uint_t blankRangeMm = 0);
         void clear(uint_t startAngle = 0, int_t angleSize = Sonar::maxAngle);
         void renderComplete() { m_resetSector = true; }
+        void setMaxDataPoints(uint_t maxDataPoints);
 
     private:
-        std::array<SharedPtr, Sonar::maxAngle> m_pingData;
-        SonarDataStore::SharedPtr clearPingData(uint_t startAngle, uint_t angleSize);
+        static const uint_t rowsPerGrow = 64;
+
+        std::array<PingData*, Sonar::maxAngle> m_pingData;
+        std::deque<PingData> m_nodes;           ///< All ping nodes, a deque so growing keeps node addresses
+        std::vector<PingData*> m_freeNodes;
+        std::vector<uint16_t> m_rows;           ///< Row buffer, one fixed size row of m_rowSize data points per node
+        uint_t m_rowSize;
+        uint_t m_maxDataPoints;
+        uint_t m_bitDepth;
+        PingData* newNode(uint_t dataPoints);
+        void resizeRows(uint_t rowSize, uint_t rowCount);
+        PingData* clearPingData(uint_t startAngle, uint_t angleSize);
         void updateSector(uint_t angle, uint_t sectorSize);
+        void mergeSector(Sonar::Sector& sector, const Sonar::Sector& other) const;
+        uint_t sectorGap(const Sonar::Sector& sector1, const Sonar::Sector& sector2) const;
         inline uint_t wrap(uint_t v1, int_t v2) const;
         inline uint_t distance(uint_t v1, uint_t v2) const;
         bool_t m_resetSector;
         Sonar::Sector m_sector;
+        std::vector<Sonar::Sector> m_dirtySectors;
     };
 }
 
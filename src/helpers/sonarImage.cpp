@@ -2,21 +2,29 @@
 
 #include "sonarImage.h"
 #include "maths/maths.h"
+#include <algorithm>
 
 using namespace IslSdk;
 
 //--------------------------------------------------------------------------------------------------
-SonarImage::SonarImage() : m_width(0), m_height(0), m_bpp(0), m_minRangeMm(0), m_maxRangeMm(0), useBilinerInterpolation(true)
+SonarImage::SonarImage() : m_pixels(nullptr), m_stride(0), m_width(0), m_height(0), m_bpp(0), m_minRangeMm(0), m_maxRangeMm(0), useBilinerInterpolation(true), paletteBits(0), m_box(0, 0, 0, 0), m_polarLutValid(false), m_paletteShift(0), m_renderPool(nullptr)
 {
     setSectorArea(0, 10000, 0, Sonar::maxAngle);
 }
 //--------------------------------------------------------------------------------------------------
-SonarImage::SonarImage(int32_t width, int32_t height, bool_t use4BytePixel, bool_t useBilinerInterpolation) : m_width(0),
+SonarImage::SonarImage(int32_t width, int32_t height, bool_t use4BytePixel, bool_t useBilinerInterpolation) : m_pixels(nullptr),
+m_stride(0),
+m_width(0),
 m_height(0),
 m_bpp(0),
 m_minRangeMm(0),
 m_maxRangeMm(0),
-useBilinerInterpolation(useBilinerInterpolation)
+useBilinerInterpolation(useBilinerInterpolation),
+paletteBits(0),
+m_box(0, 0, 0, 0),
+m_polarLutValid(false),
+m_paletteShift(0),
+m_renderPool(nullptr)
 {
     setBuffer(width, height, use4BytePixel);
     setSectorArea(0, 10000, 0, Sonar::maxAngle);
@@ -30,18 +38,33 @@ void SonarImage::setBuffer(int32_t width, int32_t height, bool_t use4BytePixel)
 {
     uint8_t bpp = static_cast<uint8_t>(use4BytePixel ? 4 : 2);
 
+    m_buf.resize(width * height * bpp);
+    setPixels(m_buf.data(), width, height, width * bpp, bpp);
+}
+//--------------------------------------------------------------------------------------------------
+void SonarImage::setBuffer(uint8_t* pixels, int32_t width, int32_t height, int32_t stride, bool_t use4BytePixel)
+{
+    m_buf.clear();
+    m_buf.shrink_to_fit();
+    setPixels(pixels, width, height, stride, static_cast<uint8_t>(use4BytePixel ? 4 : 2));
+}
+//--------------------------------------------------------------------------------------------------
+void SonarImage::setPixels(uint8_t* pixels, int32_t width, int32_t height, int32_t stride, uint8_t bpp)
+{
     if (m_width != width || m_height != height || m_bpp != bpp)
     {
         m_width = width;
         m_height = height;
         m_bpp = bpp;
-
-        m_buf.resize(width * height * bpp);
+        updateGeometry();
         m_redraw = true;
+    }
 
-        float_t precision = 100000.0f;
-        Box box = minBoundingBox(m_sector, precision);
-        m_radius = Math::min(m_width / (static_cast<float_t>(box.width) / precision), m_height / (static_cast<float_t>(box.height) / precision));
+    if (m_pixels != pixels || m_stride != stride)
+    {
+        m_pixels = pixels;
+        m_stride = stride;
+        m_redraw = true;
     }
 }
 //--------------------------------------------------------------------------------------------------
@@ -59,132 +82,50 @@ void SonarImage::setSectorArea(uint_t minRangeMm, uint_t maxRangeMm, uint_t sect
         m_sector.start = sectorStart;
         m_sector.size = sectorSize;
         m_redraw = true;
-
-        float_t precision = 100000.0f;
-        Box box = minBoundingBox(m_sector, precision);
-        m_radius = Math::min(m_width / (static_cast<float_t>(box.width) / precision), m_height / (static_cast<float_t>(box.height) / precision));
+        updateGeometry();
     }
 }
 //--------------------------------------------------------------------------------------------------
 void SonarImage::render(SonarDataStore& data, const Palette& palette, bool_t reDraw)
 {
-    Sonar::Sector sector = data.sector;
+    bool_t fullRedraw = reDraw || m_redraw;
 
-    if (reDraw || m_redraw)
+    m_dirtyRects.clear();
+    if (fullRedraw)
     {
         m_redraw = false;
-        sector = m_sector;
-        std::fill(m_buf.begin(), m_buf.end(), palette.data[0x10000].val);
-    }
-    else
-    {
-        cropSector(m_sector, sector);
+        fill(palette.data[0x10000].val);
     }
 
-    if (sector.size && m_bpp == 4)
+    if (m_bpp == 4)
     {
-        Box box = minBoundingBox(sector, m_radius);
-        float_t radius2 = m_radius * m_radius;
-
-        for (int32_t y = box.y; y < box.height + box.y; y++)
+        uint_t bits = paletteBits;
+        if (bits == 0)
         {
-            uint32_t* img = reinterpret_cast<uint32_t*>(&m_buf[((box.height - 1) - (y - box.y)) * m_width * 4]);
-
-            for (int32_t x = box.x; x < box.width + box.x; x++)
-            {
-                float_t rad2 = static_cast<float_t>(x * x + y * y);
-
-                if (rad2 < radius2)
-                {
-                    float_t angle = Math::atan2(static_cast<float_t>(x), static_cast<float_t>(y)) * static_cast<float_t>(Sonar::maxAngle / Math::pi2);
-                    if (angle < 0.0f)
-                    {
-                        angle += Sonar::maxAngle;
-                    }
-
-                    int32_t dif = static_cast<int32_t>(angle - sector.start);
-                    if (dif < 0)
-                    {
-                        dif += Sonar::maxAngle;
-                    }
-
-                    if (dif <= sector.size)
-                    {
-                        RenderData renderData = getData(data, angle, m_radius);
-                        uint32_t pix = 0x10000;
-                        if (renderData.row1)
-                        {
-                            pix = calculatePixel(renderData, Math::sqrt(rad2));
-                        }
-                        *img = palette.data[pix].val;
-                    }
-                }
-                img++;
-            }
+            bits = data.bitDepth == 8 ? 8 : 16;
         }
-        data.renderComplete();
+        else if (bits != 8 && bits != 10 && bits != 12)
+        {
+            bits = 16;
+        }
+
+        m_paletteShift = 16 - bits;
+        renderPolar(data, palette.lut(bits), fullRedraw);
     }
 }
 //--------------------------------------------------------------------------------------------------
 void SonarImage::render16Bit(SonarDataStore& data, bool_t reDraw)
 {
-    Sonar::Sector sector = data.sector;
+    bool_t fullRedraw = reDraw || m_redraw;
 
-    if (reDraw || m_redraw)
+    m_dirtyRects.clear();
+    if (fullRedraw)
     {
         m_redraw = false;
-        sector = m_sector;
-        std::fill(m_buf.begin(), m_buf.end(), 0);
-    }
-    else
-    {
-        cropSector(m_sector, sector);
+        fill(0);
     }
 
-    if (sector.size)
-    {
-        Box box = minBoundingBox(sector, m_radius);
-        float_t radius2 = m_radius * m_radius;
-
-        for (int32_t y = box.y; y < box.height + box.y; y++)
-        {
-            uint16_t* img = reinterpret_cast<uint16_t*>(&m_buf[((box.height - 1) - (y - box.y)) * m_width * 2]);
-
-            for (int32_t x = box.x; x < box.width + box.x; x++)
-            {
-                float_t rad2 = static_cast<float_t>(x * x + y * y);
-
-                if (rad2 < radius2)
-                {
-                    float_t angle = Math::atan2(static_cast<float_t>(x), static_cast<float_t>(y)) * static_cast<float_t>(Sonar::maxAngle / Math::pi2);
-                    if (angle < 0.0f)
-                    {
-                        angle += Sonar::maxAngle;
-                    }
-
-                    int32_t dif = static_cast<int32_t>(angle - sector.start);
-                    if (dif < 0)
-                    {
-                        dif += Sonar::maxAngle;
-                    }
-
-                    if (dif <= sector.size)
-                    {
-                        RenderData renderData = getData(data, angle, m_radius);
-                        uint16_t pix = 0;
-                        if (renderData.row1)
-                        {
-                            pix = calculatePixel(renderData, Math::sqrt(rad2));
-                        }
-
-                        *img = pix;
-                    }
-                }
-                img++;
-            }
-        }
-        data.renderComplete();
-    }
+    renderPolar(data, nullptr, fullRedraw);
 }
 //--------------------------------------------------------------------------------------------------
 bool_t SonarImage::renderTexture(SonarDataStore& data, const Palette& palette, bool_t reDraw)
@@ -192,11 +133,12 @@ bool_t SonarImage::renderTexture(SonarDataStore& data, const Palette& palette, b
     bool_t modified = false;
     Sonar::Sector sector = data.sector;
 
+    m_dirtyRects.clear();
     if (reDraw || m_redraw)
     {
         m_redraw = false;
         sector = m_sector;
-        std::fill(m_buf.begin(), m_buf.end(), palette.data[0x10000].val);
+        fill(palette.data[0x10000].val);
     }
     else
     {
@@ -215,19 +157,20 @@ bool_t SonarImage::renderTexture(SonarDataStore& data, const Palette& palette, b
         int32_t yCount = static_cast<int32_t>((yScale * sector.size) + 0.5f);
         modified = yCount != 0;
         yScale = 1.0f / yScale;
-
-        uint32_t* img = reinterpret_cast<uint32_t*>(&m_buf[y * m_width * 4]);
+        addRowRects(y, yCount);
 
         while (yCount--)
         {
-            float_t angle = y * yScale + offset;
-            if (angle >= data.pingData.size()) angle -= data.pingData.size();
-            if (++y > m_height)
+            if (y >= m_height)
             {
                 y = 0;
-                img = reinterpret_cast<uint32_t*>(&m_buf[0]);
             }
 
+            uint32_t* img = reinterpret_cast<uint32_t*>(row(y));
+            float_t angle = y * yScale + offset;
+            if (angle >= data.pingData.size()) angle -= data.pingData.size();
+            y++;
+
             RenderData renderData = getData(data, angle, static_cast<float_t>(m_width));
 
             if (renderData.row1)
@@ -257,11 +200,12 @@ bool_t SonarImage::renderTexture16Bit(SonarDataStore& data, bool_t reDraw)
     bool_t modified = false;
     Sonar::Sector sector = data.sector;
 
+    m_dirtyRects.clear();
     if (reDraw || m_redraw)
     {
         m_redraw = false;
         sector = m_sector;
-        std::fill(m_buf.begin(), m_buf.end(), 0);
+        fill(0);
     }
     else
     {
@@ -280,19 +224,20 @@ bool_t SonarImage::renderTexture16Bit(SonarDataStore& data, bool_t reDraw)
         int32_t yCount = static_cast<int32_t>((yScale * sector.size) + 0.5f);
         modified = yCount != 0;
         yScale = 1.0f / yScale;
-
-        uint16_t* img = reinterpret_cast<uint16_t*>(&m_buf[y * m_width * 2]);
+        addRowRects(y, yCount);
 
         while (yCount--)
         {
-            float_t angle = y * yScale + offset;
-            if (angle >= data.pingData.size()) angle -= data.pingData.size();
-            if (++y > m_height)
+            if (y >= m_height)
             {
                 y = 0;
-                img = reinterpret_cast<uint16_t*>(&m_buf[0]);
             }
 
+            uint16_t* img = reinterpret_cast<uint16_t*>(row(y));
+            float_t angle = y * yScale + offset;
+            if (angle >= data.pingData.size()) angle -= data.pingData.size();
+            y++;
+
             RenderData renderData = getData(data, angle, static_cast<float_t>(m_width));
 
             if (renderData.row1)
@@ -305,7 +250,6 @@ bool_t SonarImage::renderTexture16Bit(SonarDataStore& data, bool_t reDraw)
             else
             {
                 Mem::memset(img, 0, m_width * 2);
-                img += m_width;
             }
         }
 
@@ -352,6 +296,214 @@ uint16_t SonarImage::calculatePixel(const RenderData& renderData, float_t range)
     return static_cast<uint16_t>(pix);
 }
 //--------------------------------------------------------------------------------------------------
+void SonarImage::renderPolar(SonarDataStore& data, const uint32_t* colours, bool_t fullRedraw)
+{
+    if (!m_polarLutValid)
+    {
+        buildPolarLut();
+    }
+
+    if (fullRedraw)
+    {
+        renderArea(data, colours, m_sector, imageArea(m_sector));
+        data.renderComplete();
+    }
+    else if (data.sector.size)
+    {
+        for (const Sonar::Sector& dirty : data.dirtySectors)
+        {
+            Sonar::Sector sector = dirty;
+            cropSector(m_sector, sector);
+
+            if (sector.size)
+            {
+                renderSector(data, colours, sector);
+                m_dirtyRects.push_back(imageArea(sector));
+            }
+        }
+        data.renderComplete();
+    }
+}
+//--------------------------------------------------------------------------------------------------
+void SonarImage::renderArea(const SonarDataStore& data, const uint32_t* colours, const Sonar::Sector& sector, const Box& area)
+{
+    if (m_renderPool && m_renderPool->threadCount() > 1)
+    {
+        // Several tiles per thread so threads that finish early can pick up more work
+        int32_t tileRows = Math::max<int32_t>(8, area.height / static_cast<int32_t>(m_renderPool->threadCount() * 4));
+        uint_t tileCount = static_cast<uint_t>((area.height + tileRows - 1) / tileRows);
+
+        m_renderPool->run(tileCount, [&](uint_t tile)
+        {
+            int32_t yStart = area.y + static_cast<int32_t>(tile) * tileRows;
+            renderRows(data, colours, sector, area, yStart, Math::min(yStart + tileRows, area.y + area.height));
+        });
+    }
+    else
+    {
+        renderRows(data, colours, sector, area, area.y, area.y + area.height);
+    }
+}
+//--------------------------------------------------------------------------------------------------
+void SonarImage::renderSector(const SonarDataStore& data, const uint32_t* colours, const Sonar::Sector& sector)
+{
+    // Only the spans in buckets overlapping the sector are visited, loadBatch() trims pixels at the sector edges
+    uint_t firstBucket = sector.start / bucketAngle;
+    uint_t bucketCount = (sector.start + sector.size) / bucketAngle - firstBucket + 1;
+    if (bucketCount > spanBuckets)
+    {
+        bucketCount = spanBuckets;
+    }
+
+    auto renderBucket = [&](uint_t idx)
+    {
+        uint_t bucket = (firstBucket + idx) % spanBuckets;
+
+        for (uint_t i = m_bucketStart[bucket]; i < m_bucketStart[bucket + 1]; i++)
+        {
+            const Span& span = m_spans[i];
+            renderRun(data, colours, sector, span.y, span.x, span.width);
+        }
+    };
+
+    if (m_renderPool && m_renderPool->threadCount() > 1)
+    {
+        m_renderPool->run(bucketCount, renderBucket);
+    }
+    else
+    {
+        for (uint_t i = 0; i < bucketCount; i++)
+        {
+            renderBucket(i);
+        }
+    }
+}
+//--------------------------------------------------------------------------------------------------
+void SonarImage::renderRows(const SonarDataStore& data, const uint32_t* colours, const Sonar::Sector& sector, const Box& area, int32_t yStart, int32_t yEnd)
+{
+    for (int32_t y = yStart; y < yEnd; y++)
+    {
+        renderRun(data, colours, sector, y, area.x, area.width);
+    }
+}
+//--------------------------------------------------------------------------------------------------
+void SonarImage::renderRun(const SonarDataStore& data, const uint32_t* colours, const Sonar::Sector& sector, int32_t y, int32_t x, int32_t width)
+{
+    PixelKernel::Batch batch;
+    const PolarPixel* lut = &m_polarLut[y * m_width + x];
+
+    for (int32_t i = 0; i < width; i += PixelKernel::batchSize)
+    {
+        uint_t count = Math::min<uint_t>(PixelKernel::batchSize, width - i);
+
+        if (loadBatch(batch, data, lut + i, count, sector))
+        {
+            if (colours)
+            {
+                uint32_t* img = reinterpret_cast<uint32_t*>(row(y)) + x;
+                PixelKernel::blendPalette(batch, count, colours, m_paletteShift, img + i);
+            }
+            else
+            {
+                uint16_t* img = reinterpret_cast<uint16_t*>(row(y)) + x;
+                PixelKernel::blend16Bit(batch, count, img + i);
+            }
+        }
+    }
+}
+//--------------------------------------------------------------------------------------------------
+uint_t SonarImage::loadBatch(PixelKernel::Batch& batch, const SonarDataStore& data, const PolarPixel* lut, uint_t count, const Sonar::Sector& sector) const
+{
+    uint_t written = 0;
+    uint_t cachedIdx = Sonar::maxAngle;
+    RenderData renderData;
+
+    for (uint_t i = 0; i < count; i++)
+    {
+        batch.a0[i] = 0.0f;
+        batch.a1[i] = 0.0f;
+        batch.w1[i] = 0.0f;
+        batch.b0[i] = 0.0f;
+        batch.b1[i] = 0.0f;
+        batch.w2[i] = 0.0f;
+        batch.w[i] = 0.0f;
+        batch.write[i] = 0;
+        batch.null[i] = 0;
+
+        if (lut[i].angle < 0.0f)
+        {
+            continue;
+        }
+
+        int32_t dif = static_cast<int32_t>(lut[i].angle - sector.start);
+        if (dif < 0)
+        {
+            dif += Sonar::maxAngle;
+        }
+
+        if (static_cast<uint_t>(dif) > sector.size)
+        {
+            continue;
+        }
+
+        batch.write[i] = 0xffffffff;
+        written++;
+
+        // The rows, scales and offsets only change with the integer angle so neighbouring pixels share them
+        uint_t angleIdx = static_cast<uint_t>(lut[i].angle);
+        if (angleIdx != cachedIdx)
+        {
+            renderData = getData(data, lut[i].angle, m_radius);
+            cachedIdx = angleIdx;
+        }
+        else if (renderData.row2)
+        {
+            renderData.w = angleWeight(renderData, lut[i].angle);
+        }
+
+        if (!renderData.row1)
+        {
+            batch.null[i] = 0xffffffff;
+            continue;
+        }
+
+        // Same sampling as calculatePixel, the blend is done by the kernel
+        float_t idx = (lut[i].range * renderData.scale1) + renderData.offset1;
+        int_t intIdx = static_cast<int_t>(idx);
+        int_t size = static_cast<int_t>(renderData.row1->data.size());
+
+        if (intIdx >= 0 && intIdx < size)
+        {
+            batch.w1[i] = idx - intIdx;
+            batch.a0[i] = renderData.row1->data[intIdx];
+            if (intIdx < size - 1)
+            {
+                batch.a1[i] = renderData.row1->data[intIdx + 1];
+            }
+        }
+
+        if (renderData.row2)
+        {
+            idx = (lut[i].range * renderData.scale2) + renderData.offset2;
+            intIdx = static_cast<int_t>(idx);
+            size = static_cast<int_t>(renderData.row2->data.size());
+
+            if (intIdx >= 0 && intIdx < size)
+            {
+                batch.w2[i] = idx - intIdx;
+                batch.b0[i] = renderData.row2->data[intIdx];
+                if (intIdx < size - 1)
+                {
+                    batch.b1[i] = renderData.row2->data[intIdx + 1];
+                }
+                batch.w[i] = renderData.w;
+            }
+        }
+    }
+
+    return written;
+}
+//--------------------------------------------------------------------------------------------------
 SonarImage::RenderData SonarImage::getData(const SonarDataStore& data, float_t angle, float_t width) const
 {
     RenderData ret;
@@ -391,18 +543,7 @@ SonarImage::RenderData SonarImage::getData(const SonarDataStore& data, float_t a
                 ret.scale2 = (ret.row2->data.size() / width) * (imgRange / range);
                 ret.offset2 = (ret.row2->data.size() / range) * minDif;
 
-                float_t dif1 = Math::abs(angle - static_cast<float_t>(ret.row1->angle));
-                if (dif1 > (Sonar::maxAngle / 2))
-                {
-                    dif1 = Sonar::maxAngle - dif1;
-                }
-
-                float_t dif2 = Math::abs(ret.row1->angle - static_cast<float_t>(ret.row2->angle));
-                if (dif2 > (Sonar::maxAngle / 2))
-                {
-                    dif2 = Sonar::maxAngle - dif2;
-                }
-                ret.w = dif1 / dif2;
+                ret.w = angleWeight(ret, angle);
             }
         }
         float_t range = static_cast<float_t>(static_cast<int_t>(ret.row1->maxRangeMm - ret.row1->minRangeMm));
@@ -413,6 +554,22 @@ SonarImage::RenderData SonarImage::getData(const SonarDataStore& data, float_t a
     return ret;
 }
 //--------------------------------------------------------------------------------------------------
+float_t SonarImage::angleWeight(const RenderData& renderData, float_t angle) const
+{
+    float_t dif1 = Math::abs(angle - static_cast<float_t>(renderData.row1->angle));
+    if (dif1 > (Sonar::maxAngle / 2))
+    {
+        dif1 = Sonar::maxAngle - dif1;
+    }
+
+    float_t dif2 = Math::abs(renderData.row1->angle - static_cast<float_t>(renderData.row2->angle));
+    if (dif2 > (Sonar::maxAngle / 2))
+    {
+        dif2 = Sonar::maxAngle - dif2;
+    }
+    return dif1 / dif2;
+}
+//--------------------------------------------------------------------------------------------------
 void SonarImage::cropSector(const Sonar::Sector& window, Sonar::Sector& sector) const
 {
     int_t dif = static_cast<int_t>(sector.start - window.start);
@@ -512,6 +669,157 @@ SonarImage::Box SonarImage::minBoundingBox(const Sonar::Sector& sector, float_t
     return box;
 }
 //--------------------------------------------------------------------------------------------------
+SonarImage::Box SonarImage::imageArea(const Sonar::Sector& sector) const
+{
+    Box box = minBoundingBox(sector, m_radius);
+
+    // Convert to buffer coordinates, image y runs top down. Grow by a pixel to cover rounding in minBoundingBox
+    int32_t x = box.x - m_box.x - 1;
+    int32_t y = (m_box.y + m_box.height) - (box.y + box.height) - 1;
+    int32_t xEnd = Math::min(x + box.width + 2, m_width);
+    int32_t yEnd = Math::min(y + box.height + 2, m_height);
+    x = Math::max(x, 0);
+    y = Math::max(y, 0);
+
+    return Box(x, y, Math::max(xEnd - x, 0), Math::max(yEnd - y, 0));
+}
+//--------------------------------------------------------------------------------------------------
+void SonarImage::fill(uint32_t value)
+{
+    for (int32_t y = 0; y < m_height; y++)
+    {
+        if (m_bpp == 4)
+        {
+            std::fill_n(reinterpret_cast<uint32_t*>(row(y)), m_width, value);
+        }
+        else
+        {
+            std::fill_n(reinterpret_cast<uint16_t*>(row(y)), m_width, static_cast<uint16_t>(value));
+        }
+    }
+    m_dirtyRects.assign(1, Box(0, 0, m_width, m_height));
+}
+//--------------------------------------------------------------------------------------------------
+void SonarImage::addRowRects(int32_t y, int32_t count)
+{
+    if (m_dirtyRects.size() == 1 && m_dirtyRects[0].height == m_height)
+    {
+        return;
+    }
+
+    if (y >= m_height)
+    {
+        y = 0;
+    }
+
+    int32_t first = Math::min(count, m_height - y);
+    m_dirtyRects.push_back(Box(0, y, m_width, first));
+    if (count > first)
+    {
+        m_dirtyRects.push_back(Box(0, 0, m_width, Math::min(count - first, y)));
+    }
+}
+//--------------------------------------------------------------------------------------------------
+void SonarImage::updateGeometry()
+{
+    float_t precision = 100000.0f;
+    Box box = minBoundingBox(m_sector, precision);
+    m_radius = Math::min(m_width / (static_cast<float_t>(box.width) / precision), m_height / (static_cast<float_t>(box.height) / precision));
+    m_polarLutValid = false;
+}
+//--------------------------------------------------------------------------------------------------
+void SonarImage::buildPolarLut()
+{
+    m_box = minBoundingBox(m_sector, m_radius);
+    m_polarLut.resize(m_width * m_height);
+
+    float_t radius2 = m_radius * m_radius;
+    PolarPixel* lut = m_polarLut.data();
+
+    for (int32_t row = 0; row < m_height; row++)
+    {
+        int32_t y = (m_box.height - 1) - row + m_box.y;
+
+        for (int32_t col = 0; col < m_width; col++)
+        {
+            int32_t x = col + m_box.x;
+            float_t rad2 = static_cast<float_t>(x * x + y * y);
+
+            lut->angle = -1.0f;
+            lut->range = 0.0f;
+
+            if (row < m_box.height && col < m_box.width && rad2 < radius2)
+            {
+                float_t angle = Math::atan2(static_cast<float_t>(x), static_cast<float_t>(y)) * static_cast<float_t>(Sonar::maxAngle / Math::pi2);
+                if (angle < 0.0f)
+                {
+                    angle += Sonar::maxAngle;
+                }
+
+                int32_t dif = static_cast<int32_t>(angle - m_sector.start);
+                if (dif < 0)
+                {
+                    dif += Sonar::maxAngle;
+                }
+
+                if (static_cast<uint_t>(dif) <= m_sector.size)
+                {
+                    lut->angle = angle;
+                    lut->range = Math::sqrt(rad2);
+                }
+            }
+            lut++;
+        }
+    }
+
+    buildSpans();
+    m_polarLutValid = true;
+}
+//--------------------------------------------------------------------------------------------------
+void SonarImage::buildSpans()
+{
+    m_spans.clear();
+    const PolarPixel* lut = m_polarLut.data();
+
+    for (int32_t y = 0; y < m_height; y++)
+    {
+        int32_t start = -1;
+        uint_t bucket = 0;
+
+        for (int32_t x = 0; x <= m_width; x++)
+        {
+            bool_t valid = x < m_width && lut[x].angle >= 0.0f;
+            uint_t pixBucket = valid ? static_cast<uint_t>(lut[x].angle) / bucketAngle : 0;
+
+            if (start >= 0 && (!valid || pixBucket != bucket))
+            {
+                m_spans.emplace_back(static_cast<uint16_t>(bucket), static_cast<uint16_t>(y), static_cast<uint16_t>(start), static_cast<uint16_t>(x - start));
+                start = -1;
+            }
+
+            if (valid && start < 0)
+            {
+                start = x;
+                bucket = pixBucket;
+            }
+        }
+        lut += m_width;
+    }
+
+    std::stable_sort(m_spans.begin(), m_spans.end(), [](const Span& a, const Span& b) { return a.bucket < b.bucket; });
+
+    m_bucketStart.assign(spanBuckets + 1, 0);
+    for (const Span& span : m_spans)
+    {
+        m_bucketStart[span.bucket + 1]++;
+    }
+
+    for (uint_t i = 0; i < spanBuckets; i++)
+    {
+        m_bucketStart[i + 1] += m_bucketStart[i];
+    }
+}
+//--------------------------------------------------------------------------------------------------
 /*void SonarImage::renderTextureFromPing(const Sonar::Ping& ping, const Palette& palette)
 {
     int_t stepSize = ping.stepSize == 0 ? 64 : ping.stepSize;
@@ -7,6 +7,8 @@
 #include "devices/sonar.h"
 #include "sonarDataStore.h"
 #include "palette.h"
+#include "pixelKernel.h"
+#include "renderPool.h"
 #include <vector>
 
 //--------------------------------------- Class Definition -----------------------------------------
@@ -16,59 +18,125 @@ namespace IslSdk
     class SonarImage
     {
     public:
-        const std::vector<uint8_t>& buf = m_buf;        ///< The pixel buffer
+        struct Box                                      /// A rectangle of pixels
+        {
+            int32_t x;
+            int32_t y;
+            int32_t width;
+            int32_t height;
+            Box(int32_t x, int32_t y, int32_t width, int32_t height) : x(x), y(y), width(width), height(height) { }
+        };
+
+        const std::vector<uint8_t>& buf = m_buf;        ///< The pixel buffer, empty if an external buffer is set
         const int32_t& width = m_width;                 ///< Width of the buffer in pixels
         const int32_t& height = m_height;               ///< Height of the buffer in pixels
         const uint8_t& bpp = m_bpp;
+        const std::vector<Box>& dirtyRects = m_dirtyRects;  ///< Areas of the buffer written by the last render call
         bool_t useBilinerInterpolation;
+        uint_t paletteBits;                             ///< Size of the palette lookup table used by render(), 8, 10, 12 or 16 bits. 0 picks 8 for 8 bit data and 16 otherwise
 
         SonarImage();
         SonarImage(int32_t width, int32_t height, bool_t use4BytePixel = true, bool_t useBilinerInterpolation = true);
         ~SonarImage();
         void setBuffer(int32_t width, int32_t height, bool_t use4BytePixel);
+
+        /**
+        * @brief Renders into a caller owned buffer, such as a viewport of a larger texture.
+        * @param pixels Address of the top left pixel. The buffer must outlive this image or be replaced first.
+        * @param width Width of the image in pixels.
+        * @param height Height of the image in pixels.
+        * @param stride Distance between rows in bytes.
+        * @param use4BytePixel True for palette colours, false for 16 bit amplitude.
+        */
+        void setBuffer(uint8_t* pixels, int32_t width, int32_t height, int32_t stride, bool_t use4BytePixel);
         void setSectorArea(uint_t minRangeMm, uint_t maxRangeMm, uint_t sectorStart, uint_t sectorSize);
 
+        /**
+        * @brief Renders render() and render16Bit() in parallel row tiles using \p pool.
+        * The same pool can be given to several images. The result is identical to single threaded rendering.
+        * @param pool The pool to use or nullptr to render on the calling thread. The pool must outlive this image or be removed first.
+        */
+        void setRenderPool(RenderPool* pool) { m_renderPool = pool; }
+
         void render(SonarDataStore& data, const Palette& palette, bool_t reDraw = false);
         void render16Bit(SonarDataStore& data, bool_t reDraw = false);
+
+        /// Renders the unrolled range versus angle image (B-scan). Each row is an angle of the sector starting
+        /// at the sector start and range runs along the x axis. Also suitable as a texture for polar display on a GPU.
+        /// For a scrolling image with one row per ping use SonarWaterfall.
         bool_t renderTexture(SonarDataStore& data, const Palette& palette, bool_t reDraw = false);
         bool_t renderTexture16Bit(SonarDataStore& data, bool_t reDraw = false);
 
     private:
         struct RenderData
         {
-            SonarDataStore::SharedPtr row1;
-            SonarDataStore::SharedPtr row2;
+            const SonarDataStore::PingData* row1;
+            const SonarDataStore::PingData* row2;
             float_t scale1;
             float_t offset1;
             float_t scale2;
             float_t offset2;
             float_t w;
-            RenderData() : scale1(0), offset1(0), scale2(0), offset2(0), w(0) { }
+            RenderData() : row1(nullptr), row2(nullptr), scale1(0), offset1(0), scale2(0), offset2(0), w(0) { }
         };
 
-        struct Box
+        struct PolarPixel
         {
-            int32_t x;
-            int32_t y;
-            int32_t width;
-            int32_t height;
-            Box(int32_t x, int32_t y, int32_t width, int32_t height) : x(x), y(y), width(width), height(height) { }
+            float_t angle;                      ///< Angle of the pixel in units of Sonar::maxAngle, negative if the pixel is outside the sector
+            float_t range;                      ///< Distance of the pixel from the origin in pixels
         };
 
+        struct Span                             ///< A run of pixels on one row of the buffer that fall in the same angle bucket
+        {
+            uint16_t bucket;
+            uint16_t y;
+            uint16_t x;
+            uint16_t width;
+            Span(uint16_t bucket, uint16_t y, uint16_t x, uint16_t width) : bucket(bucket), y(y), x(x), width(width) { }
+        };
+
+        static const uint_t spanBuckets = 256;
+        static const uint_t bucketAngle = Sonar::maxAngle / spanBuckets;
+
         uint16_t calculatePixel(const RenderData& renderData, float_t range) const;
+        void renderPolar(SonarDataStore& data, const uint32_t* colours, bool_t fullRedraw);
+        void renderArea(const SonarDataStore& data, const uint32_t* colours, const Sonar::Sector& sector, const Box& area);
+        void renderSector(const SonarDataStore& data, const uint32_t* colours, const Sonar::Sector& sector);
+        void renderRows(const SonarDataStore& data, const uint32_t* colours, const Sonar::Sector& sector, const Box& area, int32_t yStart, int32_t yEnd);
+        void renderRun(const SonarDataStore& data, const uint32_t* colours, const Sonar::Sector& sector, int32_t y, int32_t x, int32_t width);
+        uint_t loadBatch(PixelKernel::Batch& batch, const SonarDataStore& data, const PolarPixel* lut, uint_t count, const Sonar::Sector& sector) const;
         RenderData getData(const SonarDataStore& data, float_t angle, float_t width) const;
+        float_t angleWeight(const RenderData& renderData, float_t angle) const;
         void cropSector(const Sonar::Sector& window, Sonar::Sector& sector) const;
         Box minBoundingBox(const Sonar::Sector& sector, float_t radius) const;
+        Box imageArea(const Sonar::Sector& sector) const;
+        void setPixels(uint8_t* pixels, int32_t width, int32_t height, int32_t stride, uint8_t bpp);
+        void fill(uint32_t value);
+        void addRowRects(int32_t y, int32_t count);
+        uint8_t* row(int32_t y) const { return m_pixels + y * m_stride; }
+        void updateGeometry();
+        void buildPolarLut();
+        void buildSpans();
 
         std::vector<uint8_t> m_buf;             ///< The pixel buffer
+        uint8_t* m_pixels;                      ///< Top left pixel, either in m_buf or an external buffer
+        int32_t m_stride;                       ///< Distance between rows in bytes
         int32_t m_width;                        ///< Width of the buffer in pixels
         int32_t m_height;                       ///< Height of the buffer in pixels
         uint8_t m_bpp;
+        std::vector<Box> m_dirtyRects;
         uint_t m_minRangeMm;                    ///< Lower range in millimeters
         uint_t m_maxRangeMm;                    ///< Upper range in millimeters
         Sonar::Sector m_sector;
         bool_t m_redraw;
         float_t m_radius;
+        Box m_box;                              ///< Bounding box of the whole sector in polar pixel coordinates
+        std::vector<PolarPixel> m_polarLut;     ///< Per pixel angle and range, indexed the same as the pixel buffer
+        std::vector<Span> m_spans;              ///< Pixel runs of the polar lookup table sorted by angle bucket
+        std::vector<uint32_t> m_bucketStart;    ///< Index of the first span of each bucket in m_spans, with an end entry
+        bool_t m_polarLutValid;
+        uint_t m_paletteShift;                  ///< Amplitude shift for the palette lookup table of the current render() call
+        RenderPool* m_renderPool;
     };
 }
 
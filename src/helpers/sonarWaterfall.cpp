@@ -0,0 +1,182 @@
+//------------------------------------------ Includes ----------------------------------------------
+
+#include "sonarWaterfall.h"
+#include "pixelKernel.h"
+#include "maths/maths.h"
+#include "platform/mem.h"
+
+using namespace IslSdk;
+
+//--------------------------------------------------------------------------------------------------
+SonarWaterfall::SonarWaterfall() : m_width(0), m_height(0), m_bpp(0), m_head(0), m_clear(true), m_minRangeMm(0), m_maxRangeMm(10000)
+{
+}
+//--------------------------------------------------------------------------------------------------
+SonarWaterfall::SonarWaterfall(int32_t width, int32_t height, bool_t use4BytePixel) : m_width(0), m_height(0), m_bpp(0), m_head(0), m_clear(true), m_minRangeMm(0), m_maxRangeMm(10000)
+{
+    setBuffer(width, height, use4BytePixel);
+}
+//--------------------------------------------------------------------------------------------------
+SonarWaterfall::~SonarWaterfall()
+{
+}
+//--------------------------------------------------------------------------------------------------
+void SonarWaterfall::setBuffer(int32_t width, int32_t height, bool_t use4BytePixel)
+{
+    uint8_t bpp = static_cast<uint8_t>(use4BytePixel ? 4 : 2);
+
+    if (m_width != width || m_height != height || m_bpp != bpp)
+    {
+        m_width = width;
+        m_height = height;
+        m_bpp = bpp;
+        m_buf.resize(width * height * bpp);
+        clear();
+    }
+}
+//--------------------------------------------------------------------------------------------------
+void SonarWaterfall::setRange(uint_t minRangeMm, uint_t maxRangeMm)
+{
+    m_minRangeMm = minRangeMm;
+    m_maxRangeMm = maxRangeMm;
+}
+//--------------------------------------------------------------------------------------------------
+void SonarWaterfall::clear()
+{
+    std::fill(m_buf.begin(), m_buf.end(), 0);
+    m_head = 0;
+    m_clear = true;
+}
+//--------------------------------------------------------------------------------------------------
+bool_t SonarWaterfall::add(const Sonar::Ping& ping, const Palette& palette)
+{
+    if (m_bpp != 4)
+    {
+        return false;
+    }
+
+    if (m_clear)
+    {
+        fill(palette.data[0x10000].val);
+    }
+    renderRow(ping, reinterpret_cast<const uint32_t*>(palette.data.data()));
+
+    return true;
+}
+//--------------------------------------------------------------------------------------------------
+bool_t SonarWaterfall::add16Bit(const Sonar::Ping& ping)
+{
+    if (m_bpp != 2)
+    {
+        return false;
+    }
+
+    if (m_clear)
+    {
+        fill(0);
+    }
+    renderRow(ping, nullptr);
+
+    return true;
+}
+//--------------------------------------------------------------------------------------------------
+void SonarWaterfall::copyTo(uint8_t* dst) const
+{
+    uint_t rowBytes = m_width * m_bpp;
+    uint_t headBytes = m_head * rowBytes;
+
+    Mem::memcpy(dst, &m_buf[headBytes], m_buf.size() - headBytes);
+    Mem::memcpy(dst + m_buf.size() - headBytes, &m_buf[0], headBytes);
+}
+//--------------------------------------------------------------------------------------------------
+void SonarWaterfall::fill(uint32_t value)
+{
+    if (m_bpp == 4)
+    {
+        std::fill_n(reinterpret_cast<uint32_t*>(m_buf.data()), m_width * m_height, value);
+    }
+    else
+    {
+        std::fill_n(reinterpret_cast<uint16_t*>(m_buf.data()), m_width * m_height, static_cast<uint16_t>(value));
+    }
+    m_clear = false;
+}
+//--------------------------------------------------------------------------------------------------
+void SonarWaterfall::renderRow(const Sonar::Ping& ping, const uint32_t* colours)
+{
+    if (m_height == 0 || m_width == 0)
+    {
+        return;
+    }
+
+    m_head = m_head ? m_head - 1 : m_height - 1;
+
+    uint8_t* row = &m_buf[m_head * m_width * m_bpp];
+    int_t size = static_cast<int_t>(ping.data.size());
+
+    if (size == 0 || ping.maxRangeMm <= ping.minRangeMm)
+    {
+        for (int32_t x = 0; x < m_width; x++)
+        {
+            if (colours)
+            {
+                reinterpret_cast<uint32_t*>(row)[x] = colours[0x10000];
+            }
+            else
+            {
+                reinterpret_cast<uint16_t*>(row)[x] = 0;
+            }
+        }
+        return;
+    }
+
+    // Same range scaling as SonarImage::renderTexture
+    float_t imgRange = static_cast<float_t>(static_cast<int_t>(m_maxRangeMm - m_minRangeMm));
+    float_t range = static_cast<float_t>(static_cast<int_t>(ping.maxRangeMm - ping.minRangeMm));
+    float_t minDif = static_cast<float_t>(static_cast<int_t>(m_minRangeMm - ping.minRangeMm));
+    float_t scale = (ping.data.size() / static_cast<float_t>(m_width)) * (imgRange / range);
+    float_t offset = (ping.data.size() / range) * minDif;
+
+    PixelKernel::Batch batch;
+
+    for (int32_t x = 0; x < m_width; x += PixelKernel::batchSize)
+    {
+        uint_t count = Math::min<uint_t>(PixelKernel::batchSize, m_width - x);
+
+        for (uint_t i = 0; i < count; i++)
+        {
+            float_t idx = static_cast<float_t>(x + i) * scale + offset;
+            int_t intIdx = static_cast<int_t>(idx);
+
+            batch.a0[i] = 0.0f;
+            batch.a1[i] = 0.0f;
+            batch.w1[i] = 0.0f;
+            batch.b0[i] = 0.0f;
+            batch.b1[i] = 0.0f;
+            batch.w2[i] = 0.0f;
+            batch.w[i] = 0.0f;
+            batch.write[i] = 0xffffffff;
+            batch.null[i] = 0;
+
+            if (intIdx >= 0 && intIdx < size)
+            {
+                batch.w1[i] = idx - intIdx;
+                batch.a0[i] = ping.data[intIdx];
+                if (intIdx < size - 1)
+                {
+                    batch.a1[i] = ping.data[intIdx + 1];
+                }
+            }
+        }
+
+        if (colours)
+        {
+            PixelKernel::blendPalette(batch, count, colours, 0, reinterpret_cast<uint32_t*>(row) + x);
+        }
+        else
+        {
+            PixelKernel::blend16Bit(batch, count, reinterpret_cast<uint16_t*>(row) + x);
+        }
+    }
+}
+//--------------------------------------------------------------------------------------------------
@@ -0,0 +1,70 @@
+#ifndef SONARWATERFALL_H_
+#define SONARWATERFALL_H_
+
+//------------------------------------------ Includes ----------------------------------------------
+
+#include "types/sdkTypes.h"
+#include "devices/sonar.h"
+#include "palette.h"
+#include <vector>
+
+//--------------------------------------- Class Definition -----------------------------------------
+
+namespace IslSdk
+{
+    /// A scrolling waterfall image where each ping becomes one row with range along the x axis.
+    /// The buffer is a ring of rows so adding a ping only writes one row. Row \p head holds the newest
+    /// ping and older pings follow it, wrapping from the last row of the buffer to row 0.
+    class SonarWaterfall
+    {
+    public:
+        const std::vector<uint8_t>& buf = m_buf;        ///< The pixel buffer
+        const int32_t& width = m_width;                 ///< Width of the buffer in pixels
+        const int32_t& height = m_height;               ///< Height of the buffer in pixels, the number of pings shown
+        const uint8_t& bpp = m_bpp;
+        const int32_t& head = m_head;                   ///< Row of the newest ping
+
+        SonarWaterfall();
+        SonarWaterfall(int32_t width, int32_t height, bool_t use4BytePixel = true);
+        ~SonarWaterfall();
+        void setBuffer(int32_t width, int32_t height, bool_t use4BytePixel);
+        void setRange(uint_t minRangeMm, uint_t maxRangeMm);
+
+        /// Empties the waterfall, the next add() fills it with the palette's null colour or add16Bit() with 0.
+        void clear();
+
+        /**
+        * @brief Adds a ping as the newest row, coloured with \p palette.
+        * @return False if the buffer has 2 byte pixels, use add16Bit() for those.
+        */
+        bool_t add(const Sonar::Ping& ping, const Palette& palette);
+
+        /**
+        * @brief Adds a ping as the newest row of 16 bit amplitudes.
+        * @return False if the buffer has 4 byte pixels, use add() for those.
+        */
+        bool_t add16Bit(const Sonar::Ping& ping);
+
+        /**
+        * @brief Copies the ring into \p dst with the newest ping on the top row.
+        * @param dst Destination buffer of at least width * height * bpp bytes.
+        */
+        void copyTo(uint8_t* dst) const;
+
+    private:
+        void renderRow(const Sonar::Ping& ping, const uint32_t* colours);
+        void fill(uint32_t value);
+
+        std::vector<uint8_t> m_buf;
+        int32_t m_width;
+        int32_t m_height;
+        uint8_t m_bpp;
+        int32_t m_head;
+        bool_t m_clear;                         ///< Fill the buffer on the next add so rows without a ping show the null colour
+        uint_t m_minRangeMm;
+        uint_t m_maxRangeMm;
+    };
+}
+
+//--------------------------------------------------------------------------------------------------
+#endif
@@ -119,11 +119,11 @@ void LogPlayer::emitRecord(const LogReader::RecordData& record)
         {
             if (record.dataType == static_cast<uint8_t>(Device::LoggingDataType::packetData))
             {
-                device->newPacketEvent(&record.data[0], record.data.size());
+                device->newPacketEvent(record.data.data(), record.data.size());
             }
             else
             {
-                device->logData(record.dataType, record.data);
+                device->logData(record.dataType, std::vector<uint8_t>(record.data.begin(), record.data.end()));
             }
         }
         else if (record.recordType == LogFile::RecordHeader::Type::Meta)
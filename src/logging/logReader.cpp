@@ -2,6 +2,7 @@
 
 #include "logReader.h"
 #include "platform/timeUtils.h"
+#include "maths/maths.h"
 
 using namespace IslSdk;
 
@@ -50,6 +51,7 @@ bool_t LogReader::open(const std::string& filename)
 void LogReader::play(real_t playSpeed)
 {
     m_playSpeed = playSpeed;
+    m_file.setAccess(playSpeed > 0.0 ? MappedFile::Access::Sequential : MappedFile::Access::Normal);
 }
 //--------------------------------------------------------------------------------------------------
 void LogReader::reset()
@@ -67,11 +69,25 @@ void LogReader::seek(uint_t index)
             index = m_file.records.size() - 1;
         }
 
-        m_playTimer = static_cast<real_t>(m_file.records[index].timeMs);
+        m_playTimer = static_cast<real_t>(m_file.records[index].timeMs());
+
+        // Read ahead would fetch pages around the old position that won't be used
+        m_file.setAccess(MappedFile::Access::Random);
         playlog(index);
+        m_file.setAccess(m_playSpeed > 0.0 ? MappedFile::Access::Sequential : MappedFile::Access::Normal);
     }
 }
 //--------------------------------------------------------------------------------------------------
+void LogReader::seekTime(uint32_t timeMs)
+{
+    seek(m_file.findRecord(timeMs));
+}
+//--------------------------------------------------------------------------------------------------
+void LogReader::seekTime(uint8_t trackId, uint32_t timeMs)
+{
+    seek(m_file.findRecord(trackId, timeMs));
+}
+//--------------------------------------------------------------------------------------------------
 bool_t LogReader::close()
 {
     return m_file.close();
@@ -86,24 +102,20 @@ void LogReader::process()
         real_t deltaMs = static_cast<real_t>(timeMs - m_lastTimeMs);
         m_playTimer += deltaMs * m_playSpeed;
         uint_t index = m_currentIndex < 0 ? 0 : m_currentIndex;
-        real_t logTime = static_cast<real_t>(m_file.records[index].timeMs);
+        uint_t maxIdx = m_file.records.size() - 1;
 
         if (m_playSpeed > 0.0)
         {
-            uint_t maxIdx = m_file.records.size() - 1;
-            while ((logTime <= m_playTimer) && (index < maxIdx))
-            {
-                index++;
-                logTime = static_cast<real_t>(m_file.records[index].timeMs);
-            }
+            // The first record after the timer, but never going backwards
+            uint32_t targetMs = m_playTimer < 0.0 ? 0 : static_cast<uint32_t>(m_playTimer) + 1;
+            index = Math::clamp<uint_t>(m_file.findRecord(targetMs), index, maxIdx);
         }
         else
         {
-            while ((logTime >= m_playTimer) && index)
-            {
-                index--;
-                logTime = static_cast<real_t>(m_file.records[index].timeMs);
-            }
+            // The last record before the timer, but never going forwards
+            uint32_t targetMs = m_playTimer < 0.0 ? 0 : static_cast<uint32_t>(std::ceil(m_playTimer));
+            uint_t found = m_file.findRecord(targetMs);
+            index = Math::min<uint_t>(found ? found - 1 : 0, index);
         }
         playlog(index);
     }
@@ -135,10 +147,21 @@ void LogReader::playlog(uint_t index)
                 if (m_file.readRecordHeader(header, recordIdx.fileOffset))
                 {
                     RecordData record(header, m_currentIndex);
-                    if (m_file.readRecordData(&record.data[0], record.data.size()))
+                    const uint8_t* data = header.codec == LogFile::RecordHeader::Codec::None ? m_file.mapRecordData(header.dataSize) : nullptr;
+
+                    if (data)
                     {
+                        record.data = RecordBuffer(data, header.dataSize);
                         emitRecord(record);
                     }
+                    else
+                    {
+                        if (m_file.readRecordData(header, record.storage))
+                        {
+                            record.data = RecordBuffer(record.storage.data(), record.storage.size());
+                            emitRecord(record);
+                        }
+                    }
                 }
             }
         }
@@ -14,22 +14,73 @@ namespace IslSdk
     class LogReader : public LogWriter
     {
     public:
+        /// Read only view of the data in a record.
+        class RecordBuffer
+        {
+        public:
+            RecordBuffer() : m_data(nullptr), m_size(0) {}
+            RecordBuffer(const uint8_t* data, uint_t size) : m_data(data), m_size(size) {}
+            const uint8_t* data() const { return m_data; }
+            uint_t size() const { return m_size; }
+            bool_t empty() const { return m_size == 0; }
+            const uint8_t& operator[](uint_t idx) const { return m_data[idx]; }
+            const uint8_t* begin() const { return m_data; }
+            const uint8_t* end() const { return m_data + m_size; }
+
+        private:
+            const uint8_t* m_data;
+            uint_t m_size;
+        };
+
         struct RecordData
         {
             uint8_t trackId;                        ///< Id of the track
             uint32_t timeMs;                        ///< Number of milliseconds since the time stamp { @link logInfo_t startTime } for this record
+            uint64_t timeUs;                        ///< timeMs in microseconds, only finer than a millisecond in version 3 files
             uint_t recordIndex;                     ///< Index of this record in the track
             LogFile::RecordHeader::Type recordType; ///< Type of record
             uint8_t dataType;                       ///< Type of data in the record
-            std::vector<uint8_t> data;
+            RecordBuffer data;                      ///< Points into the file mapping when the log is mapped, otherwise into storage. Copy the record to keep it after the log is closed
 
             RecordData(LogFile::RecordHeader hdr, uint_t recordIndex) :
                 trackId(hdr.trackId),
-                timeMs(hdr.timeMs),
+                timeMs(static_cast<uint32_t>(hdr.timeUs / 1000)),
+                timeUs(hdr.timeUs),
                 recordIndex(recordIndex),
                 recordType(hdr.recordType),
-                dataType(hdr.dataType),
-                data(hdr.dataSize) {}
+                dataType(hdr.dataType) {}
+
+            RecordData(const RecordData& other) :
+                trackId(other.trackId),
+                timeMs(other.timeMs),
+                timeUs(other.timeUs),
+                recordIndex(other.recordIndex),
+                recordType(other.recordType),
+                dataType(other.dataType),
+                storage(other.data.begin(), other.data.end())
+            {
+                data = RecordBuffer(storage.data(), storage.size());
+            }
+
+            RecordData& operator=(const RecordData& other)
+            {
+                if (this != &other)
+                {
+                    trackId = other.trackId;
+                    timeMs = other.timeMs;
+                    timeUs = other.timeUs;
+                    recordIndex = other.recordIndex;
+                    recordType = other.recordType;
+                    dataType = other.dataType;
+                    storage.assign(other.data.begin(), other.data.end());
+                    data = RecordBuffer(storage.data(), storage.size());
+                }
+                return *this;
+            }
+
+        private:
+            friend class LogReader;
+            std::vector<uint8_t> storage;
         };
 
         LogReader();
@@ -38,6 +89,19 @@ namespace IslSdk
         void play(real_t playSpeed);
         void reset();
         void seek(uint_t index);
+
+        /**
+        * @brief Moves playback to the first record at or after a time.
+        * @param timeMs Milliseconds from the start of the log.
+        */
+        void seekTime(uint32_t timeMs);
+
+        /**
+        * @brief Moves playback to the first record of a track at or after a time.
+        * @param trackId The track.
+        * @param timeMs Milliseconds from the start of the log.
+        */
+        void seekTime(uint8_t trackId, uint32_t timeMs);
         virtual bool_t close();
         void process();
         virtual void emitRecord(const RecordData& record);
@@ -8,12 +8,14 @@
 using namespace IslSdk;
 
 //--------------------------------------------------------------------------------------------------
-LogWriter::LogWriter() : m_maxFileSize(1024 * 1024 * 1024), m_fileCount(0)
+LogWriter::LogWriter() : m_statsTimeMs(0), m_maxFileSize(1024 * 1024 * 1024), m_fileCount(0)
 {
+    m_file.setAsyncWriter(&m_writer);
 }
 //--------------------------------------------------------------------------------------------------
 LogWriter::~LogWriter()
 {
+    m_file.close();                                 // Before m_writer is destroyed
 }
 //--------------------------------------------------------------------------------------------------
 bool_t LogWriter::startNewFile(const std::string& filename)
@@ -57,7 +59,7 @@ bool_t LogWriter::addTrackData(uint8_t trackId, const void* data, uint_t size, u
     if (track)
     {
         LogFile::RecordHeader recordHeader;
-        recordHeader.timeMs = static_cast<uint32_t>(Time::getTimeMs() - m_file.timeMs);
+        recordHeader.timeUs = Time::getTimeUs() - m_file.timeMs * 1000;
         recordHeader.trackId = track->id;
         recordHeader.canSkip = canSkip;
         recordHeader.recordType = LogFile::RecordHeader::Type::Data;
@@ -71,18 +73,42 @@ bool_t LogWriter::addTrackData(uint8_t trackId, const void* data, uint_t size, u
             m_fileCount++;
             ok = m_file.startNew(m_filename + "-" + StringUtils::toStr(m_fileCount) + ".islog", Time::getTimeMs()) == LogFile::Error::None;
         }
+
+        uint64_t timeMs = Time::getTimeMs();
+        if (timeMs - m_statsTimeMs >= 1000)
+        {
+            m_statsTimeMs = timeMs;
+            onWriteStats(*this, m_writer.getStats());
+        }
     }
     return ok;
 }
 //--------------------------------------------------------------------------------------------------
-void LogWriter::setMaxFileSize(uint32_t maxSize)
+void LogWriter::setMaxFileSize(uint64_t maxSize)
 {
-    maxSize = Math::max<uint32_t>(maxSize, 1024);
+    maxSize = Math::max<uint64_t>(maxSize, 1024);
     m_maxFileSize = maxSize;
 }
 //--------------------------------------------------------------------------------------------------
+void LogWriter::setBufferSize(uint_t size)
+{
+    m_writer.setBufferSize(size);
+}
+//--------------------------------------------------------------------------------------------------
+void LogWriter::setFlushPolicy(uint_t flushIntervalMs, AsyncFileWriter::SyncPolicy sync)
+{
+    m_writer.setPolicy(flushIntervalMs, sync);
+}
+//--------------------------------------------------------------------------------------------------
+void LogWriter::setCompression(LogFile::RecordHeader::Codec codec)
+{
+    m_file.setCompression(codec);
+}
+//--------------------------------------------------------------------------------------------------
 bool_t LogWriter::close()
 {
-    return m_file.close();
+    bool_t ok = m_file.close();
+    onWriteStats(*this, m_writer.getStats());
+    return ok;
 }
 //--------------------------------------------------------------------------------------------------
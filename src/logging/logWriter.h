@@ -5,6 +5,7 @@
 
 #include "types/sdkTypes.h"
 #include "files/logFile.h"
+#include "files/asyncFileWriter.h"
 #include "types/sigSlot.h"
 
 //--------------------------------------- Class Definition -----------------------------------------
@@ -17,13 +18,41 @@ namespace IslSdk
 
         Signal<LogWriter&> onMaxFileSize;
 
+        /**
+        * @brief A subscribable event for the background writer's buffer usage, fired every second while logging and when a file is closed.
+        * @param writer LogWriter& The writer that triggered the event.
+        * @param stats const AsyncFileWriter::Stats& Buffer high water mark, dropped records and write errors.
+        */
+        Signal<LogWriter&, const AsyncFileWriter::Stats&> onWriteStats;
+
         LogWriter();
         virtual ~LogWriter();
         bool_t startNewFile(const std::string& filename);
         uint8_t addTrack(uint8_t dataType, const uint8_t* data, uint_t size);
         bool_t addTrackData(uint8_t trackId, const void* data, uint_t size, uint8_t dataType, bool_t canSkip);
         bool_t close();
-        void setMaxFileSize(uint32_t maxSize);
+        void setMaxFileSize(uint64_t maxSize);
+
+        /**
+        * @brief Sets the size of the two buffers records are written through, takes effect from the next file.
+        * When both are full records that can be skipped are dropped, others wait for the disk.
+        * @param size The size of each buffer in bytes, default 1MB.
+        */
+        void setBufferSize(uint_t size);
+
+        /**
+        * @brief Sets how often buffered records are written and synced to the storage device.
+        * @param flushIntervalMs A partly full buffer is written once it has waited this long, default 1000ms.
+        * @param sync When to sync the file, default AsyncFileWriter::SyncPolicy::OnClose.
+        */
+        void setFlushPolicy(uint_t flushIntervalMs, AsyncFileWriter::SyncPolicy sync);
+
+        /**
+        * @brief Compresses each record on the background writer thread, takes effect from the next file.
+        * The maximum file size then applies to the uncompressed size. onWriteStats reports the bytes appended and written.
+        * @param codec The codec, Lz4Shuffle16 usually suits sonar pings best. LogFile::RecordHeader::Codec::None for none, the default.
+        */
+        void setCompression(LogFile::RecordHeader::Codec codec);
         uint_t recordCount() const { return m_file.records.size(); }
         uint64_t timeMs() const { return m_file.timeMs; }
         uint32_t durationMs() const { return m_file.durationMs; }
@@ -32,9 +61,11 @@ namespace IslSdk
         LogFile m_file;
 
     private:
+        AsyncFileWriter m_writer;
+        uint64_t m_statsTimeMs;
         std::string m_filename;
         uint_t m_fileCount;
-        uint_t m_maxFileSize;
+        uint64_t m_maxFileSize;
     };
 }
 
@@ -0,0 +1,123 @@
+//------------------------------------------ Includes ----------------------------------------------
+
+#include "cpu.h"
+
+#if defined(CPU_X86) && defined(_MSC_VER)
+    #include <intrin.h>
+#elif defined(CPU_X86)
+    #include <cpuid.h>
+#endif
+
+using namespace IslSdk;
+
+#if defined(CPU_X86)
+
+struct CpuFeatures
+{
+    bool_t sse2;
+    bool_t sse41;
+    bool_t pclmul;
+    bool_t avx2;
+
+    CpuFeatures() : sse2(false), sse41(false), pclmul(false), avx2(false)
+    {
+        uint32_t regs[4] = { 0, 0, 0, 0 };
+
+        cpuid(0, regs);
+        uint32_t maxLeaf = regs[0];
+
+        if (maxLeaf >= 1)
+        {
+            cpuid(1, regs);
+            sse2 = (regs[3] & (1 << 26)) != 0;
+            sse41 = (regs[2] & (1 << 19)) != 0;
+            pclmul = (regs[2] & (1 << 1)) != 0;
+
+            bool_t osxsave = (regs[2] & (1 << 27)) != 0;
+            bool_t avx = (regs[2] & (1 << 28)) != 0;
+
+            if (osxsave && avx && (xgetbv() & 0x06) == 0x06 && maxLeaf >= 7)
+            {
+                cpuid(7, regs);
+                avx2 = (regs[1] & (1 << 5)) != 0;
+            }
+        }
+    }
+
+private:
+    static void cpuid(uint32_t leaf, uint32_t* regs)
+    {
+#if defined(_MSC_VER)
+        int32_t r[4];
+        __cpuidex(r, static_cast<int32_t>(leaf), 0);
+        for (uint_t i = 0; i < 4; i++) regs[i] = static_cast<uint32_t>(r[i]);
+#else
+        __cpuid_count(leaf, 0, regs[0], regs[1], regs[2], regs[3]);
+#endif
+    }
+
+    static uint64_t xgetbv()
+    {
+#if defined(_MSC_VER)
+        return _xgetbv(0);
+#else
+        uint32_t eax, edx;
+        __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+        return (static_cast<uint64_t>(edx) << 32) | eax;
+#endif
+    }
+};
+
+static const CpuFeatures& features()
+{
+    static const CpuFeatures cpuFeatures;
+    return cpuFeatures;
+}
+
+//--------------------------------------------------------------------------------------------------
+bool_t Cpu::hasSse2()
+{
+    return features().sse2;
+}
+//--------------------------------------------------------------------------------------------------
+bool_t Cpu::hasSse41()
+{
+    return features().sse41;
+}
+//--------------------------------------------------------------------------------------------------
+bool_t Cpu::hasPclmul()
+{
+    return features().pclmul;
+}
+//--------------------------------------------------------------------------------------------------
+bool_t Cpu::hasAvx2()
+{
+    return features().avx2;
+}
+//--------------------------------------------------------------------------------------------------
+
+#else
+
+//--------------------------------------------------------------------------------------------------
+bool_t Cpu::hasSse2()
+{
+    return false;
+}
+//--------------------------------------------------------------------------------------------------
+bool_t Cpu::hasSse41()
+{
+    return false;
+}
+//--------------------------------------------------------------------------------------------------
+bool_t Cpu::hasPclmul()
+{
+    return false;
+}
+//--------------------------------------------------------------------------------------------------
+bool_t Cpu::hasAvx2()
+{
+    return false;
+}
+//--------------------------------------------------------------------------------------------------
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef CPU_H_
+#define CPU_H_
+
+//------------------------------------------ Includes ----------------------------------------------
+
+#include "types/sdkTypes.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define CPU_X86
+    #include <immintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+    #define CPU_TARGET(features)
+#else
+    #define CPU_TARGET(features) __attribute__((target(features)))
+#endif
+
+//--------------------------------------- Class Definition -----------------------------------------
+
+namespace IslSdk
+{
+    namespace Cpu
+    {
+        bool_t hasSse2();
+        bool_t hasSse41();
+        bool_t hasPclmul();
+        bool_t hasAvx2();
+    }
+}
+//--------------------------------------------------------------------------------------------------
+
+#endif
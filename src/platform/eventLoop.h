@@ -0,0 +1,49 @@
+#ifndef EVENTLOOP_H_
+#define EVENTLOOP_H_
+
+//------------------------------------------ Includes ----------------------------------------------
+
+#include "types/sdkTypes.h"
+
+//--------------------------------------- Class Definition -----------------------------------------
+
+namespace IslSdk
+{
+    /// Waits on all the SDK's sockets at once so Sdk::run() can sleep until data arrives.
+    /// NetSocket registers its sockets and the serial port receive threads call wake() when they have data.
+    /// epoll is used on Linux, poll() on other unix systems and WSAWaitForMultipleEvents on Windows.
+    namespace EventLoop
+    {
+        /**
+        * @brief Adds a socket to the set waited on. Can be called while another thread is in wait().
+        * @param handle The socket.
+        */
+        void add(uint_t handle);
+
+        /**
+        * @brief Removes a socket, must be called before the socket is closed.
+        * @param handle The socket.
+        */
+        void remove(uint_t handle);
+
+        /**
+        * @brief Checks if a socket may have data to read.
+        * @param handle The socket.
+        * @return True if the last wait() reported the socket readable, or if wait() has never been called.
+        */
+        bool_t readable(uint_t handle);
+
+        /**
+        * @brief Waits for data on any socket or a call to wake().
+        * @param timeoutMs The maximum time to wait, 0 to only collect which sockets are readable.
+        * @return True if woken by data or wake(), false on timeout.
+        */
+        bool_t wait(uint_t timeoutMs);
+
+        /// Ends the current or next wait(). Can be called from any thread.
+        void wake();
+    }
+}
+//--------------------------------------------------------------------------------------------------
+
+#endif
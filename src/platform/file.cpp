@@ -3,6 +3,12 @@
 #include "file.h"
 #include <filesystem>
 
+#ifdef OS_WINDOWS
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
 using namespace IslSdk;
 
 //--------------------------------------------------------------------------------------------------
@@ -44,3 +50,23 @@ bool_t File::deleteFile(const std::string& filename)
     return false;
 }
 //--------------------------------------------------------------------------------------------------
+bool_t File::syncData(std::FILE* file)
+{
+#ifdef OS_WINDOWS
+    return _commit(_fileno(file)) == 0;
+#elif defined(__APPLE__)
+    return fsync(fileno(file)) == 0;
+#else
+    return fdatasync(fileno(file)) == 0;
+#endif
+}
+//--------------------------------------------------------------------------------------------------
+bool_t File::seek(std::FILE* file, uint64_t position)
+{
+#ifdef OS_WINDOWS
+    return _fseeki64(file, static_cast<__int64>(position), SEEK_SET) == 0;
+#else
+    return fseeko(file, static_cast<off_t>(position), SEEK_SET) == 0;
+#endif
+}
+//--------------------------------------------------------------------------------------------------
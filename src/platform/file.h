@@ -5,6 +5,7 @@
 
 #include "types/sdkTypes.h"
 #include <string>
+#include <cstdio>
 
 //--------------------------------------- Class Definition -----------------------------------------
 
@@ -15,6 +16,8 @@ namespace IslSdk
         std::string getDir(const std::string& path);
         bool_t createDir(const std::string& path);
         bool_t deleteFile(const std::string& filename);
+        bool_t syncData(std::FILE* file);                   ///< Waits for the file's data to reach the storage device, eg fdatasync().
+        bool_t seek(std::FILE* file, uint64_t position);    ///< fseek() from the start of the file, past 2GB on all platforms.
     };
 }
 //--------------------------------------------------------------------------------------------------
@@ -0,0 +1,57 @@
+#ifndef MAPPEDFILE_H_
+#define MAPPEDFILE_H_
+
+//------------------------------------------ Includes ----------------------------------------------
+
+#include "types/sdkTypes.h"
+#include <string>
+
+//--------------------------------------- Class Definition -----------------------------------------
+
+namespace IslSdk
+{
+    /// A read only memory mapping of a whole file.
+    /// mmap and madvise are used on unix, CreateFileMapping and PrefetchVirtualMemory on Windows.
+    class MappedFile
+    {
+    public:
+        /// How the mapping is going to be read, so the operating system can read ahead or not.
+        enum class Access { Normal, Sequential, Random };
+
+        MappedFile();
+        ~MappedFile();
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        /**
+        * @brief Maps a file.
+        * @param fileName The file to map.
+        * @return True if the file was mapped, false if it can't be opened, is empty or is too big for the address space.
+        */
+        bool_t open(const std::string& fileName);
+        void close();
+        bool_t isOpen() const { return m_data != nullptr; }
+        const uint8_t* data() const { return m_data; }
+        uint64_t size() const { return m_size; }
+
+        /**
+        * @brief Tells the operating system how the mapping is going to be read.
+        * @param access The access pattern.
+        */
+        void advise(Access access);
+
+        /**
+        * @brief Starts reading part of the file in ahead of it being used.
+        * @param offset The start of the part in bytes.
+        * @param size The size of the part in bytes.
+        */
+        void prefetch(uint64_t offset, uint64_t size);
+
+    private:
+        const uint8_t* m_data;
+        uint64_t m_size;
+        void* m_handle;                             ///< The file mapping object on Windows, unused on unix.
+    };
+}
+//--------------------------------------------------------------------------------------------------
+#endif
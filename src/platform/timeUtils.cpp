@@ -23,6 +23,12 @@ uint64_t Time::getTimeMs()
     return getSystemTimeMs() - timeCorrectionMs;
 }
 //--------------------------------------------------------------------------------------------------
+uint64_t Time::getTimeUs()
+{
+    int64_t us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    return us - timeCorrectionMs * 1000;
+}
+//--------------------------------------------------------------------------------------------------
 int64_t Time::getSystemTimeMs()
 {
     return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
@@ -14,6 +14,7 @@ namespace IslSdk
         int64_t getCorrectionMs();
         void resetCorrection();
         uint64_t getTimeMs();
+        uint64_t getTimeUs();
         int64_t getSystemTimeMs();
         void set(int_t year, int_t month, int_t day, int_t hour, int_t minute, real_t second);
     }
@@ -0,0 +1,266 @@
+//------------------------------------------ Includes ----------------------------------------------
+
+#include "platform/eventLoop.h"
+#include "platform/debug.h"
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+
+#ifdef __linux__
+    #include <sys/epoll.h>
+    #include <sys/eventfd.h>
+#else
+    #include <poll.h>
+#endif
+
+using namespace IslSdk;
+
+struct Loop
+{
+    std::mutex mutex;                           ///< Guards the members below as sockets can be added while another thread waits
+    std::vector<uint8_t> ready;                 ///< Indexed by file descriptor, set if the last wait reported it readable
+    bool_t waited;
+#ifdef __linux__
+    int epollFd;
+    int wakeFd;
+    std::vector<struct epoll_event> events;
+#else
+    int wakeFd[2];
+    std::vector<struct pollfd> fds;
+    std::vector<struct pollfd> waitFds;
+#endif
+
+    Loop() : waited(false)
+    {
+#ifdef __linux__
+        epollFd = epoll_create1(EPOLL_CLOEXEC);
+        wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        events.resize(64);
+
+        if (epollFd < 0 || wakeFd < 0)
+        {
+            debugLog("EventLoop", "Failed to create epoll %i", FMT_I(errno));
+        }
+        else
+        {
+            struct epoll_event ev = {};
+            ev.events = EPOLLIN;
+            ev.data.fd = wakeFd;
+            epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &ev);
+        }
+#else
+        if (pipe(wakeFd) == 0)
+        {
+            fcntl(wakeFd[0], F_SETFL, fcntl(wakeFd[0], F_GETFL) | O_NONBLOCK);
+            fcntl(wakeFd[1], F_SETFL, fcntl(wakeFd[1], F_GETFL) | O_NONBLOCK);
+        }
+        else
+        {
+            wakeFd[0] = -1;
+            wakeFd[1] = -1;
+            debugLog("EventLoop", "Failed to create wake pipe %i", FMT_I(errno));
+        }
+
+        struct pollfd pfd = {};
+        pfd.fd = wakeFd[0];
+        pfd.events = POLLIN;
+        fds.push_back(pfd);
+#endif
+    }
+
+    ~Loop()
+    {
+#ifdef __linux__
+        if (wakeFd >= 0) close(wakeFd);
+        if (epollFd >= 0) close(epollFd);
+#else
+        if (wakeFd[0] >= 0) close(wakeFd[0]);
+        if (wakeFd[1] >= 0) close(wakeFd[1]);
+#endif
+    }
+
+    void setReady(int fd, bool_t state)
+    {
+        if (fd >= 0)
+        {
+            if (static_cast<size_t>(fd) >= ready.size())
+            {
+                ready.resize(fd + 1, 0);
+            }
+            ready[fd] = state;
+        }
+    }
+};
+
+static Loop& loop()
+{
+    static Loop instance;
+    return instance;
+}
+
+//--------------------------------------------------------------------------------------------------
+void EventLoop::add(uint_t handle)
+{
+    Loop& l = loop();
+    int fd = static_cast<int>(handle);
+
+    if (fd >= 0)
+    {
+#ifdef __linux__
+        struct epoll_event ev = {};
+        ev.events = EPOLLIN;
+        ev.data.fd = fd;
+
+        if (epoll_ctl(l.epollFd, EPOLL_CTL_ADD, fd, &ev) < 0)
+        {
+            debugLog("EventLoop", "epoll add failed with error %i", FMT_I(errno));
+        }
+#else
+        struct pollfd pfd = {};
+        pfd.fd = fd;
+        pfd.events = POLLIN;
+#endif
+        std::lock_guard<std::mutex> lock(l.mutex);
+#ifndef __linux__
+        l.fds.push_back(pfd);
+#endif
+        // Data may have arrived before the socket was added so check it on the next read
+        l.setReady(fd, true);
+    }
+}
+//--------------------------------------------------------------------------------------------------
+void EventLoop::remove(uint_t handle)
+{
+    Loop& l = loop();
+    int fd = static_cast<int>(handle);
+
+    if (fd >= 0)
+    {
+#ifdef __linux__
+        epoll_ctl(l.epollFd, EPOLL_CTL_DEL, fd, nullptr);
+#endif
+        std::lock_guard<std::mutex> lock(l.mutex);
+#ifndef __linux__
+        for (size_t i = 1; i < l.fds.size(); i++)
+        {
+            if (l.fds[i].fd == fd)
+            {
+                l.fds.erase(l.fds.begin() + i);
+                break;
+            }
+        }
+#endif
+        l.setReady(fd, false);
+    }
+}
+//--------------------------------------------------------------------------------------------------
+bool_t EventLoop::readable(uint_t handle)
+{
+    Loop& l = loop();
+    int fd = static_cast<int>(handle);
+    std::lock_guard<std::mutex> lock(l.mutex);
+
+    if (!l.waited)
+    {
+        return true;
+    }
+    return fd >= 0 && static_cast<size_t>(fd) < l.ready.size() && l.ready[fd];
+}
+//--------------------------------------------------------------------------------------------------
+bool_t EventLoop::wait(uint_t timeoutMs)
+{
+    Loop& l = loop();
+    bool_t woken = false;
+
+#ifdef __linux__
+    int count = epoll_wait(l.epollFd, l.events.data(), static_cast<int>(l.events.size()), static_cast<int>(timeoutMs));
+    std::lock_guard<std::mutex> lock(l.mutex);
+
+    l.waited = true;
+    std::fill(l.ready.begin(), l.ready.end(), 0);
+
+    for (int i = 0; i < count; i++)
+    {
+        int fd = l.events[i].data.fd;
+
+        if (fd == l.wakeFd)
+        {
+            uint64_t value;
+            while (read(l.wakeFd, &value, sizeof(value)) > 0);
+        }
+        else
+        {
+            l.setReady(fd, true);
+        }
+        woken = true;
+    }
+
+    // A full event list may have left sockets unreported, treat them all as readable
+    if (count == static_cast<int>(l.events.size()))
+    {
+        std::fill(l.ready.begin(), l.ready.end(), 1);
+        l.events.resize(l.events.size() * 2);
+    }
+#else
+    {
+        std::lock_guard<std::mutex> lock(l.mutex);
+        l.waitFds = l.fds;
+    }
+
+    int count = poll(l.waitFds.data(), static_cast<nfds_t>(l.waitFds.size()), static_cast<int>(timeoutMs));
+    std::lock_guard<std::mutex> lock(l.mutex);
+
+    l.waited = true;
+    std::fill(l.ready.begin(), l.ready.end(), 0);
+
+    if (count > 0)
+    {
+        if (l.waitFds[0].revents)
+        {
+            uint8_t buf[64];
+            while (read(l.wakeFd[0], buf, sizeof(buf)) > 0);
+        }
+
+        for (size_t i = 1; i < l.waitFds.size(); i++)
+        {
+            if (l.waitFds[i].revents)
+            {
+                l.setReady(l.waitFds[i].fd, true);
+            }
+        }
+        woken = true;
+    }
+#endif
+
+    if (count < 0 && errno != EINTR)
+    {
+        // Fall back to reading every socket
+        l.waited = false;
+        debugLog("EventLoop", "wait failed with error %i", FMT_I(errno));
+    }
+
+    return woken;
+}
+//--------------------------------------------------------------------------------------------------
+void EventLoop::wake()
+{
+    Loop& l = loop();
+
+#ifdef __linux__
+    uint64_t value = 1;
+    if (write(l.wakeFd, &value, sizeof(value)) < 0)
+    {
+        // Already signalled
+    }
+#else
+    uint8_t value = 1;
+    if (write(l.wakeFd[1], &value, sizeof(value)) < 0)
+    {
+        // Pipe full so already signalled
+    }
+#endif
+}
+//--------------------------------------------------------------------------------------------------
@@ -0,0 +1,88 @@
+//------------------------------------------ Includes ----------------------------------------------
+
+#include "platform/mappedFile.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace IslSdk;
+
+//--------------------------------------------------------------------------------------------------
+MappedFile::MappedFile() : m_data(nullptr), m_size(0), m_handle(nullptr)
+{
+}
+//--------------------------------------------------------------------------------------------------
+MappedFile::~MappedFile()
+{
+    close();
+}
+//--------------------------------------------------------------------------------------------------
+bool_t MappedFile::open(const std::string& fileName)
+{
+    close();
+
+    int fd = ::open(fileName.c_str(), O_RDONLY);
+
+    if (fd >= 0)
+    {
+        struct stat info;
+
+        if (fstat(fd, &info) == 0 && info.st_size > 0 && static_cast<uint64_t>(info.st_size) <= static_cast<uint64_t>(SIZE_MAX))
+        {
+            void* ptr = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+
+            if (ptr != MAP_FAILED)
+            {
+                m_data = static_cast<const uint8_t*>(ptr);
+                m_size = static_cast<uint64_t>(info.st_size);
+            }
+        }
+
+        ::close(fd);                                // The mapping keeps the file open
+    }
+
+    return m_data != nullptr;
+}
+//--------------------------------------------------------------------------------------------------
+void MappedFile::close()
+{
+    if (m_data)
+    {
+        munmap(const_cast<uint8_t*>(m_data), static_cast<size_t>(m_size));
+        m_data = nullptr;
+        m_size = 0;
+    }
+}
+//--------------------------------------------------------------------------------------------------
+void MappedFile::advise(Access access)
+{
+    if (m_data)
+    {
+        int advice = MADV_NORMAL;
+
+        if (access == Access::Sequential)
+        {
+            advice = MADV_SEQUENTIAL;
+        }
+        else if (access == Access::Random)
+        {
+            advice = MADV_RANDOM;
+        }
+        madvise(const_cast<uint8_t*>(m_data), static_cast<size_t>(m_size), advice);
+    }
+}
+//--------------------------------------------------------------------------------------------------
+void MappedFile::prefetch(uint64_t offset, uint64_t size)
+{
+    if (m_data && offset < m_size)
+    {
+        // madvise needs a page aligned address
+        uint64_t pageSize = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+        uint64_t start = offset & ~(pageSize - 1);
+        uint64_t end = offset + size < m_size ? offset + size : m_size;
+
+        madvise(const_cast<uint8_t*>(m_data + start), static_cast<size_t>(end - start), MADV_WILLNEED);
+    }
+}
+//--------------------------------------------------------------------------------------------------
@@ -3,6 +3,7 @@
 #include "netSocket.h"
 #include "platform/mem.h"
 #include "platform/debug.h"
+#include "platform/eventLoop.h"
 #include <sys/socket.h>
 #include <unistd.h>
 #include <arpa/inet.h>
@@ -14,6 +15,13 @@ using namespace IslSdk;
 
 const int_t SOCKET_ERROR = -1;
 const int_t INVALID_SOCKET = -1;
+const uint_t maxBatchSize = 64;
+
+#ifdef __linux__
+const bool_t NetSocket::hasBatchIo = true;
+#else
+const bool_t NetSocket::hasBatchIo = false;
+#endif
 
 //--------------------------------------------------------------------------------------------------
 bool_t NetSocket::initialise()
@@ -41,10 +49,14 @@ NetSocket::NetSocket(bool_t isTcp, bool_t isServer, uint32_t ipAddress, uint16_t
     m_connected = false;
     m_ipAddress = ipAddress;
     m_port = port;
+    rxSyscallCount = 0;
+    txSyscallCount = 0;
+    EventLoop::add(m_socket);
 }
 //--------------------------------------------------------------------------------------------------
 NetSocket::~NetSocket()
 {
+    EventLoop::remove(m_socket);
     shutdown(m_socket, SHUT_WR);
     close(m_socket);
 }
@@ -57,38 +69,28 @@ bool_t NetSocket::isOpen()
 NetSocket::State NetSocket::write(const uint8_t* data, uint_t* size, uint32_t ipAddress, uint16_t port)
 {
     NetSocket::State socketStatus = State::Ok;
-    fd_set waitSend;
-    struct timeval timeout;
+    struct sockaddr_in addr;
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = ipAddress;
 
-    FD_ZERO(&waitSend);
-    FD_SET(m_socket, &waitSend);
-    timeout.tv_sec = 0;
-    timeout.tv_usec = 0;
+    // The socket is non-blocking so a full buffer, or a TCP socket that isn't connected yet, fails with EAGAIN rather than needing a select first
+    int_t result = sendto(m_socket, reinterpret_cast<const char*>(data), static_cast<int>(*size), MSG_NOSIGNAL, (struct sockaddr*)&addr, sizeof(addr));
+    txSyscallCount++;
 
-    int_t result = select(m_socket + 1, NULL, &waitSend, NULL, &timeout);
     if (result != SOCKET_ERROR)
     {
-        if (FD_ISSET(m_socket, &waitSend))
-        {
-            struct sockaddr_in addr;
-            addr.sin_family = AF_INET;
-            addr.sin_port = htons(port);
-            addr.sin_addr.s_addr = ipAddress;
-
-            result = sendto(m_socket, reinterpret_cast<const char*>(data), static_cast<int>(*size), 0, (struct sockaddr*)&addr, sizeof(addr));
-            *size = result;
-        }
-        else
+        *size = result;
+    }
+    else if (errno == EAGAIN || errno == EWOULDBLOCK || (m_isTcp && !m_connected && errno == ENOTCONN))
+    {
+        if (m_isTcp)
         {
-            if (m_isTcp)
-            {
-                socketStatus = State::TcpWating;
-            }
-            *size = 0;
+            socketStatus = State::TcpWating;
         }
+        *size = 0;
     }
-
-    if (result == SOCKET_ERROR)
+    else
     {
         socketStatus = State::Error;
         *size = 0;
@@ -101,58 +103,60 @@ NetSocket::State NetSocket::write(const uint8_t* data, uint_t* size, uint32_t ip
 NetSocket::State NetSocket::read(uint8_t* buf, uint_t* size, uint32_t* ipAddress, uint16_t* port)
 {
     NetSocket::State socketStatus = NetSocket::State::Ok;
-    fd_set waitRecv;
-    struct timeval timeout;
-
-    FD_ZERO(&waitRecv);
-    FD_SET(m_socket, &waitRecv);
-    FD_SET(STDIN_FILENO, &waitRecv);
-    timeout.tv_sec = 0;
-    timeout.tv_usec = 0;
     *ipAddress = 0;
     *port = 0;
     int_t bytesRead = 0;
+    int_t result = 0;
 
-    int_t result = select(m_socket + 1, &waitRecv, NULL, NULL, &timeout);
-    if (result != SOCKET_ERROR)
+    if (EventLoop::readable(m_socket))
     {
-        if (FD_ISSET(m_socket, &waitRecv))
+        if (m_isTcp && m_isServer && !m_connected)
         {
-            if (m_isTcp && m_isServer && !m_connected)
+            SOCKET newSocket = tcpAcceptConnection(m_socket);
+            rxSyscallCount++;
+            if (newSocket != INVALID_SOCKET)
             {
-                m_socket = tcpAcceptConnection(m_socket);
-                m_connected = m_socket != INVALID_SOCKET;
-                if (m_connected)
-                {
-                    socketStatus = State::Connected;
-                }
+                EventLoop::remove(m_socket);
+                shutdown(m_socket, SHUT_RDWR);
+                close(m_socket);
+                m_socket = newSocket;
+                EventLoop::add(m_socket);
+                m_connected = true;
+                socketStatus = State::Connected;
             }
-            else
+        }
+        else
+        {
+            struct sockaddr_in fromAddress;
+            uint fromAddressSize = sizeof(fromAddress);
+            result = recvfrom(m_socket, reinterpret_cast<char*>(buf), static_cast<int>(*size), 0, (struct sockaddr*)&fromAddress, &fromAddressSize);
+            rxSyscallCount++;
+            if (result != SOCKET_ERROR)
             {
-                struct sockaddr_in fromAddress;
-                uint fromAddressSize = sizeof(fromAddress);
-                result = recvfrom(m_socket, reinterpret_cast<char*>(buf), static_cast<int>(*size), 0, (struct sockaddr*)&fromAddress, &fromAddressSize);
-                if (result != SOCKET_ERROR)
-                {
-                    *ipAddress = fromAddress.sin_addr.s_addr;
-                    *port = htons(fromAddress.sin_port);
-                    bytesRead = result;
-                    m_connected = result != 0;
+                *ipAddress = fromAddress.sin_addr.s_addr;
+                *port = htons(fromAddress.sin_port);
+                bytesRead = result;
+                m_connected = result != 0;
 
-                    if (m_isTcp && !m_connected)
+                if (m_isTcp && !m_connected)
+                {
+                    socketStatus = State::Disconnected;
+                    EventLoop::remove(m_socket);
+                    shutdown(m_socket, SHUT_WR);
+                    close(m_socket);
+                    if (m_isServer)
                     {
-                        socketStatus = State::Disconnected;
-                        shutdown(m_socket, SHUT_WR);
-                        close(m_socket);
-                        if (m_isServer)
-                        {
-                            result = (int_t)createTcpSocket(m_isServer, m_ipAddress, m_port);
-                            m_socket = result;
-                            socketStatus = State::TcpWating;
-                        }
+                        result = (int_t)createTcpSocket(m_isServer, m_ipAddress, m_port);
+                        m_socket = result;
+                        EventLoop::add(m_socket);
+                        socketStatus = State::TcpWating;
                     }
                 }
             }
+            else if (errno == EAGAIN || errno == EWOULDBLOCK)
+            {
+                result = 0;
+            }
         }
     }
 
@@ -167,6 +171,150 @@ NetSocket::State NetSocket::read(uint8_t* buf, uint_t* size, uint32_t* ipAddress
     return socketStatus;
 }
 //--------------------------------------------------------------------------------------------------
+NetSocket::State NetSocket::readMany(Datagram* datagrams, uint_t* count)
+{
+    NetSocket::State socketStatus = NetSocket::State::Ok;
+    uint_t received = 0;
+
+#ifdef __linux__
+    if (!m_isTcp)
+    {
+        if (EventLoop::readable(m_socket))
+        {
+            struct mmsghdr msgs[maxBatchSize];
+            struct iovec iov[maxBatchSize];
+            struct sockaddr_in fromAddress[maxBatchSize];
+            uint_t batchSize = *count < maxBatchSize ? *count : maxBatchSize;
+
+            for (uint_t i = 0; i < batchSize; i++)
+            {
+                iov[i].iov_base = datagrams[i].data;
+                iov[i].iov_len = datagrams[i].size;
+                Mem::memset(&msgs[i], 0, sizeof(msgs[i]));
+                msgs[i].msg_hdr.msg_name = &fromAddress[i];
+                msgs[i].msg_hdr.msg_namelen = sizeof(fromAddress[i]);
+                msgs[i].msg_hdr.msg_iov = &iov[i];
+                msgs[i].msg_hdr.msg_iovlen = 1;
+            }
+
+            int result = recvmmsg(m_socket, msgs, static_cast<unsigned int>(batchSize), MSG_DONTWAIT, nullptr);
+            rxSyscallCount++;
+
+            if (result >= 0)
+            {
+                for (int i = 0; i < result; i++)
+                {
+                    datagrams[i].size = msgs[i].msg_len;
+                    datagrams[i].ipAddress = fromAddress[i].sin_addr.s_addr;
+                    datagrams[i].port = htons(fromAddress[i].sin_port);
+                }
+                received = result;
+            }
+            else if (errno != EAGAIN && errno != EWOULDBLOCK)
+            {
+                socketStatus = State::Error;
+                debugLog("NetPort", "network read falied with error %i", FMT_I(errno));
+            }
+        }
+
+        *count = received;
+        return socketStatus;
+    }
+#endif
+
+    // One datagram, or a block of stream data, per system call
+    while (received < *count)
+    {
+        Datagram& datagram = datagrams[received];
+        socketStatus = read(datagram.data, &datagram.size, &datagram.ipAddress, &datagram.port);
+
+        if (datagram.size)
+        {
+            received++;
+        }
+
+        if (socketStatus != State::Ok || datagram.size == 0)
+        {
+            break;
+        }
+    }
+
+    *count = received;
+    return socketStatus;
+}
+//--------------------------------------------------------------------------------------------------
+NetSocket::State NetSocket::writeMany(const Datagram* datagrams, uint_t* count)
+{
+    NetSocket::State socketStatus = NetSocket::State::Ok;
+    uint_t sent = 0;
+
+#ifdef __linux__
+    if (!m_isTcp)
+    {
+        struct mmsghdr msgs[maxBatchSize];
+        struct iovec iov[maxBatchSize];
+        struct sockaddr_in toAddress[maxBatchSize];
+
+        while (sent < *count)
+        {
+            uint_t batchSize = *count - sent < maxBatchSize ? *count - sent : maxBatchSize;
+
+            for (uint_t i = 0; i < batchSize; i++)
+            {
+                const Datagram& datagram = datagrams[sent + i];
+                toAddress[i].sin_family = AF_INET;
+                toAddress[i].sin_port = htons(datagram.port);
+                toAddress[i].sin_addr.s_addr = datagram.ipAddress;
+                iov[i].iov_base = datagram.data;
+                iov[i].iov_len = datagram.size;
+                Mem::memset(&msgs[i], 0, sizeof(msgs[i]));
+                msgs[i].msg_hdr.msg_name = &toAddress[i];
+                msgs[i].msg_hdr.msg_namelen = sizeof(toAddress[i]);
+                msgs[i].msg_hdr.msg_iov = &iov[i];
+                msgs[i].msg_hdr.msg_iovlen = 1;
+            }
+
+            int result = sendmmsg(m_socket, msgs, static_cast<unsigned int>(batchSize), MSG_NOSIGNAL);
+            txSyscallCount++;
+
+            if (result < 0)
+            {
+                if (errno != EAGAIN && errno != EWOULDBLOCK)
+                {
+                    socketStatus = State::Error;
+                    debugLog("NetPort", "network write falied with error %i", FMT_I(errno));
+                }
+                break;
+            }
+
+            sent += result;
+            if (static_cast<uint_t>(result) < batchSize)
+            {
+                break;
+            }
+        }
+
+        *count = sent;
+        return socketStatus;
+    }
+#endif
+
+    while (sent < *count)
+    {
+        uint_t size = datagrams[sent].size;
+        socketStatus = write(datagrams[sent].data, &size, datagrams[sent].ipAddress, datagrams[sent].port);
+
+        if (socketStatus != State::Ok || size == 0)
+        {
+            break;
+        }
+        sent++;
+    }
+
+    *count = sent;
+    return socketStatus;
+}
+//--------------------------------------------------------------------------------------------------
 SOCKET NetSocket::createTcpSocket(bool_t isServer, uint32_t ipAddress, uint16_t port)
 {
     struct sockaddr_in addr;
@@ -216,7 +364,7 @@ SOCKET NetSocket::createTcpSocket(bool_t isServer, uint32_t ipAddress, uint16_t
     {
         if (connect(sock, (struct sockaddr*)&addr, sizeof(addr)) == SOCKET_ERROR)
         {
-            if (errno != EWOULDBLOCK)
+            if (errno != EWOULDBLOCK && errno != EINPROGRESS)
             {
                 debugLog("NetPort", "connect falied with error %i", FMT_I(errno));
                 close(sock);
@@ -292,20 +440,10 @@ SOCKET NetSocket::tcpAcceptConnection(SOCKET socket)
 
     if (newSocket != INVALID_SOCKET)
     {
-        shutdown(socket, SHUT_RDWR);
-        close(socket);
-
         int_t flags = fcntl(newSocket, F_GETFL);
-        if (flags == -1)
-        {
-            debugLog("NetPort", "Could not get socket flags");
-            close(newSocket);
-            newSocket = INVALID_SOCKET;
-        }
-
-        if (fcntl(socket, F_SETFL, flags | O_NONBLOCK) == -1)
+        if (flags == -1 || fcntl(newSocket, F_SETFL, flags | O_NONBLOCK) == -1)
         {
-            debugLog("NetPort", "Cund not set socket to non-blocking mode");
+            debugLog("NetPort", "Could not set socket to non-blocking mode");
             close(newSocket);
             newSocket = INVALID_SOCKET;
         }
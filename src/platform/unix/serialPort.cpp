@@ -1,6 +1,7 @@
 //------------------------------------------ Includes ----------------------------------------------
 
 #include "serialPort.h"
+#include "platform/eventLoop.h"
 #include "platform/debug.h"
 #include <termios.h>
 #include <unistd.h>
@@ -307,6 +308,7 @@ void SerialPort::threadRx()
             if (bytesRead > 0)
             {
                 rxDataEvent(m_rxBuf, bytesRead, m_baudrate);
+                EventLoop::wake();
             }
             else if (bytesRead < 0)
             {
@@ -0,0 +1,140 @@
+//------------------------------------------ Includes ----------------------------------------------
+
+#define WIN32_LEAN_AND_MEAN
+
+#include "platform/eventLoop.h"
+#include "platform/debug.h"
+#include <winsock2.h>
+#include <vector>
+#include <mutex>
+
+#pragma comment(lib, "Ws2_32.lib")
+
+using namespace IslSdk;
+
+struct Loop
+{
+    std::mutex mutex;                           ///< Guards the vectors as sockets can be added while another thread waits
+    std::vector<SOCKET> sockets;                ///< Index 0 is unused, matches the wake event
+    std::vector<WSAEVENT> events;               ///< Index 0 is the wake event
+    std::vector<WSAEVENT> waitEvents;           ///< Copy of events passed to WSAWaitForMultipleEvents
+    WSAEVENT wakeEvent;                         ///< Copy of the wake event so wake() never reads the vector
+
+    Loop()
+    {
+        wakeEvent = WSACreateEvent();
+        sockets.push_back(INVALID_SOCKET);
+        events.push_back(wakeEvent);
+    }
+
+    ~Loop()
+    {
+        for (WSAEVENT event : events)
+        {
+            WSACloseEvent(event);
+        }
+    }
+};
+
+static Loop& loop()
+{
+    static Loop instance;
+    return instance;
+}
+
+//--------------------------------------------------------------------------------------------------
+void EventLoop::add(uint_t handle)
+{
+    Loop& l = loop();
+    SOCKET socket = static_cast<SOCKET>(handle);
+
+    if (socket != INVALID_SOCKET)
+    {
+        std::lock_guard<std::mutex> lock(l.mutex);
+
+        if (l.events.size() < WSA_MAXIMUM_WAIT_EVENTS)
+        {
+            WSAEVENT event = WSACreateEvent();
+            if (WSAEventSelect(socket, event, FD_READ | FD_ACCEPT | FD_CLOSE) == 0)
+            {
+                l.sockets.push_back(socket);
+                l.events.push_back(event);
+            }
+            else
+            {
+                WSACloseEvent(event);
+                debugLog("EventLoop", "WSAEventSelect failed with error %i", FMT_I(WSAGetLastError()));
+            }
+        }
+        else
+        {
+            debugLog("EventLoop", "Too many sockets, wait() won't wake for this one");
+        }
+    }
+}
+//--------------------------------------------------------------------------------------------------
+void EventLoop::remove(uint_t handle)
+{
+    Loop& l = loop();
+    SOCKET socket = static_cast<SOCKET>(handle);
+    std::lock_guard<std::mutex> lock(l.mutex);
+
+    for (size_t i = 1; i < l.sockets.size(); i++)
+    {
+        if (l.sockets[i] == socket)
+        {
+            WSAEventSelect(socket, NULL, 0);
+            WSACloseEvent(l.events[i]);
+            l.sockets.erase(l.sockets.begin() + i);
+            l.events.erase(l.events.begin() + i);
+            break;
+        }
+    }
+}
+//--------------------------------------------------------------------------------------------------
+bool_t EventLoop::readable(uint_t handle)
+{
+    // NetSocket::read() selects each socket itself on Windows
+    return true;
+}
+//--------------------------------------------------------------------------------------------------
+bool_t EventLoop::wait(uint_t timeoutMs)
+{
+    Loop& l = loop();
+    bool_t woken = false;
+
+    {
+        std::lock_guard<std::mutex> lock(l.mutex);
+        l.waitEvents = l.events;
+    }
+
+    DWORD result = WSAWaitForMultipleEvents(static_cast<DWORD>(l.waitEvents.size()), l.waitEvents.data(), FALSE, static_cast<DWORD>(timeoutMs), FALSE);
+
+    if (result >= WSA_WAIT_EVENT_0 && result < WSA_WAIT_EVENT_0 + l.waitEvents.size())
+    {
+        std::lock_guard<std::mutex> lock(l.mutex);
+
+        // Reset every signalled event, the network events are re-enabled by the next recv()
+        for (size_t i = 0; i < l.events.size(); i++)
+        {
+            if (i == 0)
+            {
+                WSAResetEvent(l.events[0]);
+            }
+            else
+            {
+                WSANETWORKEVENTS networkEvents;
+                WSAEnumNetworkEvents(l.sockets[i], l.events[i], &networkEvents);
+            }
+        }
+        woken = true;
+    }
+
+    return woken;
+}
+//--------------------------------------------------------------------------------------------------
+void EventLoop::wake()
+{
+    WSASetEvent(loop().wakeEvent);
+}
+//--------------------------------------------------------------------------------------------------
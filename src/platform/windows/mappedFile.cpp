@@ -0,0 +1,84 @@
+//------------------------------------------ Includes ----------------------------------------------
+
+#define WIN32_LEAN_AND_MEAN
+
+#include "platform/mappedFile.h"
+#include <windows.h>
+
+using namespace IslSdk;
+
+//--------------------------------------------------------------------------------------------------
+MappedFile::MappedFile() : m_data(nullptr), m_size(0), m_handle(nullptr)
+{
+}
+//--------------------------------------------------------------------------------------------------
+MappedFile::~MappedFile()
+{
+    close();
+}
+//--------------------------------------------------------------------------------------------------
+bool_t MappedFile::open(const std::string& fileName)
+{
+    close();
+
+    HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+    if (file != INVALID_HANDLE_VALUE)
+    {
+        LARGE_INTEGER fileSize;
+
+        if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0 && static_cast<uint64_t>(fileSize.QuadPart) <= static_cast<uint64_t>(SIZE_MAX))
+        {
+            HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+            if (mapping)
+            {
+                void* ptr = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+
+                if (ptr)
+                {
+                    m_data = static_cast<const uint8_t*>(ptr);
+                    m_size = static_cast<uint64_t>(fileSize.QuadPart);
+                    m_handle = mapping;
+                }
+                else
+                {
+                    CloseHandle(mapping);
+                }
+            }
+        }
+
+        CloseHandle(file);                          // The mapping keeps the file open
+    }
+
+    return m_data != nullptr;
+}
+//--------------------------------------------------------------------------------------------------
+void MappedFile::close()
+{
+    if (m_data)
+    {
+        UnmapViewOfFile(m_data);
+        CloseHandle(static_cast<HANDLE>(m_handle));
+        m_data = nullptr;
+        m_size = 0;
+        m_handle = nullptr;
+    }
+}
+//--------------------------------------------------------------------------------------------------
+void MappedFile::advise(Access access)
+{
+    // Windows only takes access hints when a file is opened, read ahead is done with prefetch()
+}
+//--------------------------------------------------------------------------------------------------
+void MappedFile::prefetch(uint64_t offset, uint64_t size)
+{
+    if (m_data && offset < m_size)
+    {
+        WIN32_MEMORY_RANGE_ENTRY range;
+        range.VirtualAddress = const_cast<uint8_t*>(m_data + offset);
+        range.NumberOfBytes = static_cast<SIZE_T>(offset + size < m_size ? size : m_size - offset);
+        PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+    }
+}
+//--------------------------------------------------------------------------------------------------
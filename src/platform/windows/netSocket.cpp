@@ -4,6 +4,7 @@
 
 #include "netSocket.h"
 #include "platform/debug.h"
+#include "platform/eventLoop.h"
 #include <winsock2.h>
 #include <Wininet.h>
 
@@ -12,6 +13,8 @@
 
 using namespace IslSdk;
 
+const bool_t NetSocket::hasBatchIo = false;
+
 //--------------------------------------------------------------------------------------------------
 bool_t NetSocket::initialise()
 {
@@ -40,10 +43,14 @@ NetSocket::NetSocket(bool_t isTcp, bool_t isServer, uint32_t ipAddress, uint16_t
     m_connected = FALSE;
     m_ipAddress = ipAddress;
     m_port = port;
+    rxSyscallCount = 0;
+    txSyscallCount = 0;
+    EventLoop::add(m_socket);
 }
 //--------------------------------------------------------------------------------------------------
 NetSocket::~NetSocket()
 {
+    EventLoop::remove(m_socket);
     shutdown(m_socket, SD_SEND);
     closesocket(m_socket);
 }
@@ -65,6 +72,7 @@ NetSocket::State NetSocket::write(const uint8_t* data, uint_t* size, uint32_t ip
     timeout.tv_usec = 0;
 
     int_t result = select(0, NULL, &waitSend, NULL, &timeout);
+    txSyscallCount++;
     if (result != SOCKET_ERROR)
     {
         if (FD_ISSET(m_socket, &waitSend))
@@ -75,6 +83,7 @@ NetSocket::State NetSocket::write(const uint8_t* data, uint_t* size, uint32_t ip
             addr.sin_addr.s_addr = ipAddress;
 
             result = sendto(m_socket, reinterpret_cast<const char*>(data), static_cast<int>(*size), 0, (struct sockaddr*)&addr, sizeof(addr));
+            txSyscallCount++;
             *size = result;
         }
         else
@@ -112,16 +121,21 @@ NetSocket::State NetSocket::read(uint8_t* buf, uint_t* size, uint32_t* ipAddress
     int_t bytesRead = 0;
 
     int_t result = select(0, &waitRecv, NULL, NULL, &timeout);
+    rxSyscallCount++;
     if (result != SOCKET_ERROR)
     {
         if (FD_ISSET(m_socket, &waitRecv))
         {
             if (m_isTcp && m_isServer && !m_connected)
             {
+                SOCKET listenSocket = m_socket;
                 m_socket = tcpAcceptConnection(m_socket);
+                rxSyscallCount++;
                 m_connected = m_socket != INVALID_SOCKET;
                 if (m_connected)
                 {
+                    EventLoop::remove(listenSocket);
+                    EventLoop::add(m_socket);
                     socketStatus = State::Connected;
                 }
             }
@@ -130,6 +144,7 @@ NetSocket::State NetSocket::read(uint8_t* buf, uint_t* size, uint32_t* ipAddress
                 struct sockaddr_in fromAddress;
                 int fromAddressSize = sizeof(fromAddress);
                 result = recvfrom(m_socket, reinterpret_cast<char*>(buf), static_cast<int>(*size), 0, (struct sockaddr*)&fromAddress, &fromAddressSize);
+                rxSyscallCount++;
                 if (result != SOCKET_ERROR)
                 {
                     *ipAddress = fromAddress.sin_addr.s_addr;
@@ -140,12 +155,14 @@ NetSocket::State NetSocket::read(uint8_t* buf, uint_t* size, uint32_t* ipAddress
                     if (m_isTcp && !m_connected)
                     {
                         socketStatus = State::Disconnected;
+                        EventLoop::remove(m_socket);
                         shutdown(m_socket, SD_SEND);
                         closesocket(m_socket);
                         if (m_isServer)
                         {
                             result = (int_t)createTcpSocket(m_isServer, m_ipAddress, m_port);
                             m_socket = result;
+                            EventLoop::add(m_socket);
                             socketStatus = State::TcpWating;
                         }
                     }
@@ -165,6 +182,53 @@ NetSocket::State NetSocket::read(uint8_t* buf, uint_t* size, uint32_t* ipAddress
     return socketStatus;
 }
 //--------------------------------------------------------------------------------------------------
+NetSocket::State NetSocket::readMany(Datagram* datagrams, uint_t* count)
+{
+    NetSocket::State socketStatus = NetSocket::State::Ok;
+    uint_t received = 0;
+
+    // Winsock has no batched receive so this is one read() per datagram
+    while (received < *count)
+    {
+        Datagram& datagram = datagrams[received];
+        socketStatus = read(datagram.data, &datagram.size, &datagram.ipAddress, &datagram.port);
+
+        if (datagram.size)
+        {
+            received++;
+        }
+
+        if (socketStatus != State::Ok || datagram.size == 0)
+        {
+            break;
+        }
+    }
+
+    *count = received;
+    return socketStatus;
+}
+//--------------------------------------------------------------------------------------------------
+NetSocket::State NetSocket::writeMany(const Datagram* datagrams, uint_t* count)
+{
+    NetSocket::State socketStatus = NetSocket::State::Ok;
+    uint_t sent = 0;
+
+    while (sent < *count)
+    {
+        uint_t size = datagrams[sent].size;
+        socketStatus = write(datagrams[sent].data, &size, datagrams[sent].ipAddress, datagrams[sent].port);
+
+        if (socketStatus != State::Ok || size == 0)
+        {
+            break;
+        }
+        sent++;
+    }
+
+    *count = sent;
+    return socketStatus;
+}
+//--------------------------------------------------------------------------------------------------
 SOCKET NetSocket::createTcpSocket(bool_t isServer, uint32_t ipAddress, uint16_t port)
 {
     struct sockaddr_in addr;
@@ -16,6 +16,19 @@ namespace IslSdk
     {
     public:
         enum class State { Error, Ok, TcpWating, Connected, Disconnected };
+
+        struct Datagram
+        {
+            uint8_t* data;
+            uint_t size;                        ///< Size of the buffer on entry to readMany(), bytes received on return.
+            uint32_t ipAddress;
+            uint16_t port;
+        };
+
+        static const bool_t hasBatchIo;         ///< True if readMany() and writeMany() move several datagrams per system call.
+        uint_t rxSyscallCount;                  ///< The number of receive system calls made.
+        uint_t txSyscallCount;                  ///< The number of send system calls made.
+
         static bool_t initialise();
         static void deinitialise();
         NetSocket(bool_t isTcp, bool_t isServer, uint32_t ipAddress, uint16_t port);
@@ -23,6 +36,8 @@ namespace IslSdk
         bool_t isOpen();
         NetSocket::State write(const uint8_t* data, uint_t* size, uint32_t ipAddress, uint16_t port);
         NetSocket::State read(uint8_t* buf, uint_t* size, uint32_t* ipAddress, uint16_t* port);
+        NetSocket::State readMany(Datagram* datagrams, uint_t* count);
+        NetSocket::State writeMany(const Datagram* datagrams, uint_t* count);
 
     private:
         SOCKET m_socket;
@@ -1,6 +1,7 @@
 //------------------------------------------ Includes ----------------------------------------------
 
 #include "serialPort.h"
+#include "platform/eventLoop.h"
 #include <aclapi.h>
 #include <winerror.h>
 #include <array>
@@ -268,6 +269,7 @@ void SerialPort::threadRxTx()
                     {
                         resetOv(ovRead);
                         rxDataEvent(m_rxBuf, bytesRead, m_baudrate);
+                        EventLoop::wake();
                     }
                     else
                     {
@@ -295,6 +297,7 @@ void SerialPort::threadRxTx()
             {
                 resetOv(ovRead);
                 rxDataEvent(m_rxBuf, bytesRead, m_baudrate);
+                EventLoop::wake();
             }
             else
             {
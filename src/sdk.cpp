@@ -7,11 +7,23 @@
 #include "comms/protocols/nmea.h"
 #include "platform/netSocket.h"
 #include "platform/debug.h"
+#include "platform/eventLoop.h"
+#include "platform/mem.h"
 
 using namespace IslSdk;
 
+struct FrameHeader                  ///< Prefixes frames queued for the application thread
+{
+    uint32_t portId;
+    uint32_t baudrate;
+    uint32_t ipAddress;
+    uint16_t port;
+};
+
+const uint_t frameQueueSize = 1024 * 64;
+
 //--------------------------------------------------------------------------------------------------
-Sdk::Sdk() : m_first(true)
+Sdk::Sdk() : m_first(true), m_ioMode(false), m_ioRunning(false), m_ioEvents(false)
 {
     NetSocket::initialise();
     ports.onNew.connect(m_slotNewPort);
@@ -19,19 +31,200 @@ Sdk::Sdk() : m_first(true)
 //--------------------------------------------------------------------------------------------------
 Sdk::~Sdk()
 {
+    stopIoThread();
     NetSocket::deinitialise();
 }
 //--------------------------------------------------------------------------------------------------
 void Sdk::run()
+{
+    run(0);
+}
+//--------------------------------------------------------------------------------------------------
+void Sdk::run(uint_t waitMs)
 {
     if (m_first)
     {
         ports.createNetPort("NETWORK", false, false, 0xffffffff, 0);
         m_first = false;
+        waitMs = 0;
+    }
+
+    if (m_ioMode)
+    {
+        if (waitMs)
+        {
+            std::unique_lock<std::mutex> lock(m_ioWaitMutex);
+            m_ioWait.wait_for(lock, std::chrono::milliseconds(waitMs), [this] { return m_ioEvents; });
+        }
+        dispatchIoEvents(false);
+    }
+    else
+    {
+        // One wait on every socket replaces a select per socket in each port's read
+        EventLoop::wait(waitMs);
+        ports.receive();
+        ports.run();
+        devices.run();
+        devices.process();
+        ports.flush();
+    }
+}
+//--------------------------------------------------------------------------------------------------
+void Sdk::wake()
+{
+    if (m_ioMode)
+    {
+        std::lock_guard<std::mutex> lock(m_ioWaitMutex);
+        m_ioEvents = true;
+        m_ioWait.notify_one();
+    }
+    else
+    {
+        EventLoop::wake();
+    }
+}
+//--------------------------------------------------------------------------------------------------
+void Sdk::startIoThread(const IoThreadConfig& config)
+{
+    if (!m_ioMode)
+    {
+        std::lock_guard<std::recursive_mutex> lock(SysPort::commsMutex);
+
+        if (m_first)
+        {
+            ports.createNetPort("NETWORK", false, false, 0xffffffff, 0);
+            m_first = false;
+        }
+
+        m_ioConfig = config;
+        m_ioFrames = std::make_unique<EventQueue>(frameQueueSize, m_ioConfig.maxBackloggedPings, frameQueueSize);
+
+        for (const Device::SharedPtr& device : devices.deviceList)
+        {
+            useEventQueue(*device);
+        }
+
+        m_ioMode = true;
+        m_ioRunning = true;
+        m_ioThread = std::thread(&Sdk::ioThread, this);
+    }
+}
+//--------------------------------------------------------------------------------------------------
+void Sdk::stopIoThread()
+{
+    if (m_ioMode)
+    {
+        m_ioRunning = false;
+        EventLoop::wake();
+        m_ioThread.join();
+        m_ioMode = false;
+
+        dispatchIoEvents(true);
+
+        std::lock_guard<std::recursive_mutex> lock(SysPort::commsMutex);
+        for (const Device::SharedPtr& device : devices.deviceList)
+        {
+            device->m_events.reset();
+        }
+        m_ioFrames.reset();
     }
+}
+//--------------------------------------------------------------------------------------------------
+void Sdk::ioThread()
+{
+    while (m_ioRunning)
+    {
+        EventLoop::wait(m_ioConfig.waitMs);
+        bool_t queued;
 
-    ports.run();
-    devices.run();
+        {
+            std::lock_guard<std::recursive_mutex> lock(SysPort::commsMutex);
+
+            ports.receive();
+            devices.process();
+            ports.flush();
+
+            // Retry events held back while the application thread was behind
+            m_ioFrames->flush();
+            queued = m_ioFrames->count() != 0;
+
+            for (const Device::SharedPtr& device : devices.deviceList)
+            {
+                if (device->m_events)
+                {
+                    device->m_events->flush();
+                    queued = queued || device->m_events->count() != 0;
+                }
+            }
+        }
+
+        if (queued)
+        {
+            std::lock_guard<std::mutex> lock(m_ioWaitMutex);
+            m_ioEvents = true;
+            m_ioWait.notify_one();
+        }
+    }
+}
+//--------------------------------------------------------------------------------------------------
+void Sdk::dispatchIoEvents(bool_t stopping)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_ioWaitMutex);
+        m_ioEvents = false;
+    }
+
+    {
+        std::lock_guard<std::recursive_mutex> lock(SysPort::commsMutex);
+
+        ports.run();
+
+        bool_t empty;
+        do
+        {
+            // Once the I/O thread has stopped this thread is the producer too so can drain the backlog
+            empty = !stopping || m_ioFrames->flush();
+
+            while (const EventQueue::Event* event = m_ioFrames->peek())
+            {
+                FrameHeader header;
+                Mem::memcpy(&header, event->data, sizeof(header));
+                SysPort::SharedPtr sysPort = ports.findById(header.portId);
+
+                if (sysPort)
+                {
+                    processFrame(*sysPort, event->data + sizeof(header), event->size - sizeof(header), ConnectionMeta(header.baudrate, header.ipAddress, header.port), static_cast<Codec::Type>(event->type));
+                }
+                m_ioFrames->pop();
+            }
+        } while (!empty);
+
+        devices.run();
+        ports.flush();
+        m_ioDevices.assign(devices.deviceList.begin(), devices.deviceList.end());
+    }
+
+    // Device events are raised without the lock so slow handlers don't hold up the I/O thread
+    for (const Device::SharedPtr& device : m_ioDevices)
+    {
+        if (device->m_events)
+        {
+            bool_t empty;
+            do
+            {
+                empty = !stopping || device->m_events->flush();
+                device->dispatchEvents();
+            } while (!empty);
+        }
+    }
+    m_ioDevices.clear();
+}
+//--------------------------------------------------------------------------------------------------
+void Sdk::useEventQueue(Device& device)
+{
+    device.m_events = std::make_unique<EventQueue>(m_ioConfig.deviceQueueSize, m_ioConfig.maxBackloggedPings, m_ioConfig.maxBacklogSize);
+    device.m_pingPolicy = m_ioConfig.pingPolicy;
+    device.m_replyPolicy = m_ioConfig.replyPolicy;
 }
 //--------------------------------------------------------------------------------------------------
 void Sdk::newPort(const SysPort::SharedPtr& sysPort)
@@ -47,6 +240,61 @@ void Sdk::portDeleted(SysPort& sysPort)
 }
 //--------------------------------------------------------------------------------------------------
 void Sdk::newFrameEvent(SysPort& sysPort, const uint8_t* data, uint_t size, const ConnectionMeta& meta, Codec::Type codecType)
+{
+    if (!m_ioMode)
+    {
+        processFrame(sysPort, data, size, meta, codecType);
+    }
+    else if (codecType == Codec::Type::Nmea)
+    {
+        queueFrame(sysPort, data, size, meta, codecType, m_ioConfig.pingPolicy);
+    }
+    else
+    {
+        IslHdlcPacket packet;
+
+        if (packet.fromFrame(data, size))
+        {
+            if (packet.header.type == IslHdlcPacket::FrameType::U && packet.header.uCode == IslHdlcPacket::UframeCode::Discover && !packet.header.cr)
+            {
+                queueFrame(sysPort, data, size, meta, codecType, EventQueue::Policy::NeverDrop);
+            }
+            else
+            {
+                const Device::SharedPtr& device = devices.findByAddress(packet.header.address);
+
+                if (device)
+                {
+                    device->processPacket(packet);
+                }
+            }
+        }
+        else
+        {
+            sysPort.m_badRxPacketCount++;
+        }
+    }
+}
+//--------------------------------------------------------------------------------------------------
+void Sdk::queueFrame(SysPort& sysPort, const uint8_t* data, uint_t size, const ConnectionMeta& meta, Codec::Type codecType, EventQueue::Policy policy)
+{
+    FrameHeader header;
+    header.portId = sysPort.id;
+    header.baudrate = meta.baudrate;
+    header.ipAddress = meta.ipAddress;
+    header.port = meta.port;
+
+    uint8_t* buf = m_ioFrames->newEvent(static_cast<uint8_t>(codecType), sizeof(header) + size, policy);
+
+    if (buf)
+    {
+        Mem::memcpy(buf, &header, sizeof(header));
+        Mem::memcpy(buf + sizeof(header), data, size);
+        m_ioFrames->push();
+    }
+}
+//--------------------------------------------------------------------------------------------------
+void Sdk::processFrame(SysPort& sysPort, const uint8_t* data, uint_t size, const ConnectionMeta& meta, Codec::Type codecType)
 {
     if (codecType == Codec::Type::Nmea)
     {
@@ -92,6 +340,10 @@ void Sdk::newFrameEvent(SysPort& sysPort, const uint8_t* data, uint_t size, cons
                 if (newDevice)
                 {
                     device = devices.createDevice(deviceInfo);
+                    if (m_ioMode)
+                    {
+                        useEventQueue(*device);
+                    }
                 }
                 else if (device->m_address == packet.header.address)
                 {
@@ -8,6 +8,11 @@
 #include "devices/deviceMgr.h"
 #include "nmeaDevices/nmeaDeviceMgr.h"
 #include "types/sigSlot.h"
+#include "types/eventQueue.h"
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
 
 //--------------------------------------- Class Definition -----------------------------------------
 
@@ -25,6 +30,18 @@ namespace IslSdk
         DeviceMgr devices {ports};
         NmeaDeviceMgr nmeaDevices;
 
+        /// Settings for the I/O thread, see startIoThread().
+        struct IoThreadConfig
+        {
+            uint_t waitMs;                          ///< Longest the I/O thread sleeps when there's no data, this is the resolution of the protocol timers.
+            uint_t deviceQueueSize;                 ///< Size in bytes of each device's event queue.
+            uint_t maxBackloggedPings;              ///< Pings held back while a device's queue is full, beyond this the oldest are dropped when \p pingPolicy is DropOldest.
+            uint_t maxBacklogSize;                  ///< Bytes of events held back while a device's queue is full, beyond this events are discarded whatever their policy.
+            EventQueue::Policy pingPolicy;          ///< What happens to ping data and NMEA sentences when the application falls behind.
+            EventQueue::Policy replyPolicy;         ///< What happens to settings replies and all other device packets when the application falls behind.
+            IoThreadConfig() : waitMs(10), deviceQueueSize(1024 * 256), maxBackloggedPings(2), maxBacklogSize(1024 * 256), pingPolicy(EventQueue::Policy::DropOldest), replyPolicy(EventQueue::Policy::NeverDrop) {}
+        };
+
         /**
         * @brief Create a new instance of the SDK.
         * This function is responsible for creating a new instance of the SDK.
@@ -42,13 +59,55 @@ namespace IslSdk
         */
         void run();
 
+        /**
+        * @brief Waits for data then runs the SDK.
+        * Blocks for up to \p waitMs or until data arrives on any port, then does the same work as run().
+        * Call this in a loop in place of run() and a sleep so received data is handled as soon as it arrives.
+        * @param waitMs The maximum time to wait in milliseconds, 50 is ideal so timers and retries still run.
+        */
+        void run(uint_t waitMs);
+
+        /**
+        * @brief Wakes a thread blocked in run(uint_t waitMs).
+        * This function is thread safe.
+        */
+        void wake();
+
+        /**
+        * @brief Moves reception onto an internal I/O thread.
+        * The I/O thread reads the ports, decodes frames and runs the HDLC protocol so devices are acknowledged and
+        * resent to on time however long the application takes to handle its events. Device events (packets, connection
+        * changes and comms timeouts) are passed to the application through a bounded queue per device and raised from
+        * run() as before, so signal handlers still run on the application thread. Discovery and port events are also
+        * raised from run(). SysPort::onRxData and SysPort::onTxData are raised on the I/O thread.
+        * @param config The queue sizes and back-pressure policies.
+        */
+        void startIoThread(const IoThreadConfig& config = IoThreadConfig());
+
+        /// Stops the I/O thread, any queued events are raised before returning.
+        void stopIoThread();
+
     private:
         Slot<const SysPort::SharedPtr&> m_slotNewPort{ this, &Sdk::newPort };
         Slot<SysPort&> m_slotPortDeleted{ this, & Sdk::portDeleted };
         bool_t m_first;
+        IoThreadConfig m_ioConfig;
+        std::thread m_ioThread;
+        std::atomic<bool_t> m_ioMode;                       ///< True while received frames are handled by the I/O thread
+        std::atomic<bool_t> m_ioRunning;
+        std::unique_ptr<EventQueue> m_ioFrames;             ///< Frames for the application thread, discovery replies and NMEA
+        std::mutex m_ioWaitMutex;
+        std::condition_variable m_ioWait;
+        bool_t m_ioEvents;
+        std::vector<Device::SharedPtr> m_ioDevices;
         void newPort(const SysPort::SharedPtr& sysPort);
         void portDeleted(SysPort& sysPort);
         void newFrameEvent(SysPort& sysPort, const uint8_t* data, uint_t size, const ConnectionMeta& meta, Codec::Type codecType);
+        void processFrame(SysPort& sysPort, const uint8_t* data, uint_t size, const ConnectionMeta& meta, Codec::Type codecType);
+        void queueFrame(SysPort& sysPort, const uint8_t* data, uint_t size, const ConnectionMeta& meta, Codec::Type codecType, EventQueue::Policy policy);
+        void ioThread();
+        void dispatchIoEvents(bool_t stopping);
+        void useEventQueue(Device& device);
     };
 }
 
@@ -0,0 +1,189 @@
+//------------------------------------------ Includes ----------------------------------------------
+
+#include "bufferPool.h"
+
+using namespace IslSdk;
+
+//--------------------------------------------------------------------------------------------------
+BufferPool::Ref::Ref(const Ref& other) : m_buf(other.m_buf)
+{
+    if (m_buf)
+    {
+        m_buf->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+//--------------------------------------------------------------------------------------------------
+BufferPool::Ref& BufferPool::Ref::operator=(const Ref& other)
+{
+    if (other.m_buf)
+    {
+        other.m_buf->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+    reset();
+    m_buf = other.m_buf;
+    return *this;
+}
+//--------------------------------------------------------------------------------------------------
+BufferPool::Ref& BufferPool::Ref::operator=(Ref&& other) noexcept
+{
+    if (this != &other)
+    {
+        reset();
+        m_buf = other.m_buf;
+        other.m_buf = nullptr;
+    }
+    return *this;
+}
+//--------------------------------------------------------------------------------------------------
+void BufferPool::Ref::reset()
+{
+    if (m_buf)
+    {
+        if (m_buf->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            release(m_buf);
+        }
+        m_buf = nullptr;
+    }
+}
+//--------------------------------------------------------------------------------------------------
+uint8_t* BufferPool::Ref::data() const
+{
+    return m_buf ? m_buf->data.data() : nullptr;
+}
+//--------------------------------------------------------------------------------------------------
+uint_t BufferPool::Ref::capacity() const
+{
+    return m_buf ? m_buf->data.size() : 0;
+}
+//--------------------------------------------------------------------------------------------------
+bool_t BufferPool::Ref::shared() const
+{
+    return m_buf && m_buf->refs.load(std::memory_order_acquire) > 1;
+}
+//--------------------------------------------------------------------------------------------------
+bool_t BufferPool::Ref::contains(const uint8_t* ptr, uint_t size) const
+{
+    if (m_buf)
+    {
+        const uint8_t* start = m_buf->data.data();
+        return ptr >= start && ptr + size <= start + m_buf->data.size();
+    }
+    return false;
+}
+//--------------------------------------------------------------------------------------------------
+BufferPool::BufferPool(uint_t bufferSize, uint_t count) : m_shared(new Shared())
+{
+    m_shared->bufferSize = bufferSize;
+    m_shared->liveCount = 1;
+    m_shared->closed = false;
+    m_shared->free.reserve(count);
+
+    for (uint_t i = 0; i < count; i++)
+    {
+        Buffer* buf = new Buffer();
+        buf->shared = m_shared;
+        buf->data.resize(bufferSize);
+        m_shared->free.push_back(buf);
+        m_shared->liveCount++;
+    }
+}
+//--------------------------------------------------------------------------------------------------
+BufferPool::~BufferPool()
+{
+    bool_t last;
+
+    {
+        std::lock_guard<std::mutex> lock(m_shared->mutex);
+
+        // Buffers still referenced are freed as they are released
+        for (Buffer* buf : m_shared->free)
+        {
+            delete buf;
+        }
+        m_shared->liveCount -= m_shared->free.size() + 1;
+        m_shared->free.clear();
+        m_shared->closed = true;
+        last = m_shared->liveCount == 0;
+    }
+
+    if (last)
+    {
+        delete m_shared;
+    }
+}
+//--------------------------------------------------------------------------------------------------
+BufferPool::Ref BufferPool::get(uint_t size)
+{
+    Buffer* buf = nullptr;
+
+    if (size > m_shared->bufferSize)
+    {
+        buf = new Buffer();
+        buf->shared = nullptr;
+        buf->data.resize(size);
+    }
+    else
+    {
+        std::lock_guard<std::mutex> lock(m_shared->mutex);
+
+        if (m_shared->free.empty())
+        {
+            buf = new Buffer();
+            buf->shared = m_shared;
+            buf->data.resize(m_shared->bufferSize);
+            m_shared->liveCount++;
+        }
+        else
+        {
+            buf = m_shared->free.back();
+            m_shared->free.pop_back();
+        }
+    }
+
+    buf->refs.store(1, std::memory_order_relaxed);
+    return Ref(buf);
+}
+//--------------------------------------------------------------------------------------------------
+uint_t BufferPool::bufferSize() const
+{
+    return m_shared->bufferSize;
+}
+//--------------------------------------------------------------------------------------------------
+uint_t BufferPool::allocatedCount() const
+{
+    std::lock_guard<std::mutex> lock(m_shared->mutex);
+    return m_shared->liveCount - 1;
+}
+//--------------------------------------------------------------------------------------------------
+void BufferPool::release(Buffer* buf)
+{
+    Shared* shared = buf->shared;
+    bool_t last = false;
+
+    if (!shared)
+    {
+        delete buf;
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(shared->mutex);
+
+        if (shared->closed)
+        {
+            delete buf;
+            last = --shared->liveCount == 0;
+        }
+        else
+        {
+            shared->free.push_back(buf);
+        }
+    }
+
+    if (last)
+    {
+        delete shared;
+    }
+}
+//--------------------------------------------------------------------------------------------------
@@ -0,0 +1,105 @@
+#ifndef BUFFERPOOL_H_
+#define BUFFERPOOL_H_
+
+//------------------------------------------ Includes ----------------------------------------------
+
+#include "types/sdkTypes.h"
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+//--------------------------------------- Class Definition -----------------------------------------
+
+namespace IslSdk
+{
+    /**
+    * @brief A pool of reference counted buffers.
+    * Ports receive into pooled buffers and decode frames in place, so a frame can be held by taking a reference to
+    * its buffer rather than copying it. A buffer goes back to the pool when its last reference is released, which
+    * can be after the pool itself has been destroyed.
+    */
+    class BufferPool
+    {
+    private:
+        struct Buffer;
+        struct Shared;
+
+    public:
+        /// A counted reference to a pooled buffer, copying it adds a reference.
+        class Ref
+        {
+        public:
+            Ref() : m_buf(nullptr) {}
+            Ref(const Ref& other);
+            Ref(Ref&& other) noexcept : m_buf(other.m_buf) { other.m_buf = nullptr; }
+            Ref& operator=(const Ref& other);
+            Ref& operator=(Ref&& other) noexcept;
+            ~Ref() { reset(); }
+
+            void reset();                                   ///< Releases the reference.
+            uint8_t* data() const;                          ///< The start of the buffer.
+            uint_t capacity() const;                        ///< The size of the buffer in bytes.
+            bool_t shared() const;                          ///< True if there are other references to the buffer.
+            bool_t contains(const uint8_t* ptr, uint_t size) const;
+            explicit operator bool() const { return m_buf != nullptr; }
+
+        private:
+            friend class BufferPool;
+            explicit Ref(Buffer* buf) : m_buf(buf) {}
+            Buffer* m_buf;
+        };
+
+        /**
+        * @brief Constructor.
+        * @param bufferSize The size of each buffer in bytes.
+        * @param count The number of buffers to allocate up front, more are allocated if they run out.
+        */
+        BufferPool(uint_t bufferSize, uint_t count);
+        ~BufferPool();
+        BufferPool(const BufferPool&) = delete;
+        BufferPool& operator=(const BufferPool&) = delete;
+
+        /**
+        * @brief Gets a free buffer.
+        * @param size The size needed, a buffer larger than bufferSize is allocated on its own and freed on release.
+        * @return A reference to the buffer.
+        */
+        Ref get(uint_t size = 0);
+        uint_t bufferSize() const;
+        uint_t allocatedCount() const;                      ///< The number of buffers allocated, free or in use.
+
+    private:
+        struct Buffer
+        {
+            std::atomic<uint32_t> refs;
+            Shared* shared;                                 ///< Null for a buffer that doesn't belong to the pool.
+            std::vector<uint8_t> data;
+        };
+
+        /// The part of the pool that lives on until the last buffer is released.
+        struct Shared
+        {
+            std::mutex mutex;
+            std::vector<Buffer*> free;
+            uint_t bufferSize;
+            uint_t liveCount;                               ///< Buffers allocated plus one while the pool exists.
+            bool_t closed;
+        };
+
+        Shared* m_shared;
+
+        static void release(Buffer* buf);
+    };
+
+    /// Part of a pooled buffer, kept valid by its reference. An empty reference means the data is only valid for the current call.
+    struct BufferSlice
+    {
+        BufferPool::Ref buffer;
+        const uint8_t* data;
+        uint_t size;
+    };
+
+    typedef std::vector<BufferSlice> ScatterList;
+}
+//--------------------------------------------------------------------------------------------------
+#endif
@@ -0,0 +1,133 @@
+//------------------------------------------ Includes ----------------------------------------------
+
+#include "eventQueue.h"
+#include "platform/mem.h"
+#include "platform/debug.h"
+
+using namespace IslSdk;
+
+//--------------------------------------------------------------------------------------------------
+EventQueue::EventQueue(uint_t size, uint_t maxDroppable, uint_t maxBacklogSize) :
+    m_queue(size),
+    m_backlogSize(0),
+    m_maxBacklogSize(maxBacklogSize),
+    m_droppableCount(0),
+    m_maxDroppable(maxDroppable ? maxDroppable : 1),
+    m_inBacklog(false),
+    m_overflowing(false),
+    m_droppedCount(0),
+    m_overflowCount(0)
+{
+}
+//--------------------------------------------------------------------------------------------------
+uint8_t* EventQueue::newEvent(uint8_t type, uint_t size, Policy policy)
+{
+    Event* event = nullptr;
+
+    // Events can only go straight into the queue once the backlog has drained, otherwise they'd be out of order
+    if (flush())
+    {
+        event = reinterpret_cast<Event*>(m_queue.tryNewItem(sizeof(Event) + size));
+    }
+
+    if (event)
+    {
+        event->type = type;
+        event->size = size;
+        event->data = reinterpret_cast<uint8_t*>(event) + sizeof(Event);
+        m_inBacklog = false;
+        return event->data;
+    }
+
+    m_inBacklog = true;
+
+    if (policy == Policy::DropOldest && m_droppableCount >= m_maxDroppable)
+    {
+        for (std::deque<Pending>::iterator it = m_backlog.begin(); it != m_backlog.end(); it++)
+        {
+            if (it->policy == Policy::DropOldest)
+            {
+                m_backlogSize -= it->data.size();
+                m_backlog.erase(it);
+                m_droppableCount--;
+                m_droppedCount++;
+                break;
+            }
+        }
+    }
+
+    // The consumer has stalled, so discard rather than grow without limit
+    if (m_backlogSize + size > m_maxBacklogSize)
+    {
+        if (!m_overflowing)
+        {
+            debugLog("EventQueue", "backlog full, discarding events until the consumer catches up");
+            m_overflowing = true;
+        }
+        m_overflowCount++;
+        return nullptr;
+    }
+
+    if (policy == Policy::DropOldest)
+    {
+        m_droppableCount++;
+    }
+
+    m_backlogSize += size;
+    m_backlog.emplace_back();
+    m_backlog.back().type = type;
+    m_backlog.back().policy = policy;
+    m_backlog.back().data.resize(size);
+
+    return m_backlog.back().data.data();
+}
+//--------------------------------------------------------------------------------------------------
+void EventQueue::push()
+{
+    if (!m_inBacklog)
+    {
+        m_queue.push();
+    }
+    m_inBacklog = false;
+}
+//--------------------------------------------------------------------------------------------------
+bool_t EventQueue::flush()
+{
+    while (!m_backlog.empty())
+    {
+        Pending& pending = m_backlog.front();
+        Event* event = reinterpret_cast<Event*>(m_queue.tryNewItem(sizeof(Event) + pending.data.size()));
+
+        if (event == nullptr)
+        {
+            return false;
+        }
+
+        event->type = pending.type;
+        event->size = pending.data.size();
+        event->data = reinterpret_cast<uint8_t*>(event) + sizeof(Event);
+        Mem::memcpy(event->data, pending.data.data(), event->size);
+        m_queue.push();
+
+        if (pending.policy == Policy::DropOldest)
+        {
+            m_droppableCount--;
+        }
+        m_backlogSize -= pending.data.size();
+        m_backlog.pop_front();
+    }
+
+    m_overflowing = false;
+    return true;
+}
+//--------------------------------------------------------------------------------------------------
+const EventQueue::Event* EventQueue::peek()
+{
+    return reinterpret_cast<const Event*>(m_queue.peekNextItem());
+}
+//--------------------------------------------------------------------------------------------------
+void EventQueue::pop()
+{
+    m_queue.pop();
+}
+//--------------------------------------------------------------------------------------------------
@@ -0,0 +1,103 @@
+#ifndef EVENTQUEUE_H_
+#define EVENTQUEUE_H_
+
+//------------------------------------------ Includes ----------------------------------------------
+
+#include "types/sdkTypes.h"
+#include "types/queue.h"
+#include <atomic>
+#include <deque>
+#include <vector>
+
+//--------------------------------------- Class Definition -----------------------------------------
+
+namespace IslSdk
+{
+    /**
+    * @brief A bounded single producer single consumer queue of events.
+    * Hands events from the SDK's I/O thread to the application thread. Events are written straight into a
+    * lock free Queue, when it is full they wait in a backlog owned by the producer so the producer never blocks.
+    * The policy of each event decides what happens to it while it is in the backlog. The backlog is bounded, events
+    * that don't fit are discarded and counted by overflowCount().
+    */
+    class EventQueue
+    {
+    public:
+        /// What to do with an event that can't be queued because the consumer is behind.
+        enum class Policy
+        {
+            NeverDrop,      ///< Keep the event until there is room, used for replies the application is waiting on.
+            DropOldest,     ///< Discard the oldest waiting event of this policy so the newest is delivered, used for pings.
+        };
+
+        struct Event
+        {
+            uint8_t type;                           ///< Meaning is defined by the user of the queue.
+            uint_t size;                            ///< Size of the data in bytes.
+            uint8_t* data;                          ///< The event data.
+        };
+
+        /**
+        * @brief Constructor.
+        * @param size Size of the lock free queue in bytes.
+        * @param maxDroppable The number of DropOldest events that can wait in the backlog, minimum 1.
+        * @param maxBacklogSize Total size in bytes of the event data that can wait in the backlog.
+        */
+        EventQueue(uint_t size, uint_t maxDroppable, uint_t maxBacklogSize);
+
+        /**
+        * @brief Reserves space for a new event, called by the producer only.
+        * @param type The event type.
+        * @param size The size of the event data in bytes.
+        * @param policy What to do with the event if the queue is full.
+        * @return A buffer of \p size bytes to write the event data into, it's queued by calling push().
+        * nullptr if the backlog is full, the event is discarded and push() does nothing.
+        */
+        uint8_t* newEvent(uint8_t type, uint_t size, Policy policy);
+
+        /// Queues the event returned by newEvent(), called by the producer only.
+        void push();
+
+        /**
+        * @brief Moves events from the backlog into the queue, called by the producer only.
+        * @return True if the backlog is empty.
+        */
+        bool_t flush();
+
+        /// Returns the next event or nullptr, called by the consumer only.
+        const Event* peek();
+
+        /// Removes the event returned by peek(), called by the consumer only.
+        void pop();
+
+        /// Returns the number of events in the lock free queue, safe to call from either thread.
+        uint_t count() { return m_queue.itemCount(); }
+
+        /// Returns the number of DropOldest events discarded.
+        uint_t droppedCount() const { return m_droppedCount; }
+
+        /// Returns the number of events of either policy discarded because the backlog was full.
+        uint_t overflowCount() const { return m_overflowCount; }
+
+    private:
+        struct Pending
+        {
+            uint8_t type;
+            Policy policy;
+            std::vector<uint8_t> data;
+        };
+
+        Queue m_queue;
+        std::deque<Pending> m_backlog;
+        uint_t m_backlogSize;
+        const uint_t m_maxBacklogSize;
+        uint_t m_droppableCount;
+        const uint_t m_maxDroppable;
+        bool_t m_inBacklog;                     ///< The last newEvent() didn't go into the lock free queue, so push() has nothing to do
+        bool_t m_overflowing;
+        std::atomic<uint_t> m_droppedCount;
+        std::atomic<uint_t> m_overflowCount;
+    };
+}
+//--------------------------------------------------------------------------------------------------
+#endif
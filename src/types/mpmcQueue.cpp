@@ -0,0 +1,258 @@
+//------------------------------------------ Includes ----------------------------------------------
+
+#include "mpmcQueue.h"
+#include "platform/debug.h"
+#include "maths/maths.h"
+#include <chrono>
+
+using namespace IslSdk;
+
+//--------------------------------------------------------------------------------------------------
+MpmcQueue::MpmcQueue(uint_t size) :
+    m_bufSize(alignment),
+    m_write(0),
+    m_read(0),
+    m_free(0),
+    m_itemsPushed(0),
+    m_itemsPopped(0)
+{
+    while (m_bufSize < size)
+    {
+        m_bufSize <<= 1;
+    }
+
+    m_buf = new uint8_t[m_bufSize];
+    m_slots = new Slot[m_bufSize / alignment];
+    reset();
+}
+//--------------------------------------------------------------------------------------------------
+MpmcQueue::~MpmcQueue()
+{
+    delete[] m_slots;
+    delete[] m_buf;
+}
+//--------------------------------------------------------------------------------------------------
+void MpmcQueue::reset()
+{
+    for (uint_t i = 0; i < m_bufSize / alignment; i++)
+    {
+        m_slots[i].state.store(0, std::memory_order_relaxed);
+        m_slots[i].size.store(0, std::memory_order_relaxed);
+    }
+    m_write = 0;
+    m_read = 0;
+    m_free = 0;
+    m_itemsPushed = 0;
+    m_itemsPopped = 0;
+}
+//--------------------------------------------------------------------------------------------------
+uint_t MpmcQueue::itemCount() const
+{
+    return m_itemsPushed - m_itemsPopped;
+}
+//--------------------------------------------------------------------------------------------------
+uint_t MpmcQueue::itemSize(const void* item)
+{
+    return reinterpret_cast<const Header*>(static_cast<const uint8_t*>(item) - headerSize)->itemSize;
+}
+//--------------------------------------------------------------------------------------------------
+void* MpmcQueue::newItem(uint_t size)
+{
+    void* item = reserve(size);
+
+    if (!item)
+    {
+        debugLog("Queue", "out of memory: requested %u", FMT_U(size));
+    }
+    return item;
+}
+//--------------------------------------------------------------------------------------------------
+void* MpmcQueue::reserve(uint_t size)
+{
+    uint_t recordSize = (headerSize + size + alignment - 1) & ~(alignment - 1);
+    uint64_t pos = m_write.load(std::memory_order_relaxed);
+    uint_t pad;
+
+    if (!size || recordSize > m_bufSize || recordSize > Math::maxUint32)
+    {
+        return nullptr;
+    }
+
+    // An item doesn't wrap around the end of the buffer, so the space left there is reserved along with it and skipped
+    do
+    {
+        uint_t idx = static_cast<uint_t>(pos & (m_bufSize - 1));
+        pad = idx + recordSize > m_bufSize ? m_bufSize - idx : 0;
+
+        if (pos + pad + recordSize - m_free.load() > m_bufSize)
+        {
+            return nullptr;
+        }
+    } while (!m_write.compare_exchange_weak(pos, pos + pad + recordSize, std::memory_order_relaxed));
+
+    if (pad)
+    {
+        slot(pos).size.store(static_cast<uint32_t>(pad), std::memory_order_relaxed);
+        slot(pos).state.store(pos | skip);
+        pos += pad;
+    }
+
+    Header* hdr = header(pos);
+    hdr->pos = pos;
+    hdr->itemSize = static_cast<uint32_t>(size);
+    slot(pos).size.store(static_cast<uint32_t>(recordSize), std::memory_order_relaxed);
+    slot(pos).state.store(pos, std::memory_order_relaxed);
+
+    return reinterpret_cast<uint8_t*>(hdr) + headerSize;
+}
+//--------------------------------------------------------------------------------------------------
+void MpmcQueue::cancelNewItem(void* item)
+{
+    Header* hdr = reinterpret_cast<Header*>(static_cast<uint8_t*>(item) - headerSize);
+    slot(hdr->pos).state.store(hdr->pos | skip);
+}
+//--------------------------------------------------------------------------------------------------
+void MpmcQueue::push(void* item)
+{
+    Header* hdr = reinterpret_cast<Header*>(static_cast<uint8_t*>(item) - headerSize);
+    slot(hdr->pos).state.store(hdr->pos | ready);
+    m_itemsPushed++;
+}
+//--------------------------------------------------------------------------------------------------
+void* MpmcQueue::peekNextItem()
+{
+    uint64_t pos = m_read.load();
+
+    while (true)
+    {
+        // pos may be stale, the slot is only trusted if the state holds this position and the claim below succeeds
+        Slot& s = slot(pos);
+        uint64_t state = s.state.load();
+        uint_t size = s.size.load(std::memory_order_relaxed);
+
+        if (state == (pos | ready) || state == (pos | skip))
+        {
+            // Fails if another consumer took it first, in which case pos is reloaded
+            if (m_read.compare_exchange_weak(pos, pos + size))
+            {
+                if (state & ready)
+                {
+                    return reinterpret_cast<uint8_t*>(header(pos)) + headerSize;
+                }
+                release(pos);
+                pos += size;
+            }
+        }
+        else
+        {
+            uint64_t read = m_read.load();
+            if (read == pos)
+            {
+                return nullptr;                             // Not pushed yet
+            }
+            pos = read;
+        }
+    }
+}
+//--------------------------------------------------------------------------------------------------
+void MpmcQueue::pop(void* item)
+{
+    Header* hdr = reinterpret_cast<Header*>(static_cast<uint8_t*>(item) - headerSize);
+    release(hdr->pos);
+    m_itemsPopped++;
+}
+//--------------------------------------------------------------------------------------------------
+void MpmcQueue::release(uint64_t pos)
+{
+    slot(pos).state.store(pos | consumed);
+
+    // Whoever releases the oldest item moves m_free on past it and any released after it
+    uint64_t free = m_free.load();
+    while (true)
+    {
+        Slot& oldest = slot(free);
+        if (oldest.state.load() != (free | consumed))
+        {
+            break;
+        }
+
+        uint64_t next = free + oldest.size.load(std::memory_order_relaxed);
+        if (m_free.compare_exchange_weak(free, next))
+        {
+            free = next;
+        }
+    }
+}
+//--------------------------------------------------------------------------------------------------
+BlockingMpmcQueue::BlockingMpmcQueue(uint_t size) :
+    MpmcQueue(size),
+    m_consumersWaiting(0),
+    m_producersWaiting(0)
+{
+}
+//--------------------------------------------------------------------------------------------------
+void* BlockingMpmcQueue::newItem(uint_t size, uint_t timeoutMs)
+{
+    void* item = reserve(size);
+
+    if (!item && timeoutMs)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        // Counted before trying again, so pop() either frees the space first or sees there's a producer to wake
+        m_producersWaiting++;
+        m_itemPopped.wait_for(lock, std::chrono::milliseconds(timeoutMs), [&]() { return (item = reserve(size)) != nullptr; });
+        m_producersWaiting--;
+    }
+    return item;
+}
+//--------------------------------------------------------------------------------------------------
+void BlockingMpmcQueue::push(void* item)
+{
+    MpmcQueue::push(item);
+
+    if (m_consumersWaiting.load())
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_itemPushed.notify_all();
+    }
+}
+//--------------------------------------------------------------------------------------------------
+void BlockingMpmcQueue::cancelNewItem(void* item)
+{
+    MpmcQueue::cancelNewItem(item);
+
+    // Items pushed after this one can now be reached
+    if (m_consumersWaiting.load())
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_itemPushed.notify_all();
+    }
+}
+//--------------------------------------------------------------------------------------------------
+void* BlockingMpmcQueue::peekNextItem(uint_t timeoutMs)
+{
+    void* item = MpmcQueue::peekNextItem();
+
+    if (!item && timeoutMs)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        m_consumersWaiting++;
+        m_itemPushed.wait_for(lock, std::chrono::milliseconds(timeoutMs), [&]() { return (item = MpmcQueue::peekNextItem()) != nullptr; });
+        m_consumersWaiting--;
+    }
+    return item;
+}
+//--------------------------------------------------------------------------------------------------
+void BlockingMpmcQueue::pop(void* item)
+{
+    MpmcQueue::pop(item);
+
+    if (m_producersWaiting.load())
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_itemPopped.notify_all();
+    }
+}
+//--------------------------------------------------------------------------------------------------
@@ -0,0 +1,135 @@
+#ifndef MPMCQUEUE_H_
+#define MPMCQUEUE_H_
+
+//------------------------------------------ Includes ----------------------------------------------
+
+#include "types/sdkTypes.h"
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+
+//--------------------------------------- Class Definition -----------------------------------------
+
+namespace IslSdk
+{
+    /**
+    * @brief A bounded lock free queue of variable size items for any number of producers and consumers.
+    * Works like Queue, but an item is passed back to push() and pop() because several can be in progress at once.
+    * Producers reserve space by moving a shared write position, so items are queued in the order newItem() was
+    * called and a consumer waits for an item that hasn't been pushed yet even if a later one has.
+    * Space is freed in order as well, an item popped out of order is freed once the items before it are popped.
+    * The state of each item is kept in an array of atomics beside the buffer, one slot per 16 bytes of buffer, so a
+    * consumer looking at a position another thread has already moved past never reads memory being written as item data.
+    */
+    class MpmcQueue
+    {
+    public:
+        /**
+        * @brief Constructor.
+        * @param size Size of the queue in bytes, rounded up to a power of 2.
+        */
+        MpmcQueue(uint_t size);
+        ~MpmcQueue();
+        MpmcQueue(const MpmcQueue&) = delete;
+        MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+        void reset();                                       ///< Empties the queue, not safe while it's being used.
+
+        /**
+        * @brief Reserves space for an item.
+        * @param size The size of the item in bytes.
+        * @return The item to write into and then pass to push() or cancelNewItem(), nullptr if the queue is full.
+        */
+        void* newItem(uint_t size);
+        void cancelNewItem(void* item);                     ///< Discards an item from newItem(), consumers skip it.
+        void push(void* item);                              ///< Makes an item from newItem() available to consumers.
+
+        /**
+        * @brief Takes the next item for this consumer, other consumers will get the items after it.
+        * @return The item, which must be passed to pop() when finished with. nullptr if there isn't one.
+        */
+        void* peekNextItem();
+        void pop(void* item);                               ///< Frees an item from peekNextItem().
+        uint_t itemCount() const;
+        static uint_t itemSize(const void* item);           ///< The size passed to newItem().
+
+    protected:
+        void* reserve(uint_t size);                         ///< newItem() without logging when full.
+
+    private:
+        /// The state of the item starting at a position in the buffer, only ever read by other threads.
+        struct Slot
+        {
+            std::atomic<uint64_t> state;                    ///< The item's position in the stream with the flags below in the low bits.
+            std::atomic<uint32_t> size;                     ///< Size of the header, item and alignment padding.
+        };
+
+        /// Precedes each item, only read by the thread that reserved or claimed the item.
+        struct Header
+        {
+            uint64_t pos;
+            uint32_t itemSize;
+        };
+
+        static constexpr uint64_t ready = 1;                ///< Pushed and waiting for a consumer.
+        static constexpr uint64_t skip = 2;                 ///< Cancelled or unused space at the end of the buffer.
+        static constexpr uint64_t consumed = 4;             ///< Can be reused once everything before it is.
+        static constexpr uint64_t flagMask = 7;
+        static constexpr uint_t alignment = 16;
+        static constexpr uint_t headerSize = alignment;     ///< Space at the end of the buffer is always big enough for a header.
+        static_assert(sizeof(Header) <= headerSize, "Header must fit in the alignment");
+
+        uint_t m_bufSize;
+        uint8_t* m_buf;
+        Slot* m_slots;
+        alignas(64) std::atomic<uint64_t> m_write;          ///< Position the next item is reserved at.
+        alignas(64) std::atomic<uint64_t> m_read;           ///< Position of the next item for a consumer.
+        alignas(64) std::atomic<uint64_t> m_free;           ///< Everything before this has been popped and can be reused.
+        alignas(64) std::atomic<uint_t> m_itemsPushed;
+        std::atomic<uint_t> m_itemsPopped;
+
+        Header* header(uint64_t pos) const { return reinterpret_cast<Header*>(&m_buf[pos & (m_bufSize - 1)]); }
+        Slot& slot(uint64_t pos) const { return m_slots[(pos & (m_bufSize - 1)) / alignment]; }
+        void release(uint64_t pos);
+    };
+
+    /**
+    * @brief An MpmcQueue that producers and consumers can wait on.
+    * Pushing and popping only signal when another thread is waiting, so threads that don't wait never make a system call.
+    */
+    class BlockingMpmcQueue : public MpmcQueue
+    {
+    public:
+        using MpmcQueue::newItem;
+        using MpmcQueue::peekNextItem;
+
+        BlockingMpmcQueue(uint_t size);
+
+        /**
+        * @brief Reserves space for an item, waiting for consumers to free some if the queue is full.
+        * @param size The size of the item in bytes.
+        * @param timeoutMs How long to wait for space.
+        * @return The item, nullptr if there was no space before the timeout.
+        */
+        void* newItem(uint_t size, uint_t timeoutMs);
+        void push(void* item);
+
+        /**
+        * @brief Takes the next item, waiting for one to be pushed if the queue is empty.
+        * @param timeoutMs How long to wait for an item.
+        * @return The item, nullptr if there wasn't one before the timeout.
+        */
+        void* peekNextItem(uint_t timeoutMs);
+        void pop(void* item);
+        void cancelNewItem(void* item);
+
+    private:
+        std::mutex m_mutex;
+        std::condition_variable m_itemPushed;
+        std::condition_variable m_itemPopped;
+        std::atomic<uint_t> m_consumersWaiting;
+        std::atomic<uint_t> m_producersWaiting;
+    };
+}
+//--------------------------------------------------------------------------------------------------
+#endif
@@ -44,6 +44,16 @@ uint_t Queue::itemCount()
 }
 //--------------------------------------------------------------------------------------------------
 void* Queue::newItem(uint_t size)
+{
+    return reserve(size, true);
+}
+//--------------------------------------------------------------------------------------------------
+void* Queue::tryNewItem(uint_t size)
+{
+    return reserve(size, false);        // For callers that expect the queue to fill and handle it themselves
+}
+//--------------------------------------------------------------------------------------------------
+void* Queue::reserve(uint_t size, bool_t logFull)
 {
     uint8_t* mem = nullptr;
     
@@ -83,7 +93,7 @@ void* Queue::newItem(uint_t size)
             *((uint_t*)mem) = size;
             mem += sizeof(uint_t);
         }
-        else
+        else if (logFull)
         {
             debugLog("Queue", "out of memory: freeMem: %u, requested %u", freeMem, size);
         }
@@ -17,6 +17,7 @@ namespace IslSdk
         ~Queue();
         void reset();
         void* newItem(uint_t size);
+        void* tryNewItem(uint_t size);
         void cancelNewItem();
         bool_t reduceSize(uint_t newSize);
         void push();
@@ -26,6 +27,8 @@ namespace IslSdk
         uint_t itemCount();
 
     private:
+        void* reserve(uint_t size, bool_t logFull);
+
         uint_t m_bufSize;
         uint8_t* m_buf;
         std::atomic<uint8_t*> m_head;
@@ -1,69 +1,204 @@
 //------------------------------------------ Includes ----------------------------------------------
 
 #include "utils/crc.h"
+#include "platform/cpu.h"
+
+#if defined(CPU_X86)
+#define CRC_CLMUL
+#endif
 
 using namespace IslSdk;
 
+/// Slicing-by-8 tables for a reflected crc. Table k gives the crc of a byte followed by k zero bytes.
+template<typename T> struct CrcTables
+{
+    T table[8][256];
+
+    constexpr CrcTables(T poly) : table()
+    {
+        for (uint_t i = 0; i < 256; i++)
+        {
+            T crc = static_cast<T>(i);
+            for (uint_t bit = 0; bit < 8; bit++)
+            {
+                crc = (crc & 1) ? static_cast<T>((crc >> 1) ^ poly) : static_cast<T>(crc >> 1);
+            }
+            table[0][i] = crc;
+        }
+
+        for (uint_t k = 1; k < 8; k++)
+        {
+            for (uint_t i = 0; i < 256; i++)
+            {
+                table[k][i] = static_cast<T>((table[k - 1][i] >> 8) ^ table[0][table[k - 1][i] & 0xff]);
+            }
+        }
+    }
+};
+
+static constexpr CrcTables<uint32_t> crc32Tables(0xEDB88320);
+static constexpr CrcTables<uint16_t> crc16Tables(0xA001);
+
+//--------------------------------------------------------------------------------------------------
+static inline uint32_t load32(const uint8_t* data)
+{
+    return static_cast<uint32_t>(data[0]) | (static_cast<uint32_t>(data[1]) << 8) | (static_cast<uint32_t>(data[2]) << 16) | (static_cast<uint32_t>(data[3]) << 24);
+}
+//--------------------------------------------------------------------------------------------------
+template<typename T> static T crcSlice8(const CrcTables<T>& t, T crc, const uint8_t* data, uint_t length)
+{
+    while (length >= 8)
+    {
+        uint32_t lo = load32(data) ^ crc;
+        uint32_t hi = load32(data + 4);
+
+        crc = t.table[7][lo & 0xff] ^ t.table[6][(lo >> 8) & 0xff] ^ t.table[5][(lo >> 16) & 0xff] ^ t.table[4][lo >> 24] ^
+              t.table[3][hi & 0xff] ^ t.table[2][(hi >> 8) & 0xff] ^ t.table[1][(hi >> 16) & 0xff] ^ t.table[0][hi >> 24];
+        data += 8;
+        length -= 8;
+    }
+
+    while (length--)
+    {
+        crc = static_cast<T>(t.table[0][(crc ^ *data++) & 0xff] ^ (crc >> 8));
+    }
+
+    return crc;
+}
+
+#ifdef CRC_CLMUL
+//--------------------------------------------------------------------------------------------------
+/// x^power mod poly, bit reflected into the top of a 64 bit lane to match the reflected data.
+static constexpr uint64_t foldConstant(uint_t power, uint32_t poly, uint_t width)
+{
+    uint64_t top = static_cast<uint64_t>(1) << width;
+    uint64_t r = 1;
+
+    for (uint_t i = 0; i < power; i++)
+    {
+        r <<= 1;
+        if (r & top)
+        {
+            r ^= top | poly;
+        }
+    }
+
+    uint64_t reflected = 0;
+    for (uint_t i = 0; i < width; i++)
+    {
+        if (r & (static_cast<uint64_t>(1) << i))
+        {
+            reflected |= static_cast<uint64_t>(1) << (63 - i);
+        }
+    }
+    return reflected;
+}
+
+struct FoldConstants
+{
+    uint64_t by4[2];
+    uint64_t by1[2];
+
+    // Each lane is carried forward 512 bits by the 4 way fold and 128 bits by the single fold.
+    // The product of two reflected lanes is one bit short, hence the powers are one less.
+    constexpr FoldConstants(uint32_t poly, uint_t width) :
+        by4{ foldConstant(512 + 64 - 1, poly, width), foldConstant(512 - 1, poly, width) },
+        by1{ foldConstant(128 + 64 - 1, poly, width), foldConstant(128 - 1, poly, width) }
+    {
+    }
+};
+
+static constexpr FoldConstants crc32Fold(0x04C11DB7, 32);
+static constexpr FoldConstants crc16Fold(0x8005, 16);
+
+static const bool_t hasClmul = Cpu::hasPclmul();
+
+//--------------------------------------------------------------------------------------------------
+CPU_TARGET("pclmul") static inline __m128i fold(__m128i acc, __m128i data, __m128i k)
+{
+    __m128i lo = _mm_clmulepi64_si128(acc, k, 0x00);
+    __m128i hi = _mm_clmulepi64_si128(acc, k, 0x11);
+    return _mm_xor_si128(_mm_xor_si128(lo, hi), data);
+}
+//--------------------------------------------------------------------------------------------------
+/// Folds a multiple of 16 bytes, at least 64, down to 16 bytes that have the same crc from a zero seed.
+CPU_TARGET("pclmul") static void crcFold(const FoldConstants& k, uint32_t seed, const uint8_t* data, uint_t length, uint8_t* out)
+{
+    const __m128i* ptr = reinterpret_cast<const __m128i*>(data);
+    __m128i x0 = _mm_xor_si128(_mm_loadu_si128(ptr), _mm_cvtsi32_si128(static_cast<int>(seed)));
+    __m128i x1 = _mm_loadu_si128(ptr + 1);
+    __m128i x2 = _mm_loadu_si128(ptr + 2);
+    __m128i x3 = _mm_loadu_si128(ptr + 3);
+    __m128i k4 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(k.by4));
+    __m128i k1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(k.by1));
+
+    ptr += 4;
+    length -= 64;
+
+    while (length >= 64)
+    {
+        x0 = fold(x0, _mm_loadu_si128(ptr), k4);
+        x1 = fold(x1, _mm_loadu_si128(ptr + 1), k4);
+        x2 = fold(x2, _mm_loadu_si128(ptr + 2), k4);
+        x3 = fold(x3, _mm_loadu_si128(ptr + 3), k4);
+        ptr += 4;
+        length -= 64;
+    }
+
+    x0 = fold(x0, x1, k1);
+    x0 = fold(x0, x2, k1);
+    x0 = fold(x0, x3, k1);
+
+    while (length >= 16)
+    {
+        x0 = fold(x0, _mm_loadu_si128(ptr++), k1);
+        length -= 16;
+    }
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), x0);
+}
+#endif
+
 //--------------------------------------------------------------------------------------------------
 uint32_t IslSdk::crc32(uint32_t seed, const void* data, uint_t length)
 {
-    constexpr uint32_t lut[] = {
-        0x00000000,0x1DB71064,0x3B6E20C8,0x26D930AC,0x76DC4190,0x6B6B51F4,0x4DB26158,0x5005713C,
-        0xEDB88320,0xF00F9344,0xD6D6A3E8,0xCB61B38C,0x9B64C2B0,0x86D3D2D4,0xA00AE278,0xBDBDF21C };
+    const uint8_t* dataPtr = static_cast<const uint8_t*>(data);
     uint32_t crc = seed;
-    uint8_t* dataPtr = (uint8_t*)data;
 
-    for (uint_t i = 0; i < length; i++)
+#ifdef CRC_CLMUL
+    if (hasClmul && length >= 64)
     {
-        crc = lut[(crc ^ dataPtr[i]) & 0x0f] ^ (crc >> 4);
-        crc = lut[(crc ^ (dataPtr[i] >> 4)) & 0x0f] ^ (crc >> 4);
+        uint8_t folded[16];
+        uint_t foldLength = length & ~static_cast<uint_t>(15);
+
+        crcFold(crc32Fold, crc, dataPtr, foldLength, &folded[0]);
+        crc = crcSlice8<uint32_t>(crc32Tables, 0, &folded[0], sizeof(folded));
+        dataPtr += foldLength;
+        length -= foldLength;
     }
+#endif
 
-    return crc;
+    return crcSlice8<uint32_t>(crc32Tables, crc, dataPtr, length);
 }
 //--------------------------------------------------------------------------------------------------
 uint16_t IslSdk::crc16(uint16_t seed, const void* data, uint_t length)
 {
-    constexpr uint16_t crcTable[] = {// CRC lookup table polynomial 0xA001
-    0x0000, 0xC0C1, 0xC181, 0x0140, 0xC301, 0x03C0, 0x0280, 0xC241,
-    0xC601, 0x06C0, 0x0780, 0xC741, 0x0500, 0xC5C1, 0xC481, 0x0440,
-    0xCC01, 0x0CC0, 0x0D80, 0xCD41, 0x0F00, 0xCFC1, 0xCE81, 0x0E40,
-    0x0A00, 0xCAC1, 0xCB81, 0x0B40, 0xC901, 0x09C0, 0x0880, 0xC841,
-    0xD801, 0x18C0, 0x1980, 0xD941, 0x1B00, 0xDBC1, 0xDA81, 0x1A40,
-    0x1E00, 0xDEC1, 0xDF81, 0x1F40, 0xDD01, 0x1DC0, 0x1C80, 0xDC41,
-    0x1400, 0xD4C1, 0xD581, 0x1540, 0xD701, 0x17C0, 0x1680, 0xD641,
-    0xD201, 0x12C0, 0x1380, 0xD341, 0x1100, 0xD1C1, 0xD081, 0x1040,
-    0xF001, 0x30C0, 0x3180, 0xF141, 0x3300, 0xF3C1, 0xF281, 0x3240,
-    0x3600, 0xF6C1, 0xF781, 0x3740, 0xF501, 0x35C0, 0x3480, 0xF441,
-    0x3C00, 0xFCC1, 0xFD81, 0x3D40, 0xFF01, 0x3FC0, 0x3E80, 0xFE41,
-    0xFA01, 0x3AC0, 0x3B80, 0xFB41, 0x3900, 0xF9C1, 0xF881, 0x3840,
-    0x2800, 0xE8C1, 0xE981, 0x2940, 0xEB01, 0x2BC0, 0x2A80, 0xEA41,
-    0xEE01, 0x2EC0, 0x2F80, 0xEF41, 0x2D00, 0xEDC1, 0xEC81, 0x2C40,
-    0xE401, 0x24C0, 0x2580, 0xE541, 0x2700, 0xE7C1, 0xE681, 0x2640,
-    0x2200, 0xE2C1, 0xE381, 0x2340, 0xE101, 0x21C0, 0x2080, 0xE041,
-    0xA001, 0x60C0, 0x6180, 0xA141, 0x6300, 0xA3C1, 0xA281, 0x6240,
-    0x6600, 0xA6C1, 0xA781, 0x6740, 0xA501, 0x65C0, 0x6480, 0xA441,
-    0x6C00, 0xACC1, 0xAD81, 0x6D40, 0xAF01, 0x6FC0, 0x6E80, 0xAE41,
-    0xAA01, 0x6AC0, 0x6B80, 0xAB41, 0x6900, 0xA9C1, 0xA881, 0x6840,
-    0x7800, 0xB8C1, 0xB981, 0x7940, 0xBB01, 0x7BC0, 0x7A80, 0xBA41,
-    0xBE01, 0x7EC0, 0x7F80, 0xBF41, 0x7D00, 0xBDC1, 0xBC81, 0x7C40,
-    0xB401, 0x74C0, 0x7580, 0xB541, 0x7700, 0xB7C1, 0xB681, 0x7640,
-    0x7200, 0xB2C1, 0xB381, 0x7340, 0xB101, 0x71C0, 0x7080, 0xB041,
-    0x5000, 0x90C1, 0x9181, 0x5140, 0x9301, 0x53C0, 0x5280, 0x9241,
-    0x9601, 0x56C0, 0x5780, 0x9741, 0x5500, 0x95C1, 0x9481, 0x5440,
-    0x9C01, 0x5CC0, 0x5D80, 0x9D41, 0x5F00, 0x9FC1, 0x9E81, 0x5E40,
-    0x5A00, 0x9AC1, 0x9B81, 0x5B40, 0x9901, 0x59C0, 0x5880, 0x9841,
-    0x8801, 0x48C0, 0x4980, 0x8941, 0x4B00, 0x8BC1, 0x8A81, 0x4A40,
-    0x4E00, 0x8EC1, 0x8F81, 0x4F40, 0x8D01, 0x4DC0, 0x4C80, 0x8C41,
-    0x4400, 0x84C1, 0x8581, 0x4540, 0x8701, 0x47C0, 0x4680, 0x8641,
-    0x8201, 0x42C0, 0x4380, 0x8341, 0x4100, 0x81C1, 0x8081, 0x4040 };
+    const uint8_t* dataPtr = static_cast<const uint8_t*>(data);
     uint16_t crc = seed;
-    uint8_t* dataPtr = (uint8_t*)data;
 
-    for (uint_t i = 0; i < length; i++)
+#ifdef CRC_CLMUL
+    if (hasClmul && length >= 64)
     {
-        crc = crcTable[(crc ^ *dataPtr++) & 0xff] ^ (crc >> 8);
+        uint8_t folded[16];
+        uint_t foldLength = length & ~static_cast<uint_t>(15);
+
+        crcFold(crc16Fold, crc, dataPtr, foldLength, &folded[0]);
+        crc = crcSlice8<uint16_t>(crc16Tables, 0, &folded[0], sizeof(folded));
+        dataPtr += foldLength;
+        length -= foldLength;
     }
-    return crc;
+#endif
+
+    return crcSlice8<uint16_t>(crc16Tables, crc, dataPtr, length);
 }
 //--------------------------------------------------------------------------------------------------
@@ -0,0 +1,278 @@
+//------------------------------------------ Includes ----------------------------------------------
+
+#include "lz4.h"
+#include "platform/mem.h"
+#include "maths/maths.h"
+
+using namespace IslSdk;
+
+static const uint_t minMatch = 4;
+static const uint_t lastLiterals = 5;               // The block must end with at least this many literals
+static const uint_t matchFindLimit = 12;            // and the last match must start at least this far from the end
+static const uint_t maxOffset = 65535;
+static const uint_t hashBits = 12;
+
+//--------------------------------------------------------------------------------------------------
+static inline uint32_t read32(const uint8_t* data)
+{
+    uint32_t value;
+    Mem::memcpy(&value, data, sizeof(value));
+    return value;
+}
+//--------------------------------------------------------------------------------------------------
+static inline uint64_t read64(const uint8_t* data)
+{
+    uint64_t value;
+    Mem::memcpy(&value, data, sizeof(value));
+    return value;
+}
+//--------------------------------------------------------------------------------------------------
+/// Copies in fixed 8 byte steps, so may write up to 7 bytes past dst + size. Overlapping is fine if src is at least 8 bytes behind dst.
+static inline void wildCopy(uint8_t* dst, const uint8_t* src, uint_t size)
+{
+    for (uint_t i = 0; i < size; i += 8)
+    {
+        Mem::memcpy(dst + i, src + i, 8);
+    }
+}
+//--------------------------------------------------------------------------------------------------
+static inline uint_t hash(uint32_t sequence)
+{
+    return (sequence * 2654435761u) >> (32 - hashBits);
+}
+//--------------------------------------------------------------------------------------------------
+static inline uint8_t* putLength(uint8_t* dst, uint_t length)
+{
+    while (length >= 255)
+    {
+        *dst++ = 255;
+        length -= 255;
+    }
+    *dst++ = static_cast<uint8_t>(length);
+    return dst;
+}
+//--------------------------------------------------------------------------------------------------
+static inline bool_t getLength(const uint8_t** src, const uint8_t* end, uint_t* length)
+{
+    uint8_t byte;
+
+    do
+    {
+        if (*src >= end)
+        {
+            return false;
+        }
+        byte = *(*src)++;
+        *length += byte;
+    } while (byte == 255);
+
+    return true;
+}
+//--------------------------------------------------------------------------------------------------
+uint_t Lz4::compressBound(uint_t size)
+{
+    return size + size / 255 + 16;
+}
+//--------------------------------------------------------------------------------------------------
+uint_t Lz4::compress(const uint8_t* src, uint_t size, uint8_t* dst, uint_t dstSize)
+{
+    if (dstSize < compressBound(size))
+    {
+        return 0;
+    }
+
+    const uint8_t* ip = src;
+    const uint8_t* anchor = src;                    // Start of the literals not yet written
+    const uint8_t* end = src + size;
+    uint8_t* op = dst;
+
+    if (size > matchFindLimit)
+    {
+        const uint8_t* matchLimit = end - lastLiterals;
+        const uint8_t* lastMatchStart = end - matchFindLimit;
+        uint32_t table[1 << hashBits] = {};         // Offsets from src of the last position with each hash
+        uint_t misses = 0;
+
+        ip++;
+        while (ip <= lastMatchStart)
+        {
+            uint32_t sequence = read32(ip);
+            uint_t h = hash(sequence);
+            const uint8_t* ref = src + table[h];
+            table[h] = static_cast<uint32_t>(ip - src);
+
+            if (ref >= ip || static_cast<uint_t>(ip - ref) > maxOffset || read32(ref) != sequence)
+            {
+                // Incompressible data is skipped through faster and faster
+                ip += 1 + (misses++ >> 6);
+                continue;
+            }
+            misses = 0;
+
+            while (ip > anchor && ref > src && ip[-1] == ref[-1])
+            {
+                ip--;
+                ref--;
+            }
+
+            const uint8_t* matchEnd = ip + minMatch;
+            const uint8_t* refEnd = ref + minMatch;
+            while (matchEnd + 8 <= matchLimit && read64(matchEnd) == read64(refEnd))
+            {
+                matchEnd += 8;
+                refEnd += 8;
+            }
+            while (matchEnd < matchLimit && *matchEnd == *refEnd)
+            {
+                matchEnd++;
+                refEnd++;
+            }
+
+            uint_t literalLength = static_cast<uint_t>(ip - anchor);
+            uint_t matchLength = static_cast<uint_t>(matchEnd - ip) - minMatch;
+            uint_t offset = static_cast<uint_t>(ip - ref);
+            uint8_t* token = op++;
+
+            *token = static_cast<uint8_t>(Math::min<uint_t>(literalLength, 15) << 4);
+            if (literalLength >= 15)
+            {
+                op = putLength(op, literalLength - 15);
+            }
+            Mem::memcpy(op, anchor, literalLength);
+            op += literalLength;
+
+            *op++ = static_cast<uint8_t>(offset);
+            *op++ = static_cast<uint8_t>(offset >> 8);
+
+            *token |= static_cast<uint8_t>(Math::min<uint_t>(matchLength, 15));
+            if (matchLength >= 15)
+            {
+                op = putLength(op, matchLength - 15);
+            }
+
+            ip = matchEnd;
+            anchor = ip;
+
+            if (ip <= lastMatchStart)
+            {
+                table[hash(read32(ip - 2))] = static_cast<uint32_t>(ip - 2 - src);
+            }
+        }
+    }
+
+    uint_t literalLength = static_cast<uint_t>(end - anchor);
+    *op++ = static_cast<uint8_t>(Math::min<uint_t>(literalLength, 15) << 4);
+    if (literalLength >= 15)
+    {
+        op = putLength(op, literalLength - 15);
+    }
+    if (literalLength)
+    {
+        Mem::memcpy(op, anchor, literalLength);
+    }
+    op += literalLength;
+
+    return static_cast<uint_t>(op - dst);
+}
+//--------------------------------------------------------------------------------------------------
+bool_t Lz4::decompress(const uint8_t* src, uint_t size, uint8_t* dst, uint_t dstSize)
+{
+    const uint8_t* ip = src;
+    const uint8_t* end = src + size;
+    uint8_t* op = dst;
+    uint8_t* dstEnd = dst + dstSize;
+
+    while (ip < end)
+    {
+        uint_t token = *ip++;
+        uint_t literalLength = token >> 4;
+
+        if (literalLength == 15 && !getLength(&ip, end, &literalLength))
+        {
+            return false;
+        }
+        if (literalLength > static_cast<uint_t>(end - ip) || literalLength > static_cast<uint_t>(dstEnd - op))
+        {
+            return false;
+        }
+        if (static_cast<uint_t>(end - ip) >= literalLength + 8 && static_cast<uint_t>(dstEnd - op) >= literalLength + 8)
+        {
+            wildCopy(op, ip, literalLength);
+        }
+        else if (literalLength)
+        {
+            Mem::memcpy(op, ip, literalLength);
+        }
+        op += literalLength;
+        ip += literalLength;
+
+        if (ip == end)
+        {
+            break;                                  // The last sequence is only literals
+        }
+
+        if (end - ip < 2)
+        {
+            return false;
+        }
+        uint_t offset = ip[0] | (static_cast<uint_t>(ip[1]) << 8);
+        ip += 2;
+
+        uint_t matchLength = token & 15;
+        if (matchLength == 15 && !getLength(&ip, end, &matchLength))
+        {
+            return false;
+        }
+        matchLength += minMatch;
+
+        if (offset == 0 || offset > static_cast<uint_t>(op - dst) || matchLength > static_cast<uint_t>(dstEnd - op))
+        {
+            return false;
+        }
+
+        const uint8_t* ref = op - offset;
+        if (static_cast<uint_t>(dstEnd - op) >= matchLength + 8)
+        {
+            if (offset < 8)
+            {
+                // Byte by byte until the repeating pattern is a multiple of its period at least 8 bytes behind
+                for (uint_t i = 0; i < 8; i++)
+                {
+                    op[i] = ref[i];
+                }
+                uint_t period = ((8 + offset - 1) / offset) * offset;
+                if (matchLength > 8)
+                {
+                    wildCopy(op + 8, op + 8 - period, matchLength - 8);
+                }
+            }
+            else
+            {
+                wildCopy(op, ref, matchLength);
+            }
+        }
+        else if (offset >= matchLength)
+        {
+            Mem::memcpy(op, ref, matchLength);
+        }
+        else if (offset >= 8)
+        {
+            // Overlapping, but each 8 byte step reads only bytes already written
+            for (uint_t i = 0; i < matchLength; i += 8)
+            {
+                Mem::memcpy(op + i, ref + i, Math::min<uint_t>(8, matchLength - i));
+            }
+        }
+        else
+        {
+            for (uint_t i = 0; i < matchLength; i++)
+            {
+                op[i] = ref[i];
+            }
+        }
+        op += matchLength;
+    }
+
+    return op == dstEnd;
+}
+//--------------------------------------------------------------------------------------------------
@@ -0,0 +1,41 @@
+#ifndef LZ4_H_
+#define LZ4_H_
+
+//------------------------------------------ Includes ----------------------------------------------
+
+#include "types/sdkTypes.h"
+
+//---------------------------------- Public Function Prototypes -----------------------------------
+namespace IslSdk
+{
+    /// The LZ4 block format, compatible with LZ4_compress_default() and LZ4_decompress_safe() from liblz4.
+    namespace Lz4
+    {
+        /**
+        * @brief The most compress() can write for \p size bytes of input.
+        */
+        uint_t compressBound(uint_t size);
+
+        /**
+        * @brief Compresses a block.
+        * @param src The data to compress.
+        * @param size The size of the data.
+        * @param dst Where to write the compressed block.
+        * @param dstSize The size of dst, must be at least compressBound(size).
+        * @return The size of the compressed block, 0 if dst is too small.
+        */
+        uint_t compress(const uint8_t* src, uint_t size, uint8_t* dst, uint_t dstSize);
+
+        /**
+        * @brief Decompresses a block, checking it can't read or write out of bounds.
+        * @param src The compressed block.
+        * @param size The size of the compressed block.
+        * @param dst Where to write the data.
+        * @param dstSize The size of the data, which isn't stored in the block.
+        * @return True if the block was valid and decompressed to exactly dstSize bytes.
+        */
+        bool_t decompress(const uint8_t* src, uint_t size, uint8_t* dst, uint_t dstSize);
+    }
+}
+//--------------------------------------------------------------------------------------------------
+#endif